@@ -107,15 +107,15 @@ static float _bitmask_binary32_binary_op(float a, float b,
 static double _bitmask_binary64_binary_op(double a, double b,
                                           bitmask_operations op, void *context);
 
-static uint32_t binary32_bitmask = FLOAT_MASK_ONE;
-static uint64_t binary64_bitmask = DOUBLE_MASK_ONE;
+/* Returns the bitmask of the configured precision for the type of X */
+#define GET_BITMASK(CTX, X)                                                    \
+  _Generic(X, float: (CTX)->binary32_bitmask, double: (CTX)->binary64_bitmask)
 
-#define GET_BITMASK(X)                                                         \
+/* Returns the number of noised bits for the type of X */
+#define GET_NOISE_SIZE(CTX, X)                                                 \
   _Generic(X,                                                                  \
-      float: binary32_bitmask,                                                 \
-      double: binary64_bitmask,                                                \
-      float *: &binary32_bitmask,                                              \
-      double *: &binary64_bitmask)
+      float: (CTX)->binary32_noise_size,                                       \
+      double: (CTX)->binary64_noise_size)
 
 /******************** BITMASK CONTROL FUNCTIONS *******************
  * The following functions are used to set virtual precision and
@@ -143,30 +143,31 @@ static void _set_bitmask_operator(const bitmask_operator bitmask,
   ctx->operator= bitmask;
 }
 
-#define _set_bitmask_precision(precision, VIRTUAL_PRECISION, Y, X)             \
+/* Precompute the bitmask of VIRTUAL_PRECISION and its number of noised bits
+ * so that operations only apply them */
+#define _set_bitmask_precision(VIRTUAL_PRECISION, BITMASK, NOISE_SIZE, X)      \
   {                                                                            \
-    typeof(Y) *bitmask = GET_BITMASK((typeof(X) *)0);                          \
     const int32_t PREC = GET_PREC(X);                                          \
-    typeof(Y) MASK_ONE = GET_MASK_ONE(X);                                      \
-    *bitmask = ((VIRTUAL_PRECISION) <= PREC)                                   \
-                   ? MASK_ONE << (PREC - (VIRTUAL_PRECISION))                  \
-                   : MASK_ONE;                                                 \
+    const typeof(BITMASK) MASK_ONE = GET_MASK_ONE(X);                          \
+    NOISE_SIZE =                                                               \
+        ((VIRTUAL_PRECISION) <= PREC) ? PREC - (VIRTUAL_PRECISION) : 0;        \
+    BITMASK = MASK_ONE << (NOISE_SIZE);                                        \
   }
 
 static void _set_bitmask_precision_binary32(const int precision,
                                             void *context) {
   bitmask_context_t *ctx = (bitmask_context_t *)context;
   _set_precision(BITMASK, precision, ctx->binary32_precision, (float)0);
-  _set_bitmask_precision(precision, ctx->binary32_precision,
-                         (typeof(binary32_bitmask))0, (float)0);
+  _set_bitmask_precision(ctx->binary32_precision, ctx->binary32_bitmask,
+                         ctx->binary32_noise_size, (float)0);
 }
 
 static void _set_bitmask_precision_binary64(const int precision,
                                             void *context) {
   bitmask_context_t *ctx = (bitmask_context_t *)context;
   _set_precision(BITMASK, precision, ctx->binary64_precision, (double)0);
-  _set_bitmask_precision(precision, ctx->binary64_precision,
-                         (typeof(binary64_bitmask))0, (double)0);
+  _set_bitmask_precision(ctx->binary64_precision, ctx->binary64_bitmask,
+                         ctx->binary64_noise_size, (double)0);
 }
 
 static void _set_bitmask_daz(bool daz, bitmask_context_t *ctx) {
@@ -298,7 +299,7 @@ static uint64_t get_random_binary64_mask() {
     const typeof((B).u) pman_size = GET_PMAN_SIZE((B).type);                   \
     const typeof((B).u) mask_one = GET_MASK_ONE((B).type);                     \
     const int binary_t = GET_BINARYN_T((B).type);                              \
-    typeof((B).u) bitmask = GET_BITMASK((B).type);                             \
+    typeof((B).u) bitmask = GET_BITMASK(TMP_CTX, (B).type);                    \
     _init_rng_state_struct(&rng_state, TMP_CTX->choose_seed,                   \
                            (unsigned long long)(TMP_CTX->seed), false);        \
     if (FPCLASSIFY(*x) == FP_SUBNORMAL) {                                      \
@@ -346,6 +347,116 @@ static void _inexact_binary64(void *context, double *x) {
 #define _INEXACT_BINARYN(CTX, X)                                               \
   _Generic(X, float *: _inexact_binary32, double *: _inexact_binary64)(CTX, X)
 
+/******************** BITMASK VECTOR FUNCTIONS ********************
+ * The following functions apply the precomputed bitmask to all the
+ * lanes of a vector operation. Random masks are taken from a pool of
+ * random bits: each lane only consumes the bits it noises, so that one
+ * 64-bits draw is shared by several lanes.
+ *******************************************************************/
+
+typedef struct {
+  uint64_t bits;
+  int available;
+} bitmask_random_pool_t;
+
+/* Returns <n> random bits (0 < n < 64) taken from <pool> */
+static inline uint64_t _get_random_bits(bitmask_random_pool_t *pool,
+                                        const int n) {
+  uint64_t bits = pool->bits;
+  if (pool->available >= n) {
+    pool->bits >>= n;
+    pool->available -= n;
+    return bits & ((1ULL << n) - 1);
+  }
+  /* take the remaining bits and complete with a new draw */
+  const int missing = n - pool->available;
+  const uint64_t draw = get_random_mask();
+  bits |= (draw & ((1ULL << missing) - 1)) << pool->available;
+  pool->bits = draw >> missing;
+  pool->available = 64 - missing;
+  return bits;
+}
+
+/* Noise the <N> lanes of the array of binary32/binary64 <X>. Zeros, infinities
+ * and NaNs are kept, subnormals fall back to the scalar function. */
+#define _INEXACT_VECTOR(CTX, X, N)                                             \
+  do {                                                                         \
+    bitmask_context_t *TMP_CTX = (bitmask_context_t *)(CTX);                   \
+    const typeof((X)[0].u) bitmask = GET_BITMASK(TMP_CTX, (X)[0].type);        \
+    const typeof((X)[0].u) noise = ~bitmask;                                   \
+    const int noise_size = GET_NOISE_SIZE(TMP_CTX, (X)[0].type);               \
+    const unsigned exp_max = (1U << GET_EXP_SIZE((X)[0].type)) - 1;            \
+    const bool skip_representable = TMP_CTX->mode == bitmask_mode_ob;          \
+    bitmask_random_pool_t pool = {0, 0};                                       \
+    if (noise_size == 0) {                                                     \
+      break;                                                                   \
+    }                                                                          \
+    _init_rng_state_struct(&rng_state, TMP_CTX->choose_seed,                   \
+                           (unsigned long long)(TMP_CTX->seed), false);        \
+    for (int i = 0; i < (N); i++) {                                            \
+      const unsigned exponent = (X)[i].ieee.exponent;                          \
+      if (exponent == 0) {                                                     \
+        if ((X)[i].ieee.mantissa != 0) {                                       \
+          _INEXACT_BINARYN(CTX, &(X)[i].type);                                 \
+        }                                                                      \
+        continue;                                                              \
+      }                                                                        \
+      /* a normal value is representable if its noised bits are zeros */       \
+      if (exponent == exp_max ||                                               \
+          (skip_representable && ((X)[i].u & noise) == 0)) {                   \
+        continue;                                                              \
+      }                                                                        \
+      if (TMP_CTX->operator== bitmask_operator_rand) {                         \
+        (X)[i].u ^= _get_random_bits(&pool, noise_size);                       \
+      } else if (TMP_CTX->operator== bitmask_operator_one) {                   \
+        (X)[i].u |= noise;                                                     \
+      } else {                                                                 \
+        (X)[i].u &= bitmask;                                                   \
+      }                                                                        \
+    }                                                                          \
+  } while (0)
+
+static void _inexact_vector_binary32(void *context, binary32 *x, int n) {
+  _INEXACT_VECTOR(context, x, n);
+}
+
+static void _inexact_vector_binary64(void *context, binary64 *x, int n) {
+  _INEXACT_VECTOR(context, x, n);
+}
+
+#define _INEXACT_VECTOR_BINARYN(CTX, X, N)                                     \
+  _Generic(X,                                                                  \
+      binary32 *: _inexact_vector_binary32,                                    \
+      binary64 *: _inexact_vector_binary64)(CTX, X, N)
+
+/* applies the binary operator (op) to the <N> lanes of (a) and (b) */
+/* and stores the result in (res) */
+#define PERFORM_VECTOR_BIN_OP(OP, RES, A, B, N)                                \
+  switch (OP) {                                                                \
+  case bitmask_add:                                                            \
+    for (int i = 0; i < (N); i++) {                                            \
+      (RES)[i].type = (A)[i].type + (B)[i].type;                               \
+    }                                                                          \
+    break;                                                                     \
+  case bitmask_mul:                                                            \
+    for (int i = 0; i < (N); i++) {                                            \
+      (RES)[i].type = (A)[i].type * (B)[i].type;                               \
+    }                                                                          \
+    break;                                                                     \
+  case bitmask_sub:                                                            \
+    for (int i = 0; i < (N); i++) {                                            \
+      (RES)[i].type = (A)[i].type - (B)[i].type;                               \
+    }                                                                          \
+    break;                                                                     \
+  case bitmask_div:                                                            \
+    for (int i = 0; i < (N); i++) {                                            \
+      (RES)[i].type = (A)[i].type / (B)[i].type;                               \
+    }                                                                          \
+    break;                                                                     \
+  default:                                                                     \
+    logger_error("invalid operator %c", OP);                                   \
+  };
+
 #define _BITMASK_UNARY_OP(A, OP, CTX)                                          \
   {                                                                            \
     bitmask_context_t *TMP_CTX = (bitmask_context_t *)(CTX);                   \
@@ -452,6 +563,58 @@ static double _bitmask_binary64_ternary_op(double a, double b, double c,
   _BITMASK_TERNARY_OP(a, b, c, op, context);
 }
 
+/* Applies (op) to the <SIZE> lanes of (A) and (B), by chunks of at most
+ * BITMASK_VECTOR_SIZE_MAX lanes stored in arrays of T (binary32, binary64) */
+#define _BITMASK_VECTOR_OP(SIZE, A, B, C, OP, CTX, T)                          \
+  {                                                                            \
+    bitmask_context_t *TMP_CTX = (bitmask_context_t *)(CTX);                   \
+    T VA[BITMASK_VECTOR_SIZE_MAX];                                             \
+    T VB[BITMASK_VECTOR_SIZE_MAX];                                             \
+    T VC[BITMASK_VECTOR_SIZE_MAX];                                             \
+    for (int offset = 0; offset < (SIZE); offset += BITMASK_VECTOR_SIZE_MAX) { \
+      const int n = ((SIZE)-offset < BITMASK_VECTOR_SIZE_MAX)                  \
+                        ? (SIZE)-offset                                        \
+                        : BITMASK_VECTOR_SIZE_MAX;                             \
+      for (int i = 0; i < n; i++) {                                            \
+        VA[i].type = (A)[offset + i];                                          \
+        VB[i].type = (B)[offset + i];                                          \
+      }                                                                        \
+      if (TMP_CTX->daz) {                                                      \
+        for (int i = 0; i < n; i++) {                                          \
+          VA[i].type = DAZ(VA[i].type);                                        \
+          VB[i].type = DAZ(VB[i].type);                                        \
+        }                                                                      \
+      }                                                                        \
+      if (TMP_CTX->mode == bitmask_mode_ib ||                                  \
+          TMP_CTX->mode == bitmask_mode_full) {                                \
+        _INEXACT_VECTOR_BINARYN(CTX, VA, n);                                   \
+        _INEXACT_VECTOR_BINARYN(CTX, VB, n);                                   \
+      }                                                                        \
+      PERFORM_VECTOR_BIN_OP(OP, VC, VA, VB, n);                                \
+      if (TMP_CTX->mode == bitmask_mode_ob ||                                  \
+          TMP_CTX->mode == bitmask_mode_full) {                                \
+        _INEXACT_VECTOR_BINARYN(CTX, VC, n);                                   \
+      }                                                                        \
+      for (int i = 0; i < n; i++) {                                            \
+        (C)[offset + i] = (TMP_CTX->ftz) ? (FTZ(VC[i].type)) : VC[i].type;     \
+      }                                                                        \
+    }                                                                          \
+  }
+
+static void _bitmask_binary32_vector_op(const int size, const float *a,
+                                        const float *b, float *c,
+                                        const bitmask_operations op,
+                                        void *context) {
+  _BITMASK_VECTOR_OP(size, a, b, c, op, context, binary32);
+}
+
+static void _bitmask_binary64_vector_op(const int size, const double *a,
+                                        const double *b, double *c,
+                                        const bitmask_operations op,
+                                        void *context) {
+  _BITMASK_VECTOR_OP(size, a, b, c, op, context, binary64);
+}
+
 /******************** BITMASK COMPARE FUNCTIONS ********************
  * Compare operations do not require BITMASK
  ****************************************************************/
@@ -517,6 +680,54 @@ void INTERFLOP_BITMASK_API(cast_double_to_float)(double a, float *res,
   *res = (float)_bitmask_binary64_unary_op(a, bitmask_cast, context);
 }
 
+void INTERFLOP_BITMASK_API(add_float_vector)(const int size, const float *a,
+                                             const float *b, float *c,
+                                             void *context) {
+  _bitmask_binary32_vector_op(size, a, b, c, bitmask_add, context);
+}
+
+void INTERFLOP_BITMASK_API(sub_float_vector)(const int size, const float *a,
+                                             const float *b, float *c,
+                                             void *context) {
+  _bitmask_binary32_vector_op(size, a, b, c, bitmask_sub, context);
+}
+
+void INTERFLOP_BITMASK_API(mul_float_vector)(const int size, const float *a,
+                                             const float *b, float *c,
+                                             void *context) {
+  _bitmask_binary32_vector_op(size, a, b, c, bitmask_mul, context);
+}
+
+void INTERFLOP_BITMASK_API(div_float_vector)(const int size, const float *a,
+                                             const float *b, float *c,
+                                             void *context) {
+  _bitmask_binary32_vector_op(size, a, b, c, bitmask_div, context);
+}
+
+void INTERFLOP_BITMASK_API(add_double_vector)(const int size, const double *a,
+                                              const double *b, double *c,
+                                              void *context) {
+  _bitmask_binary64_vector_op(size, a, b, c, bitmask_add, context);
+}
+
+void INTERFLOP_BITMASK_API(sub_double_vector)(const int size, const double *a,
+                                              const double *b, double *c,
+                                              void *context) {
+  _bitmask_binary64_vector_op(size, a, b, c, bitmask_sub, context);
+}
+
+void INTERFLOP_BITMASK_API(mul_double_vector)(const int size, const double *a,
+                                              const double *b, double *c,
+                                              void *context) {
+  _bitmask_binary64_vector_op(size, a, b, c, bitmask_mul, context);
+}
+
+void INTERFLOP_BITMASK_API(div_double_vector)(const int size, const double *a,
+                                              const double *b, double *c,
+                                              void *context) {
+  _bitmask_binary64_vector_op(size, a, b, c, bitmask_div, context);
+}
+
 const char *INTERFLOP_BITMASK_API(get_backend_name)(void) {
   return backend_name;
 }
@@ -525,6 +736,10 @@ const char *INTERFLOP_BITMASK_API(get_backend_version)(void) {
   return backend_version;
 }
 
+int INTERFLOP_BITMASK_API(get_interface_version)(void) {
+  return INTERFLOP_INTERFACE_VERSION;
+}
+
 static const struct argp_option options[] = {
     {key_prec_b32_str, KEY_PREC_B32, "PRECISION", 0,
      "select precision for binary32 (PRECISION > 0)", 0},
@@ -663,6 +878,11 @@ static void _bitmask_init_context(bitmask_context_t *ctx) {
   ctx->seed = BITMASK_SEED_DEFAULT;
   ctx->daz = BITMASK_DAZ_DEFAULT;
   ctx->ftz = BITMASK_FTZ_DEFAULT;
+  /* no noise until a precision is set */
+  ctx->binary32_bitmask = FLOAT_MASK_ONE;
+  ctx->binary64_bitmask = DOUBLE_MASK_ONE;
+  ctx->binary32_noise_size = 0;
+  ctx->binary64_noise_size = 0;
 }
 
 void INTERFLOP_BITMASK_API(pre_init)(interflop_panic_t panic, File *stream,
@@ -749,7 +969,16 @@ INTERFLOP_BITMASK_API(init)(void *context) {
       .interflop_enter_function = NULL,
       .interflop_exit_function = NULL,
       .interflop_user_call = NULL,
-      .interflop_finalize = NULL};
+      .interflop_finalize = NULL,
+      .interflop_add_float_vector = INTERFLOP_BITMASK_API(add_float_vector),
+      .interflop_sub_float_vector = INTERFLOP_BITMASK_API(sub_float_vector),
+      .interflop_mul_float_vector = INTERFLOP_BITMASK_API(mul_float_vector),
+      .interflop_div_float_vector = INTERFLOP_BITMASK_API(div_float_vector),
+      .interflop_add_double_vector = INTERFLOP_BITMASK_API(add_double_vector),
+      .interflop_sub_double_vector = INTERFLOP_BITMASK_API(sub_double_vector),
+      .interflop_mul_double_vector = INTERFLOP_BITMASK_API(mul_double_vector),
+      .interflop_div_double_vector =
+          INTERFLOP_BITMASK_API(div_double_vector)};
 
   /* The seed for the RNG is initialized upon the first request for a random
   number */
@@ -768,3 +997,6 @@ void interflop_pre_init(interflop_panic_t panic, File *stream, void **context)
 
 void interflop_cli(int argc, char **argv, void *context)
     __attribute__((weak, alias("interflop_bitmask_cli")));
+
+int interflop_get_interface_version(void)
+    __attribute__((weak, alias("interflop_bitmask_get_interface_version")));
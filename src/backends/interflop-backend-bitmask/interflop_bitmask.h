@@ -30,6 +30,9 @@
 #define BITMASK_DAZ_DEFAULT IFalse
 #define BITMASK_FTZ_DEFAULT IFalse
 
+/* maximal number of lanes processed at once by the vector operations */
+#define BITMASK_VECTOR_SIZE_MAX 16
+
 /* define the available BITMASK modes of operation */
 typedef enum {
   bitmask_mode_ieee,
@@ -57,6 +60,12 @@ typedef struct {
   IBool choose_seed;
   IBool daz;
   IBool ftz;
+  /* bitmasks of the configured precisions and their number of noised bits,
+   * precomputed when the precisions are set */
+  IUint32_t binary32_bitmask;
+  IUint64_t binary64_bitmask;
+  int binary32_noise_size;
+  int binary64_noise_size;
 } bitmask_context_t;
 
 typedef bitmask_context_t bitmask_conf_t;
@@ -66,6 +75,7 @@ void bitmask_pop_seed(void);
 
 const char *INTERFLOP_BITMASK_API(get_backend_name)(void);
 const char *INTERFLOP_BITMASK_API(get_backend_version)(void);
+int INTERFLOP_BITMASK_API(get_interface_version)(void);
 
 void INTERFLOP_BITMASK_API(add_float)(float a, float b, float *res,
                                       void *context);
@@ -89,6 +99,30 @@ void INTERFLOP_BITMASK_API(fma_double)(double a, double b, double c,
                                        double *res, void *context);
 void INTERFLOP_BITMASK_API(cast_double_to_float)(double a, float *res,
                                                  void *context);
+void INTERFLOP_BITMASK_API(add_float_vector)(const int size, const float *a,
+                                             const float *b, float *c,
+                                             void *context);
+void INTERFLOP_BITMASK_API(sub_float_vector)(const int size, const float *a,
+                                             const float *b, float *c,
+                                             void *context);
+void INTERFLOP_BITMASK_API(mul_float_vector)(const int size, const float *a,
+                                             const float *b, float *c,
+                                             void *context);
+void INTERFLOP_BITMASK_API(div_float_vector)(const int size, const float *a,
+                                             const float *b, float *c,
+                                             void *context);
+void INTERFLOP_BITMASK_API(add_double_vector)(const int size, const double *a,
+                                              const double *b, double *c,
+                                              void *context);
+void INTERFLOP_BITMASK_API(sub_double_vector)(const int size, const double *a,
+                                              const double *b, double *c,
+                                              void *context);
+void INTERFLOP_BITMASK_API(mul_double_vector)(const int size, const double *a,
+                                              const double *b, double *c,
+                                              void *context);
+void INTERFLOP_BITMASK_API(div_double_vector)(const int size, const double *a,
+                                              const double *b, double *c,
+                                              void *context);
 void INTERFLOP_BITMASK_API(pre_init)(interflop_panic_t panic, File *stream,
                                      void **context);
 void INTERFLOP_BITMASK_API(cli)(int argc, char **argv, void *context);
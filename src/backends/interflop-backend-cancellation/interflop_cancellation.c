@@ -24,6 +24,10 @@
 // threads are now supported.
 // Generation of hook functions is now done through macros, shared accross
 // backends.
+//
+// 2026-10-19 Added vector operations. Warnings are counted per call site and
+// reported at exit instead of being printed for every cancellation.
+// Added the per-call-site profile of the cancellations (--profile-file).
 
 #include <argp.h>
 #include <err.h>
@@ -35,6 +39,7 @@
 #include <sys/time.h>
 #include <unistd.h>
 
+#include "interflop/common/float_const.h"
 #include "interflop/common/float_struct.h"
 #include "interflop/common/float_utils.h"
 #include "interflop/fma/interflop_fma.h"
@@ -59,12 +64,14 @@ static const char backend_version[] = "1.x-dev";
 typedef enum {
   KEY_TOLERANCE = 't',
   KEY_WARNING = 'w',
-  KEY_SEED = 's'
+  KEY_SEED = 's',
+  KEY_PROFILE_FILE = 'p'
 } key_args;
 
 static const char key_tolerance_str[] = "tolerance";
 static const char key_warning_str[] = "warning";
 static const char key_seed_str[] = "seed";
+static const char key_profile_file_str[] = "profile-file";
 
 static void _set_cancellation_tolerance(int tolerance, void *context) {
   cancellation_context_t *ctx = (cancellation_context_t *)context;
@@ -89,6 +96,10 @@ const char *INTERFLOP_CANCELLATION_API(get_backend_version)(void) {
   return backend_version;
 }
 
+int INTERFLOP_CANCELLATION_API(get_interface_version)(void) {
+  return INTERFLOP_INTERFACE_VERSION;
+}
+
 /* global thread identifier */
 static pid_t global_tid = 0;
 
@@ -116,9 +127,25 @@ static inline double _noise_binary64(const int exp, rng_state_t *rng_state) {
   return b64.f64;
 }
 
+/* Returns the MCA noise of the magnitude of the bits cancelled in a result
+ * of exponent <e_z>. This particular version in the case of cancellations
+ * does not use extended quad types. With --warning or --profile-file, the
+ * cancellation is recorded for the current call site. */
+static inline double _cancellation_noise(cancellation_context_t *ctx,
+                                         const int cancellation,
+                                         const int32_t e_z,
+                                         rng_state_t *rng_state) {
+  if (ctx->warning || ctx->profile_file != Null) {
+    _cancellation_sites_record(&ctx->sites, cancellation);
+  }
+  const int32_t e_n = e_z - (cancellation - 1);
+  _init_rng_state_struct(rng_state, ctx->choose_seed, ctx->seed, false);
+  return _noise_binary64(e_n, rng_state);
+}
+
 /* cancell: detects the cancellation size; and checks if its larger than the
- * chosen tolerance. It reports a warning to the user and adds a MCA noise of
- * the magnitude of the cancelled bits. */
+ * chosen tolerance. It adds a MCA noise of the magnitude of the cancelled
+ * bits. */
 #define cancell(X, Y, Z, CTX, RNG_STATE)                                       \
   {                                                                            \
     cancellation_context_t *TMP_CTX = (cancellation_context_t *)(CTX);         \
@@ -127,16 +154,58 @@ static inline double _noise_binary64(const int exp, rng_state_t *rng_state) {
      * exponent of the result to find the size of the cancellation */          \
     int cancellation = max(GET_EXP_FLT(X), GET_EXP_FLT(Y)) - e_z;              \
     if (cancellation >= TMP_CTX->tolerance) {                                  \
-      if (TMP_CTX->warning) {                                                  \
-        logger_info("cancellation of size %d detected\n", cancellation);       \
+      *Z += _cancellation_noise(TMP_CTX, cancellation, e_z, &(RNG_STATE));     \
+    }                                                                          \
+  }
+
+/* maximal number of lanes processed at once by the vector operations */
+#define CANCELLATION_VECTOR_MAX_SIZE 16
+
+/* Unbiased exponent computed on the integer representation, so that the
+ * loops of the vector operations are vectorized */
+#define _GET_EXPONENT_BITS(X)                                                  \
+  _Generic(X,                                                                  \
+      float: (int32_t)((((binary32){.f32 = (X)}).u32 & FLOAT_GET_EXP) >>       \
+                       FLOAT_PMAN_SIZE) -                                      \
+          FLOAT_EXP_COMP,                                                      \
+      double: (int32_t)((((binary64){.f64 = (X)}).u64 & DOUBLE_GET_EXP) >>     \
+                        DOUBLE_PMAN_SIZE) -                                    \
+          DOUBLE_EXP_COMP)
+
+/* Vector version of cancell. The results and the cancellation sizes of all
+ * the lanes are computed first, noise is then drawn only for the lanes where
+ * a cancellation is detected, in lane order, so that the results are those
+ * of the scalar operations. */
+#define _CANCELLATION_VECTOR_OP(SIZE, A, B, C, OPERATOR, CTX, RNG_STATE)       \
+  {                                                                            \
+    cancellation_context_t *TMP_CTX = (cancellation_context_t *)(CTX);         \
+    const int tolerance = TMP_CTX->tolerance;                                  \
+    int32_t cancellation[CANCELLATION_VECTOR_MAX_SIZE];                        \
+    int32_t e_c[CANCELLATION_VECTOR_MAX_SIZE];                                 \
+    for (int offset = 0; offset < (SIZE);                                      \
+         offset += CANCELLATION_VECTOR_MAX_SIZE) {                             \
+      const int n = ((SIZE)-offset < CANCELLATION_VECTOR_MAX_SIZE)             \
+                        ? (SIZE)-offset                                        \
+                        : CANCELLATION_VECTOR_MAX_SIZE;                        \
+      int triggered = 0;                                                       \
+      for (int i = 0; i < n; i++) {                                            \
+        const __typeof__(*(C)) res = (A)[offset + i] OPERATOR(B)[offset + i];  \
+        const int32_t e_a = _GET_EXPONENT_BITS((A)[offset + i]);               \
+        const int32_t e_b = _GET_EXPONENT_BITS((B)[offset + i]);               \
+        e_c[i] = _GET_EXPONENT_BITS(res);                                      \
+        cancellation[i] = max(e_a, e_b) - e_c[i];                              \
+        triggered |= (cancellation[i] >= tolerance);                           \
+        (C)[offset + i] = res;                                                 \
+      }                                                                        \
+      if (!triggered) {                                                        \
+        continue;                                                              \
+      }                                                                        \
+      for (int i = 0; i < n; i++) {                                            \
+        if (cancellation[i] >= tolerance) {                                    \
+          (C)[offset + i] += _cancellation_noise(TMP_CTX, cancellation[i],     \
+                                                 e_c[i], &(RNG_STATE));        \
+        }                                                                      \
       }                                                                        \
-      /* Add an MCA noise of the magnitude of cancelled bits.                  \
-       * This particular version in the case of cancellations does not use     \
-       * extended quad types */                                                \
-      const int32_t e_n = e_z - (cancellation - 1);                            \
-      _init_rng_state_struct(&(RNG_STATE), TMP_CTX->choose_seed,               \
-                             TMP_CTX->seed, false);                            \
-      *Z += _noise_binary64(e_n, &(RNG_STATE));                                \
     }                                                                          \
   }
 
@@ -200,6 +269,76 @@ void INTERFLOP_CANCELLATION_API(cast_double_to_float)(double a, float *b,
   *b = (float)a;
 }
 
+void INTERFLOP_CANCELLATION_API(add_float_vector)(const int size,
+                                                  const float *a,
+                                                  const float *b, float *c,
+                                                  void *context) {
+  _CANCELLATION_VECTOR_OP(size, a, b, c, +, context, rng_state);
+}
+
+void INTERFLOP_CANCELLATION_API(sub_float_vector)(const int size,
+                                                  const float *a,
+                                                  const float *b, float *c,
+                                                  void *context) {
+  _CANCELLATION_VECTOR_OP(size, a, b, c, -, context, rng_state);
+}
+
+void INTERFLOP_CANCELLATION_API(mul_float_vector)(const int size,
+                                                  const float *a,
+                                                  const float *b, float *c,
+                                                  _u_ void *context) {
+  for (int i = 0; i < size; i++) {
+    c[i] = a[i] * b[i];
+  }
+}
+
+void INTERFLOP_CANCELLATION_API(div_float_vector)(const int size,
+                                                  const float *a,
+                                                  const float *b, float *c,
+                                                  _u_ void *context) {
+  for (int i = 0; i < size; i++) {
+    c[i] = a[i] / b[i];
+  }
+}
+
+void INTERFLOP_CANCELLATION_API(add_double_vector)(const int size,
+                                                   const double *a,
+                                                   const double *b, double *c,
+                                                   void *context) {
+  _CANCELLATION_VECTOR_OP(size, a, b, c, +, context, rng_state);
+}
+
+void INTERFLOP_CANCELLATION_API(sub_double_vector)(const int size,
+                                                   const double *a,
+                                                   const double *b, double *c,
+                                                   void *context) {
+  _CANCELLATION_VECTOR_OP(size, a, b, c, -, context, rng_state);
+}
+
+void INTERFLOP_CANCELLATION_API(mul_double_vector)(const int size,
+                                                   const double *a,
+                                                   const double *b, double *c,
+                                                   _u_ void *context) {
+  for (int i = 0; i < size; i++) {
+    c[i] = a[i] * b[i];
+  }
+}
+
+void INTERFLOP_CANCELLATION_API(div_double_vector)(const int size,
+                                                   const double *a,
+                                                   const double *b, double *c,
+                                                   _u_ void *context) {
+  for (int i = 0; i < size; i++) {
+    c[i] = a[i] / b[i];
+  }
+}
+
+void INTERFLOP_CANCELLATION_API(finalize)(void *context) {
+  cancellation_context_t *ctx = (cancellation_context_t *)context;
+  _cancellation_sites_finalize(&ctx->sites, ctx->warning, ctx->profile_file,
+                               ctx->tolerance);
+}
+
 #undef _u_
 
 static const struct argp_option options[] = {
@@ -208,6 +347,8 @@ static const struct argp_option options[] = {
     {key_warning_str, KEY_WARNING, "WARNING", 0,
      "Enable warning for cancellations", 0},
     {key_seed_str, KEY_SEED, "SEED", 0, "Fix the random generator seed", 0},
+    {key_profile_file_str, KEY_PROFILE_FILE, "FILE", 0,
+     "write a per-call-site profile of the cancellations to FILE (JSON)", 0},
     {0}};
 
 static error_t parse_opt(int key, char *arg, struct argp_state *state) {
@@ -238,6 +379,9 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
     }
     _set_cancellation_seed(seed, ctx);
     break;
+  case KEY_PROFILE_FILE:
+    ctx->profile_file = arg;
+    break;
   default:
     return ARGP_ERR_UNKNOWN;
   }
@@ -264,17 +408,24 @@ void INTERFLOP_CANCELLATION_API(configure)(void *configure, void *context) {
   _set_cancellation_tolerance(conf->tolerance, ctx);
   _set_cancellation_warning(conf->warning, ctx);
   _set_cancellation_seed(conf->seed, ctx);
+  ctx->profile_file = conf->profile_file;
 }
 
 void _cancellation_check_stdlib(void) {
   INTERFLOP_CHECK_IMPL(malloc);
+  INTERFLOP_CHECK_IMPL(calloc);
+  INTERFLOP_CHECK_IMPL(free);
   INTERFLOP_CHECK_IMPL(exit);
+  INTERFLOP_CHECK_IMPL(fclose);
+  INTERFLOP_CHECK_IMPL(fgets);
   INTERFLOP_CHECK_IMPL(fopen);
   INTERFLOP_CHECK_IMPL(fprintf);
   INTERFLOP_CHECK_IMPL(getenv);
   INTERFLOP_CHECK_IMPL(gettid);
   INTERFLOP_CHECK_IMPL(sprintf);
   INTERFLOP_CHECK_IMPL(strcasecmp);
+  INTERFLOP_CHECK_IMPL(strcmp);
+  INTERFLOP_CHECK_IMPL(strcpy);
   INTERFLOP_CHECK_IMPL(strerror);
   INTERFLOP_CHECK_IMPL(vfprintf);
   INTERFLOP_CHECK_IMPL(vwarnx);
@@ -285,6 +436,8 @@ static void _cancellation_init_context(cancellation_context_t *ctx) {
   ctx->seed = CANCELLATION_SEED_DEFAULT;
   ctx->warning = CANCELLATION_WARNING_DEFAULT;
   ctx->tolerance = CANCELLATION_TOLERANCE_DEFAULT;
+  _cancellation_sites_init(&ctx->sites);
+  ctx->profile_file = Null;
 }
 
 void _cancellation_alloc_context(void **context) {
@@ -323,6 +476,8 @@ static void print_information_header(void *context) {
   logger_info("%s = %s\n", key_warning_str, ctx->warning ? "true" : "false");
   logger_info("%s = %lu%s\n", key_seed_str, ctx->seed,
               ctx->choose_seed ? " (fixed)" : "");
+  logger_info("%s = %s\n", key_profile_file_str,
+              ctx->profile_file ? ctx->profile_file : "none");
 }
 
 struct interflop_backend_interface_t
@@ -347,7 +502,23 @@ INTERFLOP_CANCELLATION_API(init)(void *context) {
       .interflop_enter_function = NULL,
       .interflop_exit_function = NULL,
       .interflop_user_call = NULL,
-      .interflop_finalize = NULL};
+      .interflop_finalize = INTERFLOP_CANCELLATION_API(finalize),
+      .interflop_add_float_vector =
+          INTERFLOP_CANCELLATION_API(add_float_vector),
+      .interflop_sub_float_vector =
+          INTERFLOP_CANCELLATION_API(sub_float_vector),
+      .interflop_mul_float_vector =
+          INTERFLOP_CANCELLATION_API(mul_float_vector),
+      .interflop_div_float_vector =
+          INTERFLOP_CANCELLATION_API(div_float_vector),
+      .interflop_add_double_vector =
+          INTERFLOP_CANCELLATION_API(add_double_vector),
+      .interflop_sub_double_vector =
+          INTERFLOP_CANCELLATION_API(sub_double_vector),
+      .interflop_mul_double_vector =
+          INTERFLOP_CANCELLATION_API(mul_double_vector),
+      .interflop_div_double_vector =
+          INTERFLOP_CANCELLATION_API(div_double_vector)};
 
   /* The seed for the RNG is initialized upon the first request for a random
   number */
@@ -368,3 +539,6 @@ void interflop_pre_init(interflop_panic_t panic, File *stream, void **context)
 
 void interflop_cli(int argc, char **argv, void *context)
     __attribute__((weak, alias("interflop_cancellation_cli")));
+
+int interflop_get_interface_version(void)
+    __attribute__((weak, alias("interflop_cancellation_get_interface_version")));
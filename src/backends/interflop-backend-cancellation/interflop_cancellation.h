@@ -14,6 +14,7 @@
 #define __INTERFLOP_CANCELLATION_H__
 
 #include "interflop/interflop_stdlib.h"
+#include "interflop_cancellation_sites.h"
 
 #define INTERFLOP_CANCELLATION_API(name) interflop_cancellation_##name
 
@@ -28,12 +29,16 @@ typedef struct {
   int tolerance;
   IBool choose_seed;
   IBool warning;
+  /* per-thread call-site tables */
+  vfc_call_sites_t sites;
+  const char *profile_file;
 } cancellation_context_t;
 
 typedef cancellation_context_t cancellation_conf_t;
 
 const char *INTERFLOP_CANCELLATION_API(get_backend_name)(void);
 const char *INTERFLOP_CANCELLATION_API(get_backend_version)(void);
+int INTERFLOP_CANCELLATION_API(get_interface_version)(void);
 
 void INTERFLOP_CANCELLATION_API(add_float)(float a, float b, float *res,
                                            void *context);
@@ -57,6 +62,39 @@ void INTERFLOP_CANCELLATION_API(fma_double)(double a, double b, double c,
                                             double *res, void *context);
 void INTERFLOP_CANCELLATION_API(cast_double_to_float)(double a, float *b,
                                                       void *context);
+void INTERFLOP_CANCELLATION_API(add_float_vector)(const int size,
+                                                  const float *a,
+                                                  const float *b, float *c,
+                                                  void *context);
+void INTERFLOP_CANCELLATION_API(sub_float_vector)(const int size,
+                                                  const float *a,
+                                                  const float *b, float *c,
+                                                  void *context);
+void INTERFLOP_CANCELLATION_API(mul_float_vector)(const int size,
+                                                  const float *a,
+                                                  const float *b, float *c,
+                                                  void *context);
+void INTERFLOP_CANCELLATION_API(div_float_vector)(const int size,
+                                                  const float *a,
+                                                  const float *b, float *c,
+                                                  void *context);
+void INTERFLOP_CANCELLATION_API(add_double_vector)(const int size,
+                                                   const double *a,
+                                                   const double *b, double *c,
+                                                   void *context);
+void INTERFLOP_CANCELLATION_API(sub_double_vector)(const int size,
+                                                   const double *a,
+                                                   const double *b, double *c,
+                                                   void *context);
+void INTERFLOP_CANCELLATION_API(mul_double_vector)(const int size,
+                                                   const double *a,
+                                                   const double *b, double *c,
+                                                   void *context);
+void INTERFLOP_CANCELLATION_API(div_double_vector)(const int size,
+                                                   const double *a,
+                                                   const double *b, double *c,
+                                                   void *context);
+void INTERFLOP_CANCELLATION_API(finalize)(void *context);
 void INTERFLOP_CANCELLATION_API(pre_init)(interflop_panic_t panic, File *stream,
                                           void **context);
 void INTERFLOP_CANCELLATION_API(cli)(int argc, char **argv, void *context);
@@ -0,0 +1,352 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *                                                                           *\
+ *  Copyright (c) 2026                                                       *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+// Cancellation call sites
+//
+// Cancellations are attributed to their call site (the return address of the
+// instrumented operation). Per call site, the backend counts the
+// cancellations, keeps the largest one and builds the histogram of their
+// sizes. Sites are stored in per-thread tables merged at finalization, where
+// one line is reported per call site instead of one line per cancellation,
+// and where the JSON profile is written. Call sites of the profile are
+// symbolized with addr2line, run once per object file.
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <stdio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "interflop/hashmap/vfc_call_sites.h"
+#include "interflop/interflop_stdlib.h"
+#include "interflop/iostream/logger.h"
+#include "interflop_cancellation_sites.h"
+
+#ifndef ADDR2LINE_PATH
+#define ADDR2LINE_PATH "llvm-addr2line"
+#endif
+
+/* table of the current thread */
+static __thread vfc_call_site_cache_t _cancellation_site_cache = {Null, 0, Null};
+
+static void _merge_site(void *dst, const void *src) {
+  _cancellation_site_t *d = (_cancellation_site_t *)dst;
+  const _cancellation_site_t *s = (const _cancellation_site_t *)src;
+  if (d->site.count == 0 || s->max_size > d->max_size) {
+    d->max_size = s->max_size;
+  }
+  d->site.count += s->site.count;
+  for (int i = 0; i <= CANCELLATION_PROFILE_MAX_SIZE; i++) {
+    d->sizes[i] += s->sizes[i];
+  }
+}
+
+void _cancellation_sites_init(vfc_call_sites_t *sites) {
+  vfc_call_sites_init(sites, sizeof(_cancellation_site_t), _merge_site);
+}
+
+void _cancellation_sites_record(vfc_call_sites_t *sites, int size) {
+  _cancellation_site_t *site = (_cancellation_site_t *)vfc_call_sites_get(
+      sites, &_cancellation_site_cache, interflop_call_site);
+  if (site == Null) {
+    return;
+  }
+  site->site.count++;
+  if (site->site.count == 1 || size > site->max_size) {
+    site->max_size = size;
+  }
+  site->sizes[(size < CANCELLATION_PROFILE_MAX_SIZE)
+                  ? size
+                  : CANCELLATION_PROFILE_MAX_SIZE]++;
+}
+
+/* Returns the address of the call of <site> in its object file, as expected
+ * by addr2line, and sets the object file of the site. <executable> is the
+ * path of the main program. */
+static ISize_t _get_object_address(_cancellation_site_t *site,
+                                   const char *executable) {
+  const char *object = Null;
+  const ISize_t address = vfc_call_site_object(site->site.call_site, &object);
+  /* the main program is named as invoked (argv[0]) */
+  site->object = (object == Null || object[0] == '\0' ||
+                  interflop_strcmp(object, program_invocation_name) == 0)
+                     ? executable
+                     : object;
+  return address;
+}
+
+/* Returns the length of <str> up to its first newline */
+static ISize_t _line_length(const char *str) {
+  ISize_t length = 0;
+  while (str[length] != '\0' && str[length] != '\n') {
+    length++;
+  }
+  return length;
+}
+
+/* Returns a copy of the line <str> allocated with interflop_malloc, or Null */
+static char *_copy_string(const char *str) {
+  char *copy = (char *)interflop_malloc(_line_length(str) + 1);
+  if (copy != Null) {
+    interflop_strcpy(copy, str);
+  }
+  return copy;
+}
+
+/* Reads a line of <stream> into <line> without its newline, the end of a
+ * line longer than <size> - 1 is dropped. Returns false at the end of the
+ * stream. */
+static IBool _read_line(FILE *stream, char *line, int size) {
+  if (fgets(line, size, stream) == Null) {
+    return IFalse;
+  }
+  ISize_t length = _line_length(line);
+  IBool truncated = line[length] == '\0';
+  line[length] = '\0';
+  char rest[CANCELLATION_LOCATION_SIZE];
+  while (truncated && fgets(rest, sizeof(rest), stream) != Null) {
+    truncated = rest[_line_length(rest)] == '\0';
+  }
+  return ITrue;
+}
+
+/* Writes the <size> bytes of <buffer> to <fd> */
+static void _write_all(int fd, const char *buffer, ISize_t size) {
+  while (size > 0) {
+    const ssize_t written = write(fd, buffer, size);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      return;
+    }
+    buffer += written;
+    size -= written;
+  }
+}
+
+/* Waits for the child <pid>, returns true if it exited successfully */
+static IBool _wait_child(pid_t pid) {
+  int status;
+  return pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) &&
+         WEXITSTATUS(status) == 0;
+}
+
+/* Symbolizes the <n> sites of <object> at <addresses> with a single run of
+ * addr2line. The addresses are written to the standard input of addr2line
+ * by a child process, so that their number is not limited by the size of
+ * the command line and that addr2line never blocks on a full output pipe.
+ * Sites keep a Null location if addr2line cannot be run. */
+static void _symbolize_object(const char *object, _cancellation_site_t **sites,
+                              const ISize_t *addresses, ISize_t n) {
+  /* "0x", 16 hexadecimal digits and a newline */
+  const ISize_t address_size = 19;
+  char *input = (char *)interflop_malloc(n * address_size + 1);
+  int input_fds[2] = {-1, -1};
+  int output_fds[2] = {-1, -1};
+  if (input == Null || pipe(input_fds) != 0 || pipe(output_fds) != 0) {
+    logger_warning("call sites of %s not symbolized: %s\n", object,
+                   interflop_strerror(errno));
+    for (int i = 0; i < 2; i++) {
+      if (input_fds[i] >= 0) {
+        close(input_fds[i]);
+      }
+    }
+    interflop_free(input);
+    return;
+  }
+
+  ISize_t input_size = 0;
+  for (ISize_t i = 0; i < n; i++) {
+    input_size +=
+        interflop_sprintf(input + input_size, "0x%lx\n", addresses[i]);
+  }
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    dup2(input_fds[0], 0);
+    dup2(output_fds[1], 1);
+    close(input_fds[0]);
+    close(input_fds[1]);
+    close(output_fds[0]);
+    close(output_fds[1]);
+    execlp(ADDR2LINE_PATH, ADDR2LINE_PATH, "-fpC", "-e", object, (char *)Null);
+    _exit(127);
+  }
+  close(input_fds[0]);
+  close(output_fds[1]);
+
+  pid_t writer = (pid > 0) ? fork() : -1;
+  if (writer == 0) {
+    close(output_fds[0]);
+    _write_all(input_fds[1], input, input_size);
+    _exit(0);
+  }
+  /* addr2line stops at the end of its input */
+  close(input_fds[1]);
+
+  /* addr2line prints one line per address, in order */
+  FILE *output = fdopen(output_fds[0], "r");
+  char line[CANCELLATION_LOCATION_SIZE];
+  for (ISize_t i = 0; i < n && output != Null &&
+                      _read_line(output, line, sizeof(line));
+       i++) {
+    sites[i]->location = _copy_string(line);
+  }
+  if (output != Null) {
+    fclose(output);
+  } else {
+    close(output_fds[0]);
+  }
+  const IBool written = _wait_child(writer);
+  if (!_wait_child(pid) || !written) {
+    logger_warning("call sites of %s not symbolized: error running %s\n",
+                   object, ADDR2LINE_PATH);
+  }
+
+  interflop_free(input);
+}
+
+/* Symbolizes the <n> <sites>, grouped by object file */
+static void _symbolize_sites(_cancellation_site_t **sites, ISize_t n) {
+  char executable[4096];
+  ssize_t length =
+      readlink("/proc/self/exe", executable, sizeof(executable) - 1);
+  executable[(length > 0) ? length : 0] = '\0';
+
+  ISize_t *addresses = (ISize_t *)interflop_malloc((n + 1) * sizeof(ISize_t));
+  _cancellation_site_t **object_sites =
+      (_cancellation_site_t **)interflop_malloc(
+          (n + 1) * sizeof(_cancellation_site_t *));
+  ISize_t *object_addresses =
+      (ISize_t *)interflop_malloc((n + 1) * sizeof(ISize_t));
+  char *done = (char *)interflop_calloc(n + 1, sizeof(char));
+  if (addresses == Null || object_sites == Null || object_addresses == Null ||
+      done == Null) {
+    logger_warning("call sites not symbolized: out of memory\n");
+    n = 0;
+  }
+
+  for (ISize_t i = 0; i < n; i++) {
+    addresses[i] = _get_object_address(sites[i], executable);
+  }
+  for (ISize_t i = 0; i < n; i++) {
+    if (done[i]) {
+      continue;
+    }
+    ISize_t m = 0;
+    for (ISize_t j = i; j < n; j++) {
+      if (!done[j] &&
+          interflop_strcmp(sites[j]->object, sites[i]->object) == 0) {
+        object_sites[m] = sites[j];
+        object_addresses[m] = addresses[j];
+        done[j] = 1;
+        m++;
+      }
+    }
+    _symbolize_object(sites[i]->object, object_sites, object_addresses, m);
+  }
+
+  interflop_free(done);
+  interflop_free(object_addresses);
+  interflop_free(object_sites);
+  interflop_free(addresses);
+}
+
+/* Write <str> as a JSON string, or null */
+static void _write_string(File *f, const char *str) {
+  if (str == Null) {
+    interflop_fprintf(f, "null");
+    return;
+  }
+  interflop_fprintf(f, "\"");
+  for (const char *c = str; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') {
+      interflop_fprintf(f, "\\%c", *c);
+    } else if ((unsigned char)*c < 0x20) {
+      interflop_fprintf(f, "\\u%04x", *c);
+    } else {
+      interflop_fprintf(f, "%c", *c);
+    }
+  }
+  interflop_fprintf(f, "\"");
+}
+
+static void _write_profile(File *f, _cancellation_site_t **sites, ISize_t n,
+                           int tolerance) {
+  interflop_fprintf(f, "{\n");
+  interflop_fprintf(f, "  \"format\": \"interflop-cancellation-profile\",\n");
+  interflop_fprintf(f, "  \"tolerance\": %d,\n", tolerance);
+  interflop_fprintf(f, "  \"max_size\": %d,\n", CANCELLATION_PROFILE_MAX_SIZE);
+  interflop_fprintf(f, "  \"sites\": [");
+  for (ISize_t i = 0; i < n; i++) {
+    _cancellation_site_t *site = sites[i];
+    interflop_fprintf(f, "%s\n    {\"call_site\": \"%p\", \"object\": ",
+                      (i == 0) ? "" : ",", site->site.call_site);
+    _write_string(f, site->object);
+    interflop_fprintf(f, ",\n     \"location\": ");
+    _write_string(f, site->location);
+    interflop_fprintf(f, ",\n     \"count\": %lu, \"max\": %d, \"sizes\": {",
+                      site->site.count, site->max_size);
+    const char *sep = "";
+    for (int j = 0; j <= CANCELLATION_PROFILE_MAX_SIZE; j++) {
+      if (site->sizes[j] != 0) {
+        interflop_fprintf(f, "%s\"%d\": %lu", sep, j, site->sizes[j]);
+        sep = ", ";
+      }
+    }
+    interflop_fprintf(f, "}}");
+  }
+  interflop_fprintf(f, "\n  ]\n}\n");
+}
+
+void _cancellation_sites_finalize(vfc_call_sites_t *sites, IBool warning,
+                                  const char *profile_file, int tolerance) {
+  if (!warning && profile_file == Null) {
+    return;
+  }
+
+  ISize_t n = 0;
+  _cancellation_site_t **merged =
+      (_cancellation_site_t **)vfc_call_sites_merge(sites, Null, &n);
+
+  if (warning) {
+    for (ISize_t i = 0; i < n; i++) {
+      logger_info("%lu cancellation(s) of size up to %d detected at %p\n",
+                  merged[i]->site.count, merged[i]->max_size,
+                  merged[i]->site.call_site);
+    }
+  }
+
+  if (profile_file != Null) {
+    _symbolize_sites(merged, n);
+    int error = 0;
+    File *f = interflop_fopen(profile_file, "w", &error);
+    if (f != Null) {
+      _write_profile(f, merged, n, tolerance);
+      interflop_fclose(f);
+    } else {
+      logger_error("Profile file can't be written: %s",
+                   interflop_strerror(error));
+    }
+    for (ISize_t i = 0; i < n; i++) {
+      interflop_free(merged[i]->location);
+    }
+  }
+
+  vfc_call_sites_free_merged((void **)merged, n);
+  vfc_call_sites_finalize(sites);
+}
@@ -0,0 +1,52 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *                                                                           *\
+ *  Copyright (c) 2026                                                       *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+
+#ifndef __INTERFLOP_CANCELLATION_SITES_H__
+#define __INTERFLOP_CANCELLATION_SITES_H__
+
+#include "interflop/hashmap/vfc_call_sites.h"
+#include "interflop/interflop_stdlib.h"
+
+/* Size histograms have one bin per cancellation size up to
+ * CANCELLATION_PROFILE_MAX_SIZE, the last bin also holds larger
+ * cancellations (total cancellations of binary64 operands are at most 53
+ * bits, except when the result is zero or subnormal) */
+#define CANCELLATION_PROFILE_MAX_SIZE 64
+
+/* longest source location kept for a call site */
+#define CANCELLATION_LOCATION_SIZE 1024
+
+/* Cancellations detected at one call site */
+typedef struct _cancellation_site {
+  /* call site and number of cancellations */
+  vfc_call_site_t site;
+  int max_size;
+  IUint64_t sizes[CANCELLATION_PROFILE_MAX_SIZE + 1];
+  /* object file of the call site and source location given by addr2line,
+   * filled when the profile is written */
+  const char *object;
+  char *location;
+} _cancellation_site_t;
+
+/* Initialize the per-thread tables of <sites> */
+void _cancellation_sites_init(vfc_call_sites_t *sites);
+
+/* Record a cancellation of <size> bits at the current call site */
+void _cancellation_sites_record(vfc_call_sites_t *sites, int size);
+
+/* Merge the per-thread tables, report the call sites if <warning>, write the
+ * profile to <profile_file> if not Null, and free the tables */
+void _cancellation_sites_finalize(vfc_call_sites_t *sites, IBool warning,
+                                  const char *profile_file, int tolerance);
+
+#endif /* __INTERFLOP_CANCELLATION_SITES_H__ */
@@ -40,6 +40,8 @@ typedef enum {
   KEY_PRINT_NEW_LINE = 'n',
   KEY_COUNT_OP = 'o',
   KEY_PRINT_SUBNORMAL_NORMALIZED,
+  KEY_PROFILE_FILE,
+  KEY_TRACE_FILE,
 } key_args;
 
 static const char backend_name[] = "interflop-ieee";
@@ -52,6 +54,8 @@ static const char key_print_new_line_str[] = "print-new-line";
 static const char key_print_subnormal_normalized_str[] =
     "print-subnormal-normalized";
 static const char key_count_op_str[] = "count-op";
+static const char key_profile_file_str[] = "profile-file";
+static const char key_trace_file_str[] = "trace-file";
 
 typedef enum {
   ARITHMETIC = 0,
@@ -73,6 +77,10 @@ const char *INTERFLOP_IEEE_API(get_backend_version)(void) {
   return backend_version;
 }
 
+int INTERFLOP_IEEE_API(get_interface_version)(void) {
+  return INTERFLOP_INTERFACE_VERSION;
+}
+
 /* inserts the string <str_to_add> at position i */
 /* increments i by the size of str_to_add */
 void insert_string(char *dst, const char *str_to_add, int *i) {
@@ -279,13 +287,63 @@ static inline void debug_print_fma_double(void *context,
     break;                                                                     \
   }
 
+/* counters of the current thread, only valid for the context that owns them */
+static __thread _ieee_counters_t *_ieee_thread_counters = Null;
+
+/* Allocates the counters of the current thread on their own cache line and
+ * registers them in the context to be summed at finalization */
+static _ieee_counters_t *_ieee_alloc_counters(ieee_context_t *ctx) {
+  void *raw = interflop_calloc(1, sizeof(_ieee_counters_t) +
+                                      IEEE_CACHE_LINE_SIZE);
+  _ieee_counters_t *counters =
+      (_ieee_counters_t *)(((IUint64_t)raw + IEEE_CACHE_LINE_SIZE - 1) &
+                           ~(IUint64_t)(IEEE_CACHE_LINE_SIZE - 1));
+  counters->context = ctx;
+  counters->next = __atomic_load_n(&ctx->counters, __ATOMIC_RELAXED);
+  while (!__atomic_compare_exchange_n(&ctx->counters, &counters->next,
+                                      counters, 0, __ATOMIC_RELEASE,
+                                      __ATOMIC_RELAXED))
+    ;
+  _ieee_thread_counters = counters;
+  return counters;
+}
+
+static inline void _ieee_count_op(ieee_context_t *ctx, ieee_op op) {
+  _ieee_counters_t *counters = _ieee_thread_counters;
+  if (counters == Null || counters->context != ctx) {
+    counters = _ieee_alloc_counters(ctx);
+  }
+  counters->count[op]++;
+}
+
+/* Appends the operation <op> to the binary trace if requested */
+#define TRACE_OP(ctx, op, type, predicate, a, b, c, res)                       \
+  {                                                                            \
+    if ((ctx)->trace != Null) {                                                \
+      _ieee_trace_record((ctx)->trace, op, type, predicate, a, b, c, res);     \
+    }                                                                          \
+  }
+
+/* Counts and profiles the operation <op> if requested */
+#define RECORD_OP(ctx, op, type, res, has_result, ...)                         \
+  {                                                                            \
+    if ((ctx)->count_op) {                                                     \
+      _ieee_count_op(ctx, op);                                                 \
+    }                                                                          \
+    if ((ctx)->profile_file != Null) {                                         \
+      const double operands[] = {__VA_ARGS__};                                 \
+      _ieee_profile_record(ctx, op, type, operands,                            \
+                           sizeof(operands) / sizeof(double), res,             \
+                           has_result);                                        \
+    }                                                                          \
+  }
+
 void INTERFLOP_IEEE_API(add_float)(const float a, const float b, float *c,
                                    void *context) {
   ieee_context_t *my_context = (ieee_context_t *)context;
   *c = a + b;
-  if (my_context->count_op) {
-    __atomic_add_fetch(&my_context->add_count, 1, __ATOMIC_RELAXED);
-  }
+  RECORD_OP(my_context, ieee_op_add, FFLOAT, *c, true, a, b);
+  TRACE_OP(my_context, ieee_op_add, FFLOAT, 0, a, b, 0, *c);
   debug_print_float(context, ARITHMETIC, "+", a, b, *c);
 }
 
@@ -293,9 +351,8 @@ void INTERFLOP_IEEE_API(sub_float)(const float a, const float b, float *c,
                                    void *context) {
   ieee_context_t *my_context = (ieee_context_t *)context;
   *c = a - b;
-  if (my_context->count_op) {
-    __atomic_add_fetch(&my_context->sub_count, 1, __ATOMIC_RELAXED);
-  }
+  RECORD_OP(my_context, ieee_op_sub, FFLOAT, *c, true, a, b);
+  TRACE_OP(my_context, ieee_op_sub, FFLOAT, 0, a, b, 0, *c);
   debug_print_float(context, ARITHMETIC, "-", a, b, *c);
 }
 
@@ -303,9 +360,8 @@ void INTERFLOP_IEEE_API(mul_float)(const float a, const float b, float *c,
                                    void *context) {
   ieee_context_t *my_context = (ieee_context_t *)context;
   *c = a * b;
-  if (my_context->count_op) {
-    __atomic_add_fetch(&my_context->mul_count, 1, __ATOMIC_RELAXED);
-  }
+  RECORD_OP(my_context, ieee_op_mul, FFLOAT, *c, true, a, b);
+  TRACE_OP(my_context, ieee_op_mul, FFLOAT, 0, a, b, 0, *c);
   debug_print_float(context, ARITHMETIC, "*", a, b, *c);
 }
 
@@ -313,16 +369,18 @@ void INTERFLOP_IEEE_API(div_float)(const float a, const float b, float *c,
                                    void *context) {
   ieee_context_t *my_context = (ieee_context_t *)context;
   *c = a / b;
-  if (my_context->count_op) {
-    __atomic_add_fetch(&my_context->div_count, 1, __ATOMIC_RELAXED);
-  }
+  RECORD_OP(my_context, ieee_op_div, FFLOAT, *c, true, a, b);
+  TRACE_OP(my_context, ieee_op_div, FFLOAT, 0, a, b, 0, *c);
   debug_print_float(context, ARITHMETIC, "/", a, b, *c);
 }
 
 void INTERFLOP_IEEE_API(cmp_float)(const enum FCMP_PREDICATE p, const float a,
                                    const float b, int *c, void *context) {
+  ieee_context_t *my_context = (ieee_context_t *)context;
   char *str = "";
   SELECT_FLOAT_CMP(a, b, c, p, str);
+  RECORD_OP(my_context, ieee_op_cmp, FFLOAT, 0, false, a, b);
+  TRACE_OP(my_context, ieee_op_cmp, FFLOAT, p, a, b, 0, *c);
   debug_print_float(context, COMPARISON, str, a, b, *c);
 }
 
@@ -330,9 +388,8 @@ void INTERFLOP_IEEE_API(add_double)(const double a, const double b, double *c,
                                     void *context) {
   ieee_context_t *my_context = (ieee_context_t *)context;
   *c = a + b;
-  if (my_context->count_op) {
-    __atomic_add_fetch(&my_context->add_count, 1, __ATOMIC_RELAXED);
-  }
+  RECORD_OP(my_context, ieee_op_add, FDOUBLE, *c, true, a, b);
+  TRACE_OP(my_context, ieee_op_add, FDOUBLE, 0, a, b, 0, *c);
   debug_print_double(context, ARITHMETIC, "+", a, b, *c);
 }
 
@@ -340,9 +397,8 @@ void INTERFLOP_IEEE_API(sub_double)(const double a, const double b, double *c,
                                     void *context) {
   ieee_context_t *my_context = (ieee_context_t *)context;
   *c = a - b;
-  if (my_context->count_op) {
-    __atomic_add_fetch(&my_context->sub_count, 1, __ATOMIC_RELAXED);
-  }
+  RECORD_OP(my_context, ieee_op_sub, FDOUBLE, *c, true, a, b);
+  TRACE_OP(my_context, ieee_op_sub, FDOUBLE, 0, a, b, 0, *c);
   debug_print_double(context, ARITHMETIC, "-", a, b, *c);
 }
 
@@ -350,9 +406,8 @@ void INTERFLOP_IEEE_API(mul_double)(const double a, const double b, double *c,
                                     void *context) {
   ieee_context_t *my_context = (ieee_context_t *)context;
   *c = a * b;
-  if (my_context->count_op) {
-    __atomic_add_fetch(&my_context->mul_count, 1, __ATOMIC_RELAXED);
-  }
+  RECORD_OP(my_context, ieee_op_mul, FDOUBLE, *c, true, a, b);
+  TRACE_OP(my_context, ieee_op_mul, FDOUBLE, 0, a, b, 0, *c);
   debug_print_double(context, ARITHMETIC, "*", a, b, *c);
 }
 
@@ -360,22 +415,27 @@ void INTERFLOP_IEEE_API(div_double)(const double a, const double b, double *c,
                                     void *context) {
   ieee_context_t *my_context = (ieee_context_t *)context;
   *c = a / b;
-  if (my_context->count_op) {
-    __atomic_add_fetch(&my_context->div_count, 1, __ATOMIC_RELAXED);
-  }
+  RECORD_OP(my_context, ieee_op_div, FDOUBLE, *c, true, a, b);
+  TRACE_OP(my_context, ieee_op_div, FDOUBLE, 0, a, b, 0, *c);
   debug_print_double(context, ARITHMETIC, "/", a, b, *c);
 }
 
 void INTERFLOP_IEEE_API(cmp_double)(const enum FCMP_PREDICATE p, const double a,
                                     const double b, int *c, void *context) {
+  ieee_context_t *my_context = (ieee_context_t *)context;
   char *str = "";
   SELECT_FLOAT_CMP(a, b, c, p, str);
+  RECORD_OP(my_context, ieee_op_cmp, FDOUBLE, 0, false, a, b);
+  TRACE_OP(my_context, ieee_op_cmp, FDOUBLE, p, a, b, 0, *c);
   debug_print_double(context, COMPARISON, str, a, b, *c);
 }
 
 void INTERFLOP_IEEE_API(cast_double_to_float)(double a, float *b,
                                               void *context) {
+  ieee_context_t *my_context = (ieee_context_t *)context;
   *b = (float)a;
+  RECORD_OP(my_context, ieee_op_cast, FDOUBLE, *b, true, a);
+  TRACE_OP(my_context, ieee_op_cast, FDOUBLE, 0, a, 0, 0, *b);
   debug_print_cast_double_to_float(context, CAST, "(float)", a, *b);
 }
 
@@ -383,9 +443,8 @@ void INTERFLOP_IEEE_API(fma_float)(float a, float b, float c, float *res,
                                    void *context) {
   ieee_context_t *my_context = (ieee_context_t *)context;
   *res = interflop_fma_binary32(a, b, c);
-  if (my_context->count_op) {
-    __atomic_add_fetch(&my_context->fma_count, 1, __ATOMIC_RELAXED);
-  }
+  RECORD_OP(my_context, ieee_op_fma, FFLOAT, *res, true, a, b, c);
+  TRACE_OP(my_context, ieee_op_fma, FFLOAT, 0, a, b, c, *res);
   debug_print_fma_float(context, FMA, "fma", a, b, c, *res);
 }
 
@@ -393,9 +452,8 @@ void INTERFLOP_IEEE_API(fma_double)(double a, double b, double c, double *res,
                                     void *context) {
   ieee_context_t *my_context = (ieee_context_t *)context;
   *res = interflop_fma_binary64(a, b, c);
-  if (my_context->count_op) {
-    __atomic_add_fetch(&my_context->fma_count, 1, __ATOMIC_RELAXED);
-  }
+  RECORD_OP(my_context, ieee_op_fma, FDOUBLE, *res, true, a, b, c);
+  TRACE_OP(my_context, ieee_op_fma, FDOUBLE, 0, a, b, c, *res);
   debug_print_fma_double(context, FMA, "fma", a, b, c, *res);
 }
 
@@ -403,18 +461,39 @@ void INTERFLOP_IEEE_API(finalize)(void *context) {
   ieee_context_t *my_context = (ieee_context_t *)context;
 
   if (my_context->count_op) {
+    /* sum the per-thread counters, they are not freed: threads still
+     * running keep a pointer to their counters */
+    IUint64_t count[_ieee_op_end_] = {0};
+    for (_ieee_counters_t *counters = my_context->counters; counters != Null;
+         counters = counters->next) {
+      for (int op = 0; op < _ieee_op_end_; op++) {
+        count[op] += counters->count[op];
+      }
+    }
+
     interflop_fprintf(logger_stderr, "operations count:\n");
-    interflop_fprintf(logger_stderr, "\t mul=%ld\n", my_context->mul_count);
-    interflop_fprintf(logger_stderr, "\t div=%ld\n", my_context->div_count);
-    interflop_fprintf(logger_stderr, "\t add=%ld\n", my_context->add_count);
-    interflop_fprintf(logger_stderr, "\t sub=%ld\n", my_context->sub_count);
-    interflop_fprintf(logger_stderr, "\t fma=%ld\n", my_context->fma_count);
+    interflop_fprintf(logger_stderr, "\t mul=%ld\n", count[ieee_op_mul]);
+    interflop_fprintf(logger_stderr, "\t div=%ld\n", count[ieee_op_div]);
+    interflop_fprintf(logger_stderr, "\t add=%ld\n", count[ieee_op_add]);
+    interflop_fprintf(logger_stderr, "\t sub=%ld\n", count[ieee_op_sub]);
+    interflop_fprintf(logger_stderr, "\t fma=%ld\n", count[ieee_op_fma]);
   };
+
+  _ieee_profile_finalize(my_context);
+
+  if (my_context->trace != Null) {
+    _ieee_trace_t *trace = my_context->trace;
+    my_context->trace = Null;
+    _ieee_trace_finalize(trace);
+  }
 }
 
 void _ieee_check_stdlib(void) {
   INTERFLOP_CHECK_IMPL(malloc);
+  INTERFLOP_CHECK_IMPL(calloc);
+  INTERFLOP_CHECK_IMPL(free);
   INTERFLOP_CHECK_IMPL(exit);
+  INTERFLOP_CHECK_IMPL(fclose);
   INTERFLOP_CHECK_IMPL(fopen);
   INTERFLOP_CHECK_IMPL(fprintf);
   INTERFLOP_CHECK_IMPL(getenv);
@@ -437,11 +516,11 @@ static void _ieee_init_context(ieee_context_t *context) {
   context->print_new_line = false;
   context->print_subnormal_normalized = false;
   context->count_op = false;
-  context->mul_count = 0;
-  context->div_count = 0;
-  context->add_count = 0;
-  context->sub_count = 0;
-  context->fma_count = 0;
+  context->counters = Null;
+  _ieee_profile_init(context);
+  context->profile_file = Null;
+  context->trace = Null;
+  context->trace_file = Null;
 }
 
 void INTERFLOP_IEEE_API(pre_init)(interflop_panic_t panic, File *stream,
@@ -474,10 +553,17 @@ static const struct argp_option options[] = {
     {key_print_subnormal_normalized_str, KEY_PRINT_SUBNORMAL_NORMALIZED, 0, 0,
      "normalize subnormal numbers", 0},
     {key_count_op_str, KEY_COUNT_OP, 0, 0, "enable operation count output", 0},
+    {key_profile_file_str, KEY_PROFILE_FILE, "FILE", 0,
+     "write a per-call-site operation profile with exponent histograms to "
+     "FILE (JSON)",
+     0},
+    {key_trace_file_str, KEY_TRACE_FILE, "FILE", 0,
+     "write a buffered binary trace of the operations to FILE, "
+     "decoded with vfc_trace_decode",
+     0},
     {0}};
 
-static error_t parse_opt(int key, __attribute__((unused)) char *arg,
-                         struct argp_state *state) {
+static error_t parse_opt(int key, char *arg, struct argp_state *state) {
   ieee_context_t *ctx = (ieee_context_t *)state->input;
   switch (key) {
   case KEY_DEBUG:
@@ -503,6 +589,12 @@ static error_t parse_opt(int key, __attribute__((unused)) char *arg,
   case KEY_COUNT_OP:
     ctx->count_op = true;
     break;
+  case KEY_PROFILE_FILE:
+    ctx->profile_file = arg;
+    break;
+  case KEY_TRACE_FILE:
+    ctx->trace_file = arg;
+    break;
   default:
     return ARGP_ERR_UNKNOWN;
   }
@@ -548,6 +640,10 @@ static void print_information_header(void *context) {
   logger_info("%s = %s\n", key_print_subnormal_normalized_str,
               ctx->print_subnormal_normalized ? "true" : "false");
   logger_info("%s = %s\n", key_count_op_str, ctx->count_op ? "true" : "false");
+  logger_info("%s = %s\n", key_profile_file_str,
+              ctx->profile_file ? ctx->profile_file : "none");
+  logger_info("%s = %s\n", key_trace_file_str,
+              ctx->trace_file ? ctx->trace_file : "none");
 }
 
 void INTERFLOP_IEEE_API(configure)(void *configure, void *context) {
@@ -559,6 +655,8 @@ void INTERFLOP_IEEE_API(configure)(void *configure, void *context) {
   ctx->print_new_line = conf->print_new_line;
   ctx->print_subnormal_normalized = conf->print_subnormal_normalized;
   ctx->count_op = conf->count_op;
+  ctx->profile_file = conf->profile_file;
+  ctx->trace_file = conf->trace_file;
 }
 
 struct interflop_backend_interface_t INTERFLOP_IEEE_API(init)(void *context) {
@@ -587,6 +685,10 @@ struct interflop_backend_interface_t INTERFLOP_IEEE_API(init)(void *context) {
 
   print_information_header(ctx);
 
+  if (ctx->trace_file != Null) {
+    ctx->trace = _ieee_trace_init(ctx->trace_file);
+  }
+
   return interflop_backend_ieee;
 }
 
@@ -598,3 +700,6 @@ void interflop_pre_init(interflop_panic_t panic, File *stream, void **context)
 
 void interflop_cli(int argc, char **argv, void *context)
     __attribute__((weak, alias("interflop_ieee_cli")));
+
+int interflop_get_interface_version(void)
+    __attribute__((weak, alias("interflop_ieee_get_interface_version")));
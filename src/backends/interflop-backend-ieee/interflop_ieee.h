@@ -14,16 +14,21 @@
 #define __INTERFLOP_IEEE_H__
 
 #include "interflop/interflop_stdlib.h"
+#include "interflop_ieee_profile.h"
+#include "interflop_ieee_trace.h"
 
 #define INTERFLOP_IEEE_API(name) interflop_ieee_##name
 
 /* Interflop context */
 typedef struct {
-  IUint64_t mul_count;
-  IUint64_t div_count;
-  IUint64_t add_count;
-  IUint64_t sub_count;
-  IUint64_t fma_count;
+  /* head of the list of per-thread operation counters */
+  _ieee_counters_t *counters;
+  /* per-thread call-site profiles */
+  vfc_call_sites_t profile_sites;
+  const char *profile_file;
+  /* binary trace, allocated at init when trace_file is set */
+  _ieee_trace_t *trace;
+  const char *trace_file;
   IBool debug;
   IBool debug_binary;
   IBool no_backend_name;
@@ -64,6 +69,7 @@ void INTERFLOP_IEEE_API(finalize)(void *context);
 
 const char *INTERFLOP_IEEE_API(get_backend_name)(void);
 const char *INTERFLOP_IEEE_API(get_backend_version)(void);
+int INTERFLOP_IEEE_API(get_interface_version)(void);
 void INTERFLOP_IEEE_API(pre_init)(interflop_panic_t panic, File *stream,
                                   void **context);
 void INTERFLOP_IEEE_API(cli)(int argc, char **argv, void *context);
@@ -0,0 +1,165 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *                                                                           *\
+ *  Copyright (c) 2026                                                       *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+// IEEE call-site profile
+//
+// Each operation is attributed to its call site (the return address of the
+// instrumented operation). Per call site, the backend counts the executions
+// and builds exponent histograms of the operands and of the result. Sites are
+// stored in per-thread tables merged at finalization into a JSON profile. Each
+// site gives its object file and the offset of the call in this file, which
+// can be symbolized with addr2line.
+
+#include "interflop/common/float_const.h"
+#include "interflop/common/float_struct.h"
+#include "interflop/hashmap/vfc_call_sites.h"
+#include "interflop/interflop.h"
+#include "interflop/interflop_stdlib.h"
+#include "interflop/iostream/logger.h"
+#include "interflop_ieee.h"
+#include "interflop_ieee_profile.h"
+
+static const char *const IEEE_OP_STR[] = {
+    [ieee_op_add] = "add", [ieee_op_sub] = "sub",   [ieee_op_mul] = "mul",
+    [ieee_op_div] = "div", [ieee_op_fma] = "fma",   [ieee_op_cmp] = "cmp",
+    [ieee_op_cast] = "cast"};
+
+/* table of the current thread */
+static __thread vfc_call_site_cache_t _ieee_profile_cache = {Null, 0, Null};
+
+static void _merge_site(void *dst, const void *src) {
+  _ieee_profile_site_t *d = (_ieee_profile_site_t *)dst;
+  const _ieee_profile_site_t *s = (const _ieee_profile_site_t *)src;
+  d->op = s->op;
+  d->type = s->type;
+  d->site.count += s->site.count;
+  for (int i = 0; i < IEEE_PROFILE_BINS; i++) {
+    d->operands[i] += s->operands[i];
+    d->results[i] += s->results[i];
+  }
+}
+
+void _ieee_profile_init(void *context) {
+  ieee_context_t *ctx = (ieee_context_t *)context;
+  vfc_call_sites_init(&ctx->profile_sites, sizeof(_ieee_profile_site_t),
+                      _merge_site);
+}
+
+/* Returns the histogram bin of <x> */
+static inline int _get_bin(double x) {
+  binary64 b64 = {.f64 = x};
+  return b64.ieee.exponent >> IEEE_PROFILE_BIN_SHIFT;
+}
+
+void _ieee_profile_record(void *context, ieee_op op, char type,
+                          const double *operands, int nb_operands, double res,
+                          IBool has_result) {
+  ieee_context_t *ctx = (ieee_context_t *)context;
+  _ieee_profile_site_t *site = (_ieee_profile_site_t *)vfc_call_sites_get(
+      &ctx->profile_sites, &_ieee_profile_cache, interflop_call_site);
+  if (site == Null) {
+    return;
+  }
+  site->op = op;
+  site->type = type;
+  site->site.count++;
+  for (int i = 0; i < nb_operands; i++) {
+    site->operands[_get_bin(operands[i])]++;
+  }
+  if (has_result) {
+    site->results[_get_bin(res)]++;
+  }
+}
+
+/* Write the non-empty bins of <histogram> as a JSON object mapping the
+ * smallest unbiased exponent of each bin to its count */
+static void _write_histogram(File *f, const IUint64_t *histogram) {
+  const char *sep = "";
+  interflop_fprintf(f, "{");
+  for (int i = 0; i < IEEE_PROFILE_BINS; i++) {
+    if (histogram[i] != 0) {
+      interflop_fprintf(f, "%s\"%d\": %lu", sep,
+                        (i << IEEE_PROFILE_BIN_SHIFT) - DOUBLE_EXP_COMP,
+                        histogram[i]);
+      sep = ", ";
+    }
+  }
+  interflop_fprintf(f, "}");
+}
+
+/* Write <str> as a JSON string, or null */
+static void _write_string(File *f, const char *str) {
+  if (str == Null) {
+    interflop_fprintf(f, "null");
+    return;
+  }
+  interflop_fprintf(f, "\"");
+  for (const char *c = str; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') {
+      interflop_fprintf(f, "\\%c", *c);
+    } else {
+      interflop_fprintf(f, "%c", *c);
+    }
+  }
+  interflop_fprintf(f, "\"");
+}
+
+static void _write_profile(File *f, _ieee_profile_site_t **sites, ISize_t n) {
+  interflop_fprintf(f, "{\n");
+  interflop_fprintf(f, "  \"format\": \"interflop-ieee-profile\",\n");
+  interflop_fprintf(f, "  \"exponent_bin_width\": %d,\n",
+                    1 << IEEE_PROFILE_BIN_SHIFT);
+  interflop_fprintf(f, "  \"sites\": [");
+  for (ISize_t i = 0; i < n; i++) {
+    _ieee_profile_site_t *site = sites[i];
+    const char *object = Null;
+    const ISize_t offset = vfc_call_site_object(site->site.call_site, &object);
+    interflop_fprintf(f, "%s\n    {\"call_site\": \"%p\", \"object\": ",
+                      (i == 0) ? "" : ",", site->site.call_site);
+    _write_string(f, object);
+    interflop_fprintf(f, ", \"offset\": \"0x%lx\",\n     ", offset);
+    interflop_fprintf(f, "\"type\": \"%s\", \"op\": \"%s\", \"count\": %lu,\n",
+                      (site->type == FFLOAT) ? "binary32" : "binary64",
+                      IEEE_OP_STR[(int)site->op], site->site.count);
+    interflop_fprintf(f, "     \"operands\": ");
+    _write_histogram(f, site->operands);
+    interflop_fprintf(f, ",\n     \"results\": ");
+    _write_histogram(f, site->results);
+    interflop_fprintf(f, "}");
+  }
+  interflop_fprintf(f, "\n  ]\n}\n");
+}
+
+void _ieee_profile_finalize(void *context) {
+  ieee_context_t *ctx = (ieee_context_t *)context;
+
+  if (ctx->profile_file == Null) {
+    return;
+  }
+
+  ISize_t n = 0;
+  _ieee_profile_site_t **sites = (_ieee_profile_site_t **)vfc_call_sites_merge(
+      &ctx->profile_sites, Null, &n);
+
+  int error = 0;
+  File *f = interflop_fopen(ctx->profile_file, "w", &error);
+  if (f != Null) {
+    _write_profile(f, sites, n);
+    interflop_fclose(f);
+  } else {
+    logger_error("Profile file can't be written: %s",
+                 interflop_strerror(error));
+  }
+
+  vfc_call_sites_free_merged((void **)sites, n);
+  vfc_call_sites_finalize(&ctx->profile_sites);
+}
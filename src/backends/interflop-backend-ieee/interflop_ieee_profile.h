@@ -0,0 +1,73 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *                                                                           *\
+ *  Copyright (c) 2026                                                       *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+
+#ifndef __INTERFLOP_IEEE_PROFILE_H__
+#define __INTERFLOP_IEEE_PROFILE_H__
+
+#include "interflop/hashmap/vfc_call_sites.h"
+#include "interflop/interflop_stdlib.h"
+
+/* operations counted by the backend */
+typedef enum {
+  ieee_op_add,
+  ieee_op_sub,
+  ieee_op_mul,
+  ieee_op_div,
+  ieee_op_fma,
+  ieee_op_cmp,
+  ieee_op_cast,
+  _ieee_op_end_
+} ieee_op;
+
+/* Exponent histograms use bins of 2^IEEE_PROFILE_BIN_SHIFT consecutive
+ * binary64 biased exponents. The first bin also holds zeros and subnormals,
+ * the last one infinities and NaNs. */
+#define IEEE_PROFILE_BIN_SHIFT 4
+#define IEEE_PROFILE_BINS (2048 >> IEEE_PROFILE_BIN_SHIFT)
+
+#define IEEE_CACHE_LINE_SIZE 64
+
+/* Per-thread operation counters. Each thread owns a whole cache line so that
+ * counting never writes to a line shared with another thread. */
+typedef struct _ieee_counters {
+  IUint64_t count[_ieee_op_end_];
+  struct _ieee_counters *next;
+  /* context whose list holds the counters */
+  const void *context;
+} __attribute__((aligned(IEEE_CACHE_LINE_SIZE))) _ieee_counters_t;
+
+/* Profile of one call site */
+typedef struct _ieee_profile_site {
+  /* call site and number of executions */
+  vfc_call_site_t site;
+  /* operation (ieee_op) and type of the operands (FFLOAT, FDOUBLE) */
+  char op;
+  char type;
+  IUint64_t operands[IEEE_PROFILE_BINS];
+  IUint64_t results[IEEE_PROFILE_BINS];
+} _ieee_profile_site_t;
+
+/* Initialize the per-thread tables of the call-site profile */
+void _ieee_profile_init(void *context);
+
+/* Record an operation executed at the current call site. <nb_operands> values
+ * of <operands> and the result <res> (if <has_result>) are added to the
+ * exponent histograms. */
+void _ieee_profile_record(void *context, ieee_op op, char type,
+                          const double *operands, int nb_operands, double res,
+                          IBool has_result);
+
+/* Merge the per-thread tables, write the JSON profile and free the tables */
+void _ieee_profile_finalize(void *context);
+
+#endif /* __INTERFLOP_IEEE_PROFILE_H__ */
@@ -0,0 +1,88 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *                                                                           *\
+ *  Copyright (c) 2026                                                       *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+// IEEE binary trace
+//
+// Instead of formatting each operation as text, the binary trace appends a
+// fixed-size record to the ring buffer of the current thread, drained to the
+// trace file by the ring writer of the stdlib. The trace is rendered in the
+// --debug text format by vfc_trace_decode.
+
+#include "interflop/interflop.h"
+#include "interflop/interflop_stdlib.h"
+#include "interflop/iostream/logger.h"
+#include "interflop_ieee_trace.h"
+
+/* buffer of the current thread */
+static __thread ring_buffer_t *_ieee_trace_buffer = Null;
+
+_ieee_trace_t *_ieee_trace_init(const char *filename) {
+  if (interflop_fwrite == Null) {
+    logger_error("--trace-file requires the fwrite handler");
+  }
+
+  int error = 0;
+  File *file = interflop_fopen(filename, "wb", &error);
+  if (file == Null) {
+    logger_error("Trace file can't be written: %s", interflop_strerror(error));
+  }
+
+  _ieee_trace_t *trace =
+      (_ieee_trace_t *)interflop_calloc(1, sizeof(_ieee_trace_t));
+
+  const IUint32_t header[2] = {IEEE_TRACE_VERSION,
+                               sizeof(_ieee_trace_record_t)};
+  interflop_fwrite(IEEE_TRACE_MAGIC, 1, sizeof(IEEE_TRACE_MAGIC) - 1, file);
+  interflop_fwrite(header, sizeof(IUint32_t), 2, file);
+
+  ring_writer_init(&trace->ring, file, IEEE_TRACE_BUFFER_SIZE, ITrue);
+  if (!trace->ring.writer_started) {
+    logger_warning("trace writer thread not started, "
+                   "buffers are flushed synchronously\n");
+  }
+
+  return trace;
+}
+
+void _ieee_trace_record(_ieee_trace_t *trace, ieee_op op, char type,
+                        char predicate, double a, double b, double c,
+                        double res) {
+  ring_buffer_t *buffer =
+      ring_writer_get_buffer(&trace->ring, &_ieee_trace_buffer);
+  /* the trace is finalized or the buffer cannot be allocated */
+  if (buffer == Null) {
+    return;
+  }
+
+  _ieee_trace_record_t record;
+  record.call_site = interflop_call_site;
+  record.operands[0] = a;
+  record.operands[1] = b;
+  record.operands[2] = c;
+  record.result = res;
+  record.op = op;
+  record.type = type;
+  record.predicate = predicate;
+  record.reserved = 0;
+  record.thread = buffer->index;
+
+  ring_writer_write(&trace->ring, buffer, &record, sizeof(record));
+}
+
+void _ieee_trace_finalize(_ieee_trace_t *trace) {
+  if (trace == Null) {
+    return;
+  }
+
+  ring_writer_finalize(&trace->ring);
+  interflop_fclose(trace->ring.stream);
+}
@@ -0,0 +1,65 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *                                                                           *\
+ *  Copyright (c) 2026                                                       *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+
+#ifndef __INTERFLOP_IEEE_TRACE_H__
+#define __INTERFLOP_IEEE_TRACE_H__
+
+#include "interflop/interflop_stdlib.h"
+#include "interflop/iostream/ring_writer.h"
+#include "interflop_ieee_profile.h"
+
+/* Binary trace file layout:
+ *   header: "VFCTRACE", version (u32), record size (u32)
+ *   records: _ieee_trace_record_t in native byte order,
+ *            grouped by chunks of consecutive records of one thread */
+#define IEEE_TRACE_MAGIC "VFCTRACE"
+#define IEEE_TRACE_VERSION 1
+
+/* number of bytes of a per-thread buffer, must be a power of two */
+#define IEEE_TRACE_BUFFER_SIZE (1 << 22)
+
+typedef struct {
+  /* return address of the instrumented operation */
+  void *call_site;
+  /* operands, unused ones are 0 */
+  double operands[3];
+  /* result, 0 or 1 for comparisons */
+  double result;
+  /* operation (ieee_op) */
+  char op;
+  /* type of the operands (FFLOAT, FDOUBLE) */
+  char type;
+  /* comparison predicate (enum FCMP_PREDICATE) */
+  char predicate;
+  char reserved;
+  /* index of the thread that executed the operation */
+  IUint32_t thread;
+} _ieee_trace_record_t;
+
+typedef struct {
+  /* per-thread buffers of records and writer thread */
+  ring_writer_t ring;
+} _ieee_trace_t;
+
+/* Open <filename>, write the header and start the writer thread */
+_ieee_trace_t *_ieee_trace_init(const char *filename);
+
+/* Append a record to the buffer of the current thread */
+void _ieee_trace_record(_ieee_trace_t *trace, ieee_op op, char type,
+                        char predicate, double a, double b, double c,
+                        double res);
+
+/* Stop the writer thread, flush all buffers and close the file */
+void _ieee_trace_finalize(_ieee_trace_t *trace);
+
+#endif /* __INTERFLOP_IEEE_TRACE_H__ */
@@ -277,14 +277,39 @@ static void _noise_binary128(_Float128 *x, const int exp,
 }
 
 /* Macro function for checking if the value X must be noised */
-#define _MUST_NOT_BE_NOISED(X, VIRTUAL_PRECISION, CTX)                         \
+#define _MUST_NOT_BE_NOISED(X, VIRTUAL_PRECISION, MODE)                        \
   /* if mode ieee, do not introduce noise */                                   \
-  ((CTX)->mode == mcaint_mode_ieee) || \
-  /* Check that we are not in a special case */ \
-  (FPCLASSIFY(X) != FP_NORMAL && FPCLASSIFY(X) != FP_SUBNORMAL) ||         \
-  /* In RR if the number is representable in current virtual precision, */ \
-  /* do not add any noise if */                                           \
-  ((CTX)->mode == mcaint_mode_rr && _IS_REPRESENTABLE(X, VIRTUAL_PRECISION))
+  ((MODE) == mcaint_mode_ieee) ||                                              \
+  /* Check that we are not in a special case */                                \
+  (FPCLASSIFY(X) != FP_NORMAL && FPCLASSIFY(X) != FP_SUBNORMAL) ||             \
+  /* In RR if the number is representable in current virtual precision, */     \
+  /* do not add any noise if */                                                \
+  ((MODE) == mcaint_mode_rr && _IS_REPRESENTABLE(X, VIRTUAL_PRECISION))
+
+/* Configuration of the MCA operations, as a tuple (MODE, DAZ, FTZ, SPARSE).
+ * The generic functions read it from the context, while the specialized ones
+ * selected by interflop_init get it as constants, see _MCAINT_SPECIALIZE */
+#define _SPEC_MODE(MODE, IS_DAZ, IS_FTZ, SPARSE) (MODE)
+#define _SPEC_DAZ(MODE, IS_DAZ, IS_FTZ, SPARSE) (IS_DAZ)
+#define _SPEC_FTZ(MODE, IS_DAZ, IS_FTZ, SPARSE) (IS_FTZ)
+#define _SPEC_SPARSE(MODE, IS_DAZ, IS_FTZ, SPARSE) (SPARSE)
+#define _SPEC_UNPACK(...) __VA_ARGS__
+
+/* Configuration read from the context CTX */
+#define _MCAINT_CONTEXT_SPEC_ARGS(CTX)                                         \
+  ((mcaint_context_t *)(CTX))->mode, ((mcaint_context_t *)(CTX))->daz,         \
+      ((mcaint_context_t *)(CTX))->ftz,                                        \
+      ((mcaint_context_t *)(CTX))->sparsity < 1.0f
+
+/* Parameters of the functions receiving the configuration, that may not
+ * use all of them */
+#define _MCAINT_SPEC_PARAMS                                                    \
+  __attribute__((unused)) const mcaint_mode mode,                              \
+      __attribute__((unused)) const bool daz,                                  \
+      __attribute__((unused)) const bool ftz,                                  \
+      __attribute__((unused)) const bool sparse
+#define _MCAINT_SPEC_ARGS mode, daz, ftz, sparse
+#define _MCAINT_SPEC (_MCAINT_SPEC_ARGS)
 
 /* Generic function for computing the mca noise */
 #define _NOISE(X, EXP, RNG_STATE)                                              \
@@ -293,15 +318,16 @@ static void _noise_binary128(_Float128 *x, const int exp,
 
 /* Macro function that adds mca noise to X
    according to the virtual_precision VIRTUAL_PRECISION */
-#define _INEXACT(X, VIRTUAL_PRECISION, CTX, RNG_STATE)                         \
+#define _INEXACT(X, VIRTUAL_PRECISION, CTX, RNG_STATE, SPEC)                   \
   {                                                                            \
     mcaint_context_t *TMP_CTX = (mcaint_context_t *)(CTX);                     \
     _init_rng_state_struct(&(RNG_STATE), TMP_CTX->choose_seed,                 \
                            (unsigned long long)(TMP_CTX->seed), false);        \
-    if (_MUST_NOT_BE_NOISED(*(X), VIRTUAL_PRECISION, TMP_CTX)) {               \
+    if (_MUST_NOT_BE_NOISED(*(X), VIRTUAL_PRECISION, _SPEC_MODE SPEC)) {       \
       return;                                                                  \
     }                                                                          \
-    if (_mca_skip_eval(TMP_CTX->sparsity, &(RNG_STATE), &mcaint_global_tid)) { \
+    if (_SPEC_SPARSE SPEC && _mca_skip_eval(TMP_CTX->sparsity, &(RNG_STATE),   \
+                                            &mcaint_global_tid)) {             \
       return;                                                                  \
     }                                                                          \
     const int32_t e_n_rel = -((VIRTUAL_PRECISION) - 1);                        \
@@ -309,23 +335,25 @@ static void _noise_binary128(_Float128 *x, const int exp,
   }
 
 /* Adds the mca noise to da */
-static void _mcaint_inexact_binary64(double *da, void *context) {
+static inline void _mcaint_inexact_binary64(double *da, void *context,
+                                            _MCAINT_SPEC_PARAMS) {
   mcaint_context_t *ctx = (mcaint_context_t *)context;
-  _INEXACT(da, ctx->binary32_precision, ctx, rng_state);
+  _INEXACT(da, ctx->binary32_precision, ctx, rng_state, _MCAINT_SPEC);
 }
 
 /* Adds the mca noise to qa */
-static void _mcaint_inexact_binary128(_Float128 *qa, void *context) {
+static inline void _mcaint_inexact_binary128(_Float128 *qa, void *context,
+                                             _MCAINT_SPEC_PARAMS) {
   mcaint_context_t *ctx = (mcaint_context_t *)context;
-  _INEXACT(qa, ctx->binary64_precision, ctx, rng_state);
+  _INEXACT(qa, ctx->binary64_precision, ctx, rng_state, _MCAINT_SPEC);
 }
 
 /* Generic functions that adds noise to A */
 /* The function is choosen depending on the type of X  */
-#define _INEXACT_BINARYN(X, A, CTX)                                            \
+#define _INEXACT_BINARYN(X, A, CTX, SPEC)                                      \
   _Generic(X,                                                                  \
       double: _mcaint_inexact_binary64,                                        \
-      _Float128: _mcaint_inexact_binary128)(A, CTX)
+      _Float128: _mcaint_inexact_binary128)(A, CTX, _SPEC_UNPACK SPEC)
 
 /******************** MCA ARITHMETIC FUNCTIONS ********************
  * The following set of functions perform the MCA operation. Operands
@@ -384,22 +412,23 @@ static void _mcaint_inexact_binary128(_Float128 *qa, void *context) {
 
 /* Generic macro function that returns mca(OP(A)) */
 /* Functions are determined according to the type of X */
-#define _MCAINT_UNARY_OP(A, OP, CTX, X)                                        \
+#define _MCAINT_UNARY_OP(A, OP, CTX, X, SPEC)                                  \
   do {                                                                         \
     typeof(X) _A = A;                                                          \
     typeof(X) _RES = 0;                                                        \
-    mcaint_context_t *TMP_CTX = (mcaint_context_t *)(CTX);                     \
-    if (TMP_CTX->daz) {                                                        \
+    if (_SPEC_DAZ SPEC) {                                                      \
       _A = DAZ(A);                                                             \
     }                                                                          \
-    if (TMP_CTX->mode == mcaint_mode_pb || TMP_CTX->mode == mcaint_mode_mca) { \
-      _INEXACT_BINARYN(X, &_A, CTX);                                           \
+    if (_SPEC_MODE SPEC == mcaint_mode_pb ||                                   \
+        _SPEC_MODE SPEC == mcaint_mode_mca) {                                  \
+      _INEXACT_BINARYN(X, &_A, CTX, SPEC);                                     \
     }                                                                          \
     PERFORM_UNARY_OP(OP, _RES, _A);                                            \
-    if (TMP_CTX->mode == mcaint_mode_rr || TMP_CTX->mode == mcaint_mode_mca) { \
-      _INEXACT_BINARYN(X, &_RES, CTX);                                         \
+    if (_SPEC_MODE SPEC == mcaint_mode_rr ||                                   \
+        _SPEC_MODE SPEC == mcaint_mode_mca) {                                  \
+      _INEXACT_BINARYN(X, &_RES, CTX, SPEC);                                   \
     }                                                                          \
-    if (TMP_CTX->ftz) {                                                        \
+    if (_SPEC_FTZ SPEC) {                                                      \
       _RES = FTZ((typeof(A))_RES);                                             \
     }                                                                          \
     return (typeof(A))(_RES);                                                  \
@@ -407,25 +436,26 @@ static void _mcaint_inexact_binary128(_Float128 *qa, void *context) {
 
 /* Generic macro function that returns mca(OP(A,B)) */
 /* Functions are determined according to the type of X */
-#define _MCAINT_BINARY_OP(A, B, OP, CTX, X)                                    \
+#define _MCAINT_BINARY_OP(A, B, OP, CTX, X, SPEC)                              \
   do {                                                                         \
     typeof(X) _A = A;                                                          \
     typeof(X) _B = B;                                                          \
     typeof(X) _RES = 0;                                                        \
-    mcaint_context_t *TMP_CTX = (mcaint_context_t *)(CTX);                     \
-    if (TMP_CTX->daz) {                                                        \
+    if (_SPEC_DAZ SPEC) {                                                      \
       _A = DAZ(A);                                                             \
       _B = DAZ(B);                                                             \
     }                                                                          \
-    if (TMP_CTX->mode == mcaint_mode_pb || TMP_CTX->mode == mcaint_mode_mca) { \
-      _INEXACT_BINARYN(X, &_A, CTX);                                           \
-      _INEXACT_BINARYN(X, &_B, CTX);                                           \
+    if (_SPEC_MODE SPEC == mcaint_mode_pb ||                                   \
+        _SPEC_MODE SPEC == mcaint_mode_mca) {                                  \
+      _INEXACT_BINARYN(X, &_A, CTX, SPEC);                                     \
+      _INEXACT_BINARYN(X, &_B, CTX, SPEC);                                     \
     }                                                                          \
     PERFORM_BIN_OP(OP, _RES, _A, _B);                                          \
-    if (TMP_CTX->mode == mcaint_mode_rr || TMP_CTX->mode == mcaint_mode_mca) { \
-      _INEXACT_BINARYN(X, &_RES, CTX);                                         \
+    if (_SPEC_MODE SPEC == mcaint_mode_rr ||                                   \
+        _SPEC_MODE SPEC == mcaint_mode_mca) {                                  \
+      _INEXACT_BINARYN(X, &_RES, CTX, SPEC);                                   \
     }                                                                          \
-    if (TMP_CTX->ftz) {                                                        \
+    if (_SPEC_FTZ SPEC) {                                                      \
       _RES = FTZ((typeof(A))_RES);                                             \
     }                                                                          \
     return (typeof(A))(_RES);                                                  \
@@ -433,28 +463,29 @@ static void _mcaint_inexact_binary128(_Float128 *qa, void *context) {
 
 /* Generic macro function that returns mca(OP(A,B,C)) */
 /* Functions are determined according to the type of X */
-#define _MCAINT_TERNARY_OP(A, B, C, OP, CTX, X)                                \
+#define _MCAINT_TERNARY_OP(A, B, C, OP, CTX, X, SPEC)                          \
   do {                                                                         \
     typeof(X) _A = A;                                                          \
     typeof(X) _B = B;                                                          \
     typeof(X) _C = C;                                                          \
     typeof(X) _RES = 0;                                                        \
-    mcaint_context_t *TMP_CTX = (mcaint_context_t *)(CTX);                     \
-    if (TMP_CTX->daz) {                                                        \
+    if (_SPEC_DAZ SPEC) {                                                      \
       _A = DAZ(A);                                                             \
       _B = DAZ(B);                                                             \
       _C = DAZ(C);                                                             \
     }                                                                          \
-    if (TMP_CTX->mode == mcaint_mode_pb || TMP_CTX->mode == mcaint_mode_mca) { \
-      _INEXACT_BINARYN(X, &_A, CTX);                                           \
-      _INEXACT_BINARYN(X, &_B, CTX);                                           \
-      _INEXACT_BINARYN(X, &_C, CTX);                                           \
+    if (_SPEC_MODE SPEC == mcaint_mode_pb ||                                   \
+        _SPEC_MODE SPEC == mcaint_mode_mca) {                                  \
+      _INEXACT_BINARYN(X, &_A, CTX, SPEC);                                     \
+      _INEXACT_BINARYN(X, &_B, CTX, SPEC);                                     \
+      _INEXACT_BINARYN(X, &_C, CTX, SPEC);                                     \
     }                                                                          \
     PERFORM_TERNARY_OP(OP, _RES, _A, _B, _C);                                  \
-    if (TMP_CTX->mode == mcaint_mode_rr || TMP_CTX->mode == mcaint_mode_mca) { \
-      _INEXACT_BINARYN(X, &_RES, CTX);                                         \
+    if (_SPEC_MODE SPEC == mcaint_mode_rr ||                                   \
+        _SPEC_MODE SPEC == mcaint_mode_mca) {                                  \
+      _INEXACT_BINARYN(X, &_RES, CTX, SPEC);                                   \
     }                                                                          \
-    if (TMP_CTX->ftz) {                                                        \
+    if (_SPEC_FTZ SPEC) {                                                      \
       _RES = FTZ((typeof(A))_RES);                                             \
     }                                                                          \
     return (typeof(A))(_RES);                                                  \
@@ -464,45 +495,46 @@ static void _mcaint_inexact_binary128(_Float128 *qa, void *context) {
 /* Intermediate computations are performed with binary64 */
 static inline float _mcaint_binary32_unary_op(const float a,
                                               const mcaint_operations dop,
-                                              void *context) {
-  _MCAINT_UNARY_OP(a, dop, context, (double)0);
+                                              void *context,
+                                              _MCAINT_SPEC_PARAMS) {
+  _MCAINT_UNARY_OP(a, dop, context, (double)0, _MCAINT_SPEC);
 }
 
 /* Performs mca(a dop b) where a and b are binary32 values */
 /* Intermediate computations are performed with binary64 */
 static inline float _mcaint_binary32_binary_op(const float a, const float b,
                                                const mcaint_operations dop,
-                                               void *context) {
-  _MCAINT_BINARY_OP(a, b, dop, context, (double)0);
+                                               void *context,
+                                               _MCAINT_SPEC_PARAMS) {
+  _MCAINT_BINARY_OP(a, b, dop, context, (double)0, _MCAINT_SPEC);
 }
 
 /* Performs mca(a dop b dop c) where a, b and c are binary32 values */
 /* Intermediate computations are performed with binary64 */
-// float _mcaint_binary32_ternary_op(const float a, const float b, const float
-// c,
-//                                const mcaint_operations dop, void *context);
-
 static inline float _mcaint_binary32_ternary_op(const float a, const float b,
                                                 const float c,
                                                 const mcaint_operations dop,
-                                                void *context) {
-  _MCAINT_TERNARY_OP(a, b, c, dop, context, (double)0);
+                                                void *context,
+                                                _MCAINT_SPEC_PARAMS) {
+  _MCAINT_TERNARY_OP(a, b, c, dop, context, (double)0, _MCAINT_SPEC);
 }
 
 /* Performs mca(qop a) where a is a binary64 value */
 /* Intermediate computations are performed with binary128 */
 static inline double _mcaint_binary64_unary_op(const double a,
                                                const mcaint_operations qop,
-                                               void *context) {
-  _MCAINT_UNARY_OP(a, qop, context, (_Float128)0);
+                                               void *context,
+                                               _MCAINT_SPEC_PARAMS) {
+  _MCAINT_UNARY_OP(a, qop, context, (_Float128)0, _MCAINT_SPEC);
 }
 
 /* Performs mca(a qop b) where a and b are binary64 values */
 /* Intermediate computations are performed with binary128 */
 static inline double _mcaint_binary64_binary_op(const double a, const double b,
                                                 const mcaint_operations qop,
-                                                void *context) {
-  _MCAINT_BINARY_OP(a, b, qop, context, (_Float128)0);
+                                                void *context,
+                                                _MCAINT_SPEC_PARAMS) {
+  _MCAINT_BINARY_OP(a, b, qop, context, (_Float128)0, _MCAINT_SPEC);
 }
 
 /* Performs mca(a qop b qop c) where a, b and c are binary64 values */
@@ -510,8 +542,9 @@ static inline double _mcaint_binary64_binary_op(const double a, const double b,
 static inline double _mcaint_binary64_ternary_op(const double a, const double b,
                                                  const double c,
                                                  const mcaint_operations qop,
-                                                 void *context) {
-  _MCAINT_TERNARY_OP(a, b, c, qop, context, (_Float128)0);
+                                                 void *context,
+                                                 _MCAINT_SPEC_PARAMS) {
+  _MCAINT_TERNARY_OP(a, b, c, qop, context, (_Float128)0, _MCAINT_SPEC);
 }
 
 /************************* FPHOOKS FUNCTIONS *************************
@@ -522,57 +555,196 @@ static inline double _mcaint_binary64_ternary_op(const double a, const double b,
 
 void INTERFLOP_MCAINT_API(add_float)(float a, float b, float *res,
                                      void *context) {
-  *res = _mcaint_binary32_binary_op(a, b, mcaint_add, context);
+  *res = _mcaint_binary32_binary_op(a, b, mcaint_add, context,
+                                    _MCAINT_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAINT_API(sub_float)(float a, float b, float *res,
                                      void *context) {
-  *res = _mcaint_binary32_binary_op(a, b, mcaint_sub, context);
+  *res = _mcaint_binary32_binary_op(a, b, mcaint_sub, context,
+                                    _MCAINT_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAINT_API(mul_float)(float a, float b, float *res,
                                      void *context) {
-  *res = _mcaint_binary32_binary_op(a, b, mcaint_mul, context);
+  *res = _mcaint_binary32_binary_op(a, b, mcaint_mul, context,
+                                    _MCAINT_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAINT_API(div_float)(float a, float b, float *res,
                                      void *context) {
-  *res = _mcaint_binary32_binary_op(a, b, mcaint_div, context);
+  *res = _mcaint_binary32_binary_op(a, b, mcaint_div, context,
+                                    _MCAINT_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAINT_API(fma_float)(float a, float b, float c, float *res,
                                      void *context) {
-  *res = _mcaint_binary32_ternary_op(a, b, c, mcaint_fma, context);
+  *res = _mcaint_binary32_ternary_op(a, b, c, mcaint_fma, context,
+                                     _MCAINT_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAINT_API(add_double)(double a, double b, double *res,
                                       void *context) {
-  *res = _mcaint_binary64_binary_op(a, b, mcaint_add, context);
+  *res = _mcaint_binary64_binary_op(a, b, mcaint_add, context,
+                                    _MCAINT_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAINT_API(sub_double)(double a, double b, double *res,
                                       void *context) {
-  *res = _mcaint_binary64_binary_op(a, b, mcaint_sub, context);
+  *res = _mcaint_binary64_binary_op(a, b, mcaint_sub, context,
+                                    _MCAINT_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAINT_API(mul_double)(double a, double b, double *res,
                                       void *context) {
-  *res = _mcaint_binary64_binary_op(a, b, mcaint_mul, context);
+  *res = _mcaint_binary64_binary_op(a, b, mcaint_mul, context,
+                                    _MCAINT_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAINT_API(div_double)(double a, double b, double *res,
                                       void *context) {
-  *res = _mcaint_binary64_binary_op(a, b, mcaint_div, context);
+  *res = _mcaint_binary64_binary_op(a, b, mcaint_div, context,
+                                    _MCAINT_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAINT_API(fma_double)(double a, double b, double c, double *res,
                                       void *context) {
-  *res = _mcaint_binary64_ternary_op(a, b, c, mcaint_fma, context);
+  *res = _mcaint_binary64_ternary_op(a, b, c, mcaint_fma, context,
+                                     _MCAINT_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAINT_API(cast_double_to_float)(double a, float *res,
                                                 void *context) {
-  *res = (float)_mcaint_binary64_unary_op(a, mcaint_cast, context);
+  *res = (float)_mcaint_binary64_unary_op(a, mcaint_cast, context,
+                                          _MCAINT_CONTEXT_SPEC_ARGS(context));
+}
+
+/******************** SPECIALIZED FPHOOKS FUNCTIONS ********************
+ * The configuration of the operations (mode, DAZ, FTZ and sparsity) does
+ * not change after the initialization. interflop_init installs FPHOOKS
+ * functions specialized for the configuration, where the compiler can fold
+ * the configuration tests. The INTERFLOP_MCAINT_API functions
+ * above keep reading the configuration from the context.
+ **********************************************************************/
+
+/* Defines the FPHOOKS functions NAME_add_float, ... for the configuration
+ * (mode, daz, ftz, sparse) given in the variable arguments, and
+ * NAME_set_interface that installs them in an interface */
+#define _MCAINT_SPECIALIZE(NAME, ...)                                          \
+  static void NAME##_add_float(float a, float b, float *res, void *context) {  \
+    *res = _mcaint_binary32_binary_op(a, b, mcaint_add, context,               \
+                                      __VA_ARGS__);                            \
+  }                                                                            \
+  static void NAME##_sub_float(float a, float b, float *res, void *context) {  \
+    *res = _mcaint_binary32_binary_op(a, b, mcaint_sub, context,               \
+                                      __VA_ARGS__);                            \
+  }                                                                            \
+  static void NAME##_mul_float(float a, float b, float *res, void *context) {  \
+    *res = _mcaint_binary32_binary_op(a, b, mcaint_mul, context,               \
+                                      __VA_ARGS__);                            \
+  }                                                                            \
+  static void NAME##_div_float(float a, float b, float *res, void *context) {  \
+    *res = _mcaint_binary32_binary_op(a, b, mcaint_div, context,               \
+                                      __VA_ARGS__);                            \
+  }                                                                            \
+  static void NAME##_fma_float(float a, float b, float c, float *res,          \
+                               void *context) {                                \
+    *res = _mcaint_binary32_ternary_op(a, b, c, mcaint_fma, context,           \
+                                       __VA_ARGS__);                           \
+  }                                                                            \
+  static void NAME##_add_double(double a, double b, double *res,               \
+                                void *context) {                               \
+    *res = _mcaint_binary64_binary_op(a, b, mcaint_add, context,               \
+                                      __VA_ARGS__);                            \
+  }                                                                            \
+  static void NAME##_sub_double(double a, double b, double *res,               \
+                                void *context) {                               \
+    *res = _mcaint_binary64_binary_op(a, b, mcaint_sub, context,               \
+                                      __VA_ARGS__);                            \
+  }                                                                            \
+  static void NAME##_mul_double(double a, double b, double *res,               \
+                                void *context) {                               \
+    *res = _mcaint_binary64_binary_op(a, b, mcaint_mul, context,               \
+                                      __VA_ARGS__);                            \
+  }                                                                            \
+  static void NAME##_div_double(double a, double b, double *res,               \
+                                void *context) {                               \
+    *res = _mcaint_binary64_binary_op(a, b, mcaint_div, context,               \
+                                      __VA_ARGS__);                            \
+  }                                                                            \
+  static void NAME##_fma_double(double a, double b, double c, double *res,     \
+                                void *context) {                               \
+    *res = _mcaint_binary64_ternary_op(a, b, c, mcaint_fma, context,           \
+                                       __VA_ARGS__);                           \
+  }                                                                            \
+  static void NAME##_cast_double_to_float(double a, float *res,                \
+                                          void *context) {                     \
+    *res = (float)_mcaint_binary64_unary_op(a, mcaint_cast, context,           \
+                                            __VA_ARGS__);                      \
+  }                                                                            \
+  static void NAME##_set_interface(                                            \
+      struct interflop_backend_interface_t *interface) {                       \
+    interface->interflop_add_float = NAME##_add_float;                         \
+    interface->interflop_sub_float = NAME##_sub_float;                         \
+    interface->interflop_mul_float = NAME##_mul_float;                         \
+    interface->interflop_div_float = NAME##_div_float;                         \
+    interface->interflop_fma_float = NAME##_fma_float;                         \
+    interface->interflop_add_double = NAME##_add_double;                       \
+    interface->interflop_sub_double = NAME##_sub_double;                       \
+    interface->interflop_mul_double = NAME##_mul_double;                       \
+    interface->interflop_div_double = NAME##_div_double;                       \
+    interface->interflop_fma_double = NAME##_fma_double;                       \
+    interface->interflop_cast_double_to_float = NAME##_cast_double_to_float;   \
+  }
+
+typedef void (*mcaint_set_interface_t)(struct interflop_backend_interface_t *);
+
+/* Specializes the FPHOOKS functions for each DAZ and FTZ flags of the mode
+ * MODE and the sparse flag SPARSE */
+#define _MCAINT_SPECIALIZE_DAZ_FTZ(NAME, MODE, SPARSE)                         \
+  _MCAINT_SPECIALIZE(NAME##_nodaz_noftz, MODE, false, false, SPARSE)           \
+  _MCAINT_SPECIALIZE(NAME##_nodaz_ftz, MODE, false, true, SPARSE)              \
+  _MCAINT_SPECIALIZE(NAME##_daz_noftz, MODE, true, false, SPARSE)              \
+  _MCAINT_SPECIALIZE(NAME##_daz_ftz, MODE, true, true, SPARSE)
+
+#define _MCAINT_SPECIALIZE_SPARSE(NAME, MODE)                                  \
+  _MCAINT_SPECIALIZE_DAZ_FTZ(NAME##_dense, MODE, false)                        \
+  _MCAINT_SPECIALIZE_DAZ_FTZ(NAME##_sparse, MODE, true)
+
+_MCAINT_SPECIALIZE_SPARSE(_mcaint_mca, mcaint_mode_mca)
+_MCAINT_SPECIALIZE_SPARSE(_mcaint_pb, mcaint_mode_pb)
+_MCAINT_SPECIALIZE_SPARSE(_mcaint_rr, mcaint_mode_rr)
+/* the ieee mode does not add noise, only DAZ and FTZ matter */
+_MCAINT_SPECIALIZE_DAZ_FTZ(_mcaint_ieee, mcaint_mode_ieee, false)
+
+/* Table of the specializations, indexed by the DAZ and FTZ flags */
+#define _MCAINT_DAZ_FTZ_TABLE(NAME)                                            \
+  {                                                                            \
+    {NAME##_nodaz_noftz_set_interface, NAME##_nodaz_ftz_set_interface},        \
+        {NAME##_daz_noftz_set_interface, NAME##_daz_ftz_set_interface},        \
+  }
+
+#define _MCAINT_SPARSE_TABLE(NAME)                                             \
+  {_MCAINT_DAZ_FTZ_TABLE(NAME##_dense), _MCAINT_DAZ_FTZ_TABLE(NAME##_sparse)}
+
+/* [mode][sparse][daz][ftz] */
+static const mcaint_set_interface_t
+    _mcaint_specializations[_mcaint_mode_end_][2][2][2] = {
+        /* the sparsity does not matter in the ieee mode */
+        [mcaint_mode_ieee] = {_MCAINT_DAZ_FTZ_TABLE(_mcaint_ieee),
+                              _MCAINT_DAZ_FTZ_TABLE(_mcaint_ieee)},
+        [mcaint_mode_mca] = _MCAINT_SPARSE_TABLE(_mcaint_mca),
+        [mcaint_mode_pb] = _MCAINT_SPARSE_TABLE(_mcaint_pb),
+        [mcaint_mode_rr] = _MCAINT_SPARSE_TABLE(_mcaint_rr),
+};
+
+/* Installs in interface the FPHOOKS functions specialized for the
+ * configuration of ctx */
+static void _mcaint_set_specialized_interface(
+    const mcaint_context_t *ctx,
+    struct interflop_backend_interface_t *interface) {
+  const bool sparse = ctx->sparsity < 1.0f;
+  _mcaint_specializations[ctx->mode][sparse][ctx->daz][ctx->ftz](interface);
 }
 
 const char *INTERFLOP_MCAINT_API(get_backend_name)(void) {
@@ -583,6 +755,10 @@ const char *INTERFLOP_MCAINT_API(get_backend_version)(void) {
   return backend_version;
 }
 
+int INTERFLOP_MCAINT_API(get_interface_version)(void) {
+  return INTERFLOP_INTERFACE_VERSION;
+}
+
 void _mcaint_check_stdlib(void) {
   INTERFLOP_CHECK_IMPL(exit);
   INTERFLOP_CHECK_IMPL(fopen);
@@ -805,6 +981,8 @@ struct interflop_backend_interface_t INTERFLOP_MCAINT_API(init)(void *context) {
       .interflop_user_call = NULL,
       .interflop_finalize = NULL};
 
+  _mcaint_set_specialized_interface(ctx, &interflop_backend_mcaint);
+
   /* The seed for the RNG is initialized upon the first request for a random
      number */
   _init_rng_state_struct(&rng_state, ctx->choose_seed, ctx->seed, false);
@@ -821,3 +999,6 @@ void interflop_pre_init(interflop_panic_t panic, File *stream, void **context)
 
 void interflop_cli(int argc, char **argv, void *context)
     __attribute__((weak, alias("interflop_mcaint_cli")));
+
+int interflop_get_interface_version(void)
+    __attribute__((weak, alias("interflop_mcaint_get_interface_version")));
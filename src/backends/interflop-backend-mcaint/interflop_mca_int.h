@@ -104,6 +104,7 @@ void INTERFLOP_MCAINT_API(cast_double_to_float)(double a, float *res,
 
 const char *INTERFLOP_MCAINT_API(get_backend_name)(void);
 const char *INTERFLOP_MCAINT_API(get_backend_version)(void);
+int INTERFLOP_MCAINT_API(get_interface_version)(void);
 void INTERFLOP_MCAINT_API(pre_init)(interflop_panic_t panic, File *stream,
                                     void **context);
 void INTERFLOP_MCAINT_API(cli)(int argc, char **argv, void *context);
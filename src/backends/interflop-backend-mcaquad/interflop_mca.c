@@ -92,6 +92,7 @@ typedef enum {
   KEY_PREC_B32,
   KEY_PREC_B64,
   KEY_ERR_EXP,
+  KEY_ENGINE,
   KEY_MODE = 'm',
   KEY_ERR_MODE = 'e',
   KEY_SEED = 's',
@@ -109,6 +110,7 @@ static const char key_seed_str[] = "seed";
 static const char key_daz_str[] = "daz";
 static const char key_ftz_str[] = "ftz";
 static const char key_sparsity_str[] = "sparsity";
+static const char key_engine_str[] = "engine";
 
 static const char *const MCAQUAD_MODE_STR[] = {[mcaquad_mode_ieee] = "ieee",
                                                [mcaquad_mode_mca] = "mca",
@@ -120,6 +122,9 @@ static const char *const MCAQUAD_ERR_MODE_STR[] = {
     [mcaquad_err_mode_abs] = "abs",
     [mcaquad_err_mode_all] = "all"};
 
+static const char *const MCAQUAD_ENGINE_STR[] = {
+    [mcaquad_engine_quad] = "quad", [mcaquad_engine_dd] = "double-double"};
+
 /* possible operations values */
 typedef enum {
   mcaquad_add = '+',
@@ -208,6 +213,17 @@ static void _set_mcaquad_sparsity(float sparsity, mcaquad_context_t *ctx) {
   }
 }
 
+/* Set the engine computing binary64 operations */
+static void _set_mcaquad_engine(const mcaquad_engine engine,
+                                mcaquad_context_t *ctx) {
+  if (engine >= _mcaquad_engine_end_) {
+    logger_error("--%s invalid value provided, must be one of: "
+                 "{quad, double-double}.",
+                 key_engine_str);
+  }
+  ctx->engine = engine;
+}
+
 /* Set RNG seed */
 static void _set_mcaquad_seed(uint64_t seed, mcaquad_context_t *ctx) {
   ctx->choose_seed = true;
@@ -229,6 +245,10 @@ const char *INTERFLOP_MCAQUAD_API(get_backend_version)(void) {
   return backend_version;
 }
 
+int INTERFLOP_MCAQUAD_API(get_interface_version)(void) {
+  return INTERFLOP_INTERFACE_VERSION;
+}
+
 /******************** MCA RANDOM FUNCTIONS ********************
  * The following functions are used to calculate the random
  * perturbations used for MCA
@@ -303,14 +323,45 @@ _Float128 _noise_binary128(const int exp, rng_state_t *rng_state) {
   (FPCLASSIFY(X) != FP_NORMAL && FPCLASSIFY(X) != FP_SUBNORMAL)
 
 /* Macro function for checking if the value X must be noised */
-#define _MUST_NOT_BE_NOISED(X, VIRTUAL_PRECISION, CTX)                         \
+#define _MUST_NOT_BE_NOISED(X, VIRTUAL_PRECISION, MODE)                        \
   /* if mode ieee, do not introduce noise */                                   \
-  ((CTX)->mode == mcaquad_mode_ieee) ||					                                   \
-  /* Check that we are not in a special case */				                         \
-  (FPCLASSIFY(X) != FP_NORMAL && FPCLASSIFY(X) != FP_SUBNORMAL) ||	           \
+  ((MODE) == mcaquad_mode_ieee) ||                                             \
+  /* Check that we are not in a special case */                                \
+  (FPCLASSIFY(X) != FP_NORMAL && FPCLASSIFY(X) != FP_SUBNORMAL) ||             \
   /* In RR if the number is representable in current virtual precision, */     \
-  /* do not add any noise if */						                                     \
-  ((CTX)->mode == mcaquad_mode_rr && _IS_REPRESENTABLE(X, VIRTUAL_PRECISION))
+  /* do not add any noise if */                                                \
+  ((MODE) == mcaquad_mode_rr && _IS_REPRESENTABLE(X, VIRTUAL_PRECISION))
+
+/* Configuration of the MCA operations, as a tuple
+ * (MODE, REL_ERR, ABS_ERR, DAZ, FTZ, SPARSE). The generic functions read it
+ * from the context, while the specialized ones selected by interflop_init
+ * get it as constants, see _MCAQUAD_SPECIALIZE */
+#define _SPEC_MODE(MODE, REL_ERR, ABS_ERR, IS_DAZ, IS_FTZ, SPARSE) (MODE)
+#define _SPEC_REL_ERR(MODE, REL_ERR, ABS_ERR, IS_DAZ, IS_FTZ, SPARSE) (REL_ERR)
+#define _SPEC_ABS_ERR(MODE, REL_ERR, ABS_ERR, IS_DAZ, IS_FTZ, SPARSE) (ABS_ERR)
+#define _SPEC_DAZ(MODE, REL_ERR, ABS_ERR, IS_DAZ, IS_FTZ, SPARSE) (IS_DAZ)
+#define _SPEC_FTZ(MODE, REL_ERR, ABS_ERR, IS_DAZ, IS_FTZ, SPARSE) (IS_FTZ)
+#define _SPEC_SPARSE(MODE, REL_ERR, ABS_ERR, IS_DAZ, IS_FTZ, SPARSE) (SPARSE)
+#define _SPEC_UNPACK(...) __VA_ARGS__
+
+/* Configuration read from the context CTX */
+#define _MCAQUAD_CONTEXT_SPEC_ARGS(CTX)                                        \
+  ((mcaquad_context_t *)(CTX))->mode, ((mcaquad_context_t *)(CTX))->relErr,    \
+      ((mcaquad_context_t *)(CTX))->absErr, ((mcaquad_context_t *)(CTX))->daz, \
+      ((mcaquad_context_t *)(CTX))->ftz,                                       \
+      ((mcaquad_context_t *)(CTX))->sparsity < 1.0f
+
+/* Parameters of the functions receiving the configuration, that may not
+ * use all of them */
+#define _MCAQUAD_SPEC_PARAMS                                                   \
+  __attribute__((unused)) const mcaquad_mode mode,                             \
+      __attribute__((unused)) const bool rel_err,                              \
+      __attribute__((unused)) const bool abs_err,                              \
+      __attribute__((unused)) const bool daz,                                  \
+      __attribute__((unused)) const bool ftz,                                  \
+      __attribute__((unused)) const bool sparse
+#define _MCAQUAD_SPEC_ARGS mode, rel_err, abs_err, daz, ftz, sparse
+#define _MCAQUAD_SPEC (_MCAQUAD_SPEC_ARGS)
 
 /* Generic function for computing the mca noise */
 #define _NOISE(X, EXP, RNG_STATE)                                              \
@@ -336,25 +387,25 @@ _Float128 _noise_binary128(const int exp, rng_state_t *rng_state) {
 
 /* Macro function that adds mca noise to X
    according to the virtual_precision VIRTUAL_PRECISION */
-#define _INEXACT(X, VIRTUAL_PRECISION, CTX, RNG_STATE)                         \
+#define _INEXACT(X, VIRTUAL_PRECISION, CTX, RNG_STATE, SPEC)                   \
   {                                                                            \
     mcaquad_context_t *TMP_CTX = (mcaquad_context_t *)(CTX);                   \
     _init_rng_state_struct(&(RNG_STATE), TMP_CTX->choose_seed,                 \
                            (unsigned long long)(TMP_CTX->seed), false);        \
-    if (_MUST_NOT_BE_NOISED(*X, VIRTUAL_PRECISION, TMP_CTX)) {                 \
+    if (_MUST_NOT_BE_NOISED(*X, VIRTUAL_PRECISION, _SPEC_MODE SPEC)) {         \
       return;                                                                  \
     }                                                                          \
-    if (_mca_skip_eval(TMP_CTX->sparsity, &(RNG_STATE),                        \
-                       &mcaquad_global_tid)) {                                 \
+    if (_SPEC_SPARSE SPEC && _mca_skip_eval(TMP_CTX->sparsity, &(RNG_STATE),   \
+                                            &mcaquad_global_tid)) {            \
       return;                                                                  \
     }                                                                          \
-    if (TMP_CTX->relErr) {                                                     \
+    if (_SPEC_REL_ERR SPEC) {                                                  \
       const int32_t e_a = GET_EXP_FLT(*(X));                                   \
       const int32_t e_n_rel = e_a - ((VIRTUAL_PRECISION) - 1);                 \
       const typeof(*(X)) noise_rel = _NOISE(*(X), e_n_rel, &(RNG_STATE));      \
       *(X) += noise_rel;                                                       \
     }                                                                          \
-    if (TMP_CTX->absErr) {                                                     \
+    if (_SPEC_ABS_ERR SPEC) {                                                  \
       const int32_t e_n_abs = TMP_CTX->absErr_exp;                             \
       const typeof(*(X)) noise_abs = _NOISE(*(X), e_n_abs, &(RNG_STATE));      \
       *(X) += noise_abs;                                                       \
@@ -362,25 +413,25 @@ _Float128 _noise_binary128(const int exp, rng_state_t *rng_state) {
   }
 
 /* Adds the mca noise to da */
-extern void _mcaquad_inexact_binary64(double *da, void *context);
-inline void _mcaquad_inexact_binary64(double *da, void *context) {
+static inline void _mcaquad_inexact_binary64(double *da, void *context,
+                                             _MCAQUAD_SPEC_PARAMS) {
   mcaquad_context_t *ctx = (mcaquad_context_t *)context;
-  _INEXACT(da, ctx->binary32_precision, ctx, rng_state);
+  _INEXACT(da, ctx->binary32_precision, ctx, rng_state, _MCAQUAD_SPEC);
 }
 
 /* Adds the mca noise to qa */
-extern void _mcaquad_inexact_binary128(_Float128 *qa, void *context);
-inline void _mcaquad_inexact_binary128(_Float128 *qa, void *context) {
+static inline void _mcaquad_inexact_binary128(_Float128 *qa, void *context,
+                                              _MCAQUAD_SPEC_PARAMS) {
   mcaquad_context_t *ctx = (mcaquad_context_t *)context;
-  _INEXACT(qa, ctx->binary64_precision, ctx, rng_state);
+  _INEXACT(qa, ctx->binary64_precision, ctx, rng_state, _MCAQUAD_SPEC);
 }
 
 /* Generic functions that adds noise to A */
 /* The function is choosen depending on the type of X  */
-#define _INEXACT_BINARYN(X, A, CTX)                                            \
+#define _INEXACT_BINARYN(X, A, CTX, SPEC)                                      \
   _Generic(X,                                                                  \
       double: _mcaquad_inexact_binary64,                                       \
-      _Float128: _mcaquad_inexact_binary128)(A, CTX)
+      _Float128: _mcaquad_inexact_binary128)(A, CTX, _SPEC_UNPACK SPEC)
 
 /******************** MCA ARITHMETIC FUNCTIONS ********************
  * The following set of functions perform the MCA operation. Operands
@@ -441,24 +492,23 @@ inline void _mcaquad_inexact_binary128(_Float128 *qa, void *context) {
 
 /* Generic macro function that returns mca(A OP B) */
 /* Functions are determined according to the type of X */
-#define _MCAQUAD_UNARY_OP(A, OP, CTX, X)                                       \
+#define _MCAQUAD_UNARY_OP(A, OP, CTX, X, SPEC)                                 \
   do {                                                                         \
     typeof(X) _A = A;                                                          \
     typeof(X) _RES = 0;                                                        \
-    mcaquad_context_t *TMP_CTX = (mcaquad_context_t *)(CTX);                   \
-    if (TMP_CTX->daz) {                                                        \
+    if (_SPEC_DAZ SPEC) {                                                      \
       _A = DAZ(A);                                                             \
     }                                                                          \
-    if (TMP_CTX->mode == mcaquad_mode_pb ||                                    \
-        TMP_CTX->mode == mcaquad_mode_mca) {                                   \
-      _INEXACT_BINARYN(X, &_A, CTX);                                           \
+    if (_SPEC_MODE SPEC == mcaquad_mode_pb ||                                  \
+        _SPEC_MODE SPEC == mcaquad_mode_mca) {                                 \
+      _INEXACT_BINARYN(X, &_A, CTX, SPEC);                                     \
     }                                                                          \
     PERFORM_UNARY_OP(OP, _RES, _A);                                            \
-    if (TMP_CTX->mode == mcaquad_mode_rr ||                                    \
-        TMP_CTX->mode == mcaquad_mode_mca) {                                   \
-      _INEXACT_BINARYN(X, &_RES, CTX);                                         \
+    if (_SPEC_MODE SPEC == mcaquad_mode_rr ||                                  \
+        _SPEC_MODE SPEC == mcaquad_mode_mca) {                                 \
+      _INEXACT_BINARYN(X, &_RES, CTX, SPEC);                                   \
     }                                                                          \
-    if (TMP_CTX->ftz) {                                                        \
+    if (_SPEC_FTZ SPEC) {                                                      \
       _RES = FTZ((typeof(A))_RES);                                             \
     }                                                                          \
     return (typeof(A))(_RES);                                                  \
@@ -466,27 +516,26 @@ inline void _mcaquad_inexact_binary128(_Float128 *qa, void *context) {
 
 /* Generic macro function that returns mca(A OP B) */
 /* Functions are determined according to the type of X */
-#define _MCAQUAD_BINARY_OP(A, B, OP, CTX, X)                                   \
+#define _MCAQUAD_BINARY_OP(A, B, OP, CTX, X, SPEC)                             \
   do {                                                                         \
     typeof(X) _A = A;                                                          \
     typeof(X) _B = B;                                                          \
     typeof(X) _RES = 0;                                                        \
-    mcaquad_context_t *TMP_CTX = (mcaquad_context_t *)(CTX);                   \
-    if (TMP_CTX->daz) {                                                        \
+    if (_SPEC_DAZ SPEC) {                                                      \
       _A = DAZ(A);                                                             \
       _B = DAZ(B);                                                             \
     }                                                                          \
-    if (TMP_CTX->mode == mcaquad_mode_pb ||                                    \
-        TMP_CTX->mode == mcaquad_mode_mca) {                                   \
-      _INEXACT_BINARYN(X, &_A, CTX);                                           \
-      _INEXACT_BINARYN(X, &_B, CTX);                                           \
+    if (_SPEC_MODE SPEC == mcaquad_mode_pb ||                                  \
+        _SPEC_MODE SPEC == mcaquad_mode_mca) {                                 \
+      _INEXACT_BINARYN(X, &_A, CTX, SPEC);                                     \
+      _INEXACT_BINARYN(X, &_B, CTX, SPEC);                                     \
     }                                                                          \
     PERFORM_BIN_OP(OP, _RES, _A, _B);                                          \
-    if (TMP_CTX->mode == mcaquad_mode_rr ||                                    \
-        TMP_CTX->mode == mcaquad_mode_mca) {                                   \
-      _INEXACT_BINARYN(X, &_RES, CTX);                                         \
+    if (_SPEC_MODE SPEC == mcaquad_mode_rr ||                                  \
+        _SPEC_MODE SPEC == mcaquad_mode_mca) {                                 \
+      _INEXACT_BINARYN(X, &_RES, CTX, SPEC);                                   \
     }                                                                          \
-    if (TMP_CTX->ftz) {                                                        \
+    if (_SPEC_FTZ SPEC) {                                                      \
       _RES = FTZ((typeof(A))_RES);                                             \
     }                                                                          \
     return (typeof(A))(_RES);                                                  \
@@ -494,94 +543,394 @@ inline void _mcaquad_inexact_binary128(_Float128 *qa, void *context) {
 
 /* Generic macro function that returns mca(A OP B OP C) */
 /* Functions are determined according to the type of X */
-#define _MCAQUAD_TERNARY_OP(A, B, C, OP, CTX, X)                               \
+#define _MCAQUAD_TERNARY_OP(A, B, C, OP, CTX, X, SPEC)                         \
   do {                                                                         \
     typeof(X) _A = A;                                                          \
     typeof(X) _B = B;                                                          \
     typeof(X) _C = C;                                                          \
     typeof(X) _RES = 0;                                                        \
-    mcaquad_context_t *TMP_CTX = (mcaquad_context_t *)(CTX);                   \
-    if (TMP_CTX->daz) {                                                        \
+    if (_SPEC_DAZ SPEC) {                                                      \
       _A = DAZ(A);                                                             \
       _B = DAZ(B);                                                             \
       _C = DAZ(C);                                                             \
     }                                                                          \
-    if (TMP_CTX->mode == mcaquad_mode_pb ||                                    \
-        TMP_CTX->mode == mcaquad_mode_mca) {                                   \
-      _INEXACT_BINARYN(X, &_A, CTX);                                           \
-      _INEXACT_BINARYN(X, &_B, CTX);                                           \
-      _INEXACT_BINARYN(X, &_C, CTX);                                           \
+    if (_SPEC_MODE SPEC == mcaquad_mode_pb ||                                  \
+        _SPEC_MODE SPEC == mcaquad_mode_mca) {                                 \
+      _INEXACT_BINARYN(X, &_A, CTX, SPEC);                                     \
+      _INEXACT_BINARYN(X, &_B, CTX, SPEC);                                     \
+      _INEXACT_BINARYN(X, &_C, CTX, SPEC);                                     \
     }                                                                          \
     PERFORM_TERNARY_OP(OP, _RES, _A, _B, _C);                                  \
-    if (TMP_CTX->mode == mcaquad_mode_rr ||                                    \
-        TMP_CTX->mode == mcaquad_mode_mca) {                                   \
-      _INEXACT_BINARYN(X, &_RES, CTX);                                         \
+    if (_SPEC_MODE SPEC == mcaquad_mode_rr ||                                  \
+        _SPEC_MODE SPEC == mcaquad_mode_mca) {                                 \
+      _INEXACT_BINARYN(X, &_RES, CTX, SPEC);                                   \
     }                                                                          \
-    if (TMP_CTX->ftz) {                                                        \
+    if (_SPEC_FTZ SPEC) {                                                      \
       _RES = FTZ((typeof(A))_RES);                                             \
     }                                                                          \
     return (typeof(A))(_RES);                                                  \
   } while (0);
 
+/******************** DOUBLE-DOUBLE ENGINE ********************
+ * With --engine=double-double, binary64 operations are computed on
+ * unevaluated sums hi + lo of two binary64 values with error-free
+ * transformations instead of the software binary128 arithmetic. Operations
+ * on two binary64 values are exact, and the other ones have a relative error
+ * below 2^-104, so the MCA semantics is kept for virtual precisions up to
+ * 53. Operations whose operands or result are too close to the underflow or
+ * overflow thresholds for the transformations to be exact fall back to the
+ * binary128 engine.
+ *******************************************************************/
+
+/* Range of the exponents handled by the double-double engine. Without a
+ * hardware fma, TwoProd splits its operands with (2^27 + 1) * x, which
+ * overflows for exponents above 996 */
+#define MCAQUAD_DD_EXP_MIN -800
+#define MCAQUAD_DD_EXP_MAX 1000
+#define MCAQUAD_DD_SPLIT_EXP_MAX 995
+
+#if !defined(__FP_FAST_FMA) && (defined(__x86_64__) || defined(__i386__))
+/* The backend is built for the baseline ISA, the hardware fma is used if the
+ * CPU has one */
+#define MCAQUAD_DD_FMA_DISPATCH
+static bool _dd_hw_fma = false;
+
+__attribute__((target("fma"))) static double
+_dd_fma_hw(const double a, const double b, const double c) {
+  return __builtin_fma(a, b, c);
+}
+#endif
+
+/* Returns the largest exponent handled by the double-double engine */
+static inline int32_t _dd_exp_max(void) {
+#if defined(__FP_FAST_FMA)
+  return MCAQUAD_DD_EXP_MAX;
+#elif defined(MCAQUAD_DD_FMA_DISPATCH)
+  return _dd_hw_fma ? MCAQUAD_DD_EXP_MAX : MCAQUAD_DD_SPLIT_EXP_MAX;
+#else
+  return MCAQUAD_DD_SPLIT_EXP_MAX;
+#endif
+}
+
+typedef struct {
+  double hi;
+  double lo;
+} mcaquad_dd_t;
+
+/* s + e = a + b (Knuth TwoSum) */
+static inline mcaquad_dd_t _dd_two_sum(const double a, const double b) {
+  const double s = a + b;
+  const double bb = s - a;
+  const double e = (a - (s - bb)) + (b - bb);
+  return (mcaquad_dd_t){s, e};
+}
+
+/* s + e = a + b for |a| >= |b| (Dekker FastTwoSum) */
+static inline mcaquad_dd_t _dd_fast_two_sum(const double a, const double b) {
+  const double s = a + b;
+  const double e = b - (s - a);
+  return (mcaquad_dd_t){s, e};
+}
+
+/* p + e = a * b (TwoProd) */
+static inline mcaquad_dd_t _dd_two_prod(const double a, const double b) {
+  const double p = a * b;
+#ifdef __FP_FAST_FMA
+  const double e = __builtin_fma(a, b, -p);
+#else
+#ifdef MCAQUAD_DD_FMA_DISPATCH
+  if (_dd_hw_fma) {
+    return (mcaquad_dd_t){p, _dd_fma_hw(a, b, -p)};
+  }
+#endif
+  /* Veltkamp splitting of the operands in 26-bit halves */
+  const double split = 0x1p27 + 1;
+  const double ca = split * a;
+  const double a_hi = ca - (ca - a);
+  const double a_lo = a - a_hi;
+  const double cb = split * b;
+  const double b_hi = cb - (cb - b);
+  const double b_lo = b - b_hi;
+  const double e =
+      ((a_hi * b_hi - p) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo;
+#endif
+  return (mcaquad_dd_t){p, e};
+}
+
+static inline mcaquad_dd_t _dd_neg(const mcaquad_dd_t a) {
+  return (mcaquad_dd_t){-a.hi, -a.lo};
+}
+
+static inline mcaquad_dd_t _dd_add_double(const mcaquad_dd_t a,
+                                          const double b) {
+  mcaquad_dd_t s = _dd_two_sum(a.hi, b);
+  s.lo += a.lo;
+  return _dd_fast_two_sum(s.hi, s.lo);
+}
+
+static inline mcaquad_dd_t _dd_add(const mcaquad_dd_t a,
+                                   const mcaquad_dd_t b) {
+  mcaquad_dd_t s = _dd_two_sum(a.hi, b.hi);
+  const mcaquad_dd_t t = _dd_two_sum(a.lo, b.lo);
+  s.lo += t.hi;
+  s = _dd_fast_two_sum(s.hi, s.lo);
+  s.lo += t.lo;
+  return _dd_fast_two_sum(s.hi, s.lo);
+}
+
+static inline mcaquad_dd_t _dd_mul_double(const mcaquad_dd_t a,
+                                          const double b) {
+  mcaquad_dd_t p = _dd_two_prod(a.hi, b);
+  p.lo += a.lo * b;
+  return _dd_fast_two_sum(p.hi, p.lo);
+}
+
+static inline mcaquad_dd_t _dd_mul(const mcaquad_dd_t a,
+                                   const mcaquad_dd_t b) {
+  mcaquad_dd_t p = _dd_two_prod(a.hi, b.hi);
+  p.lo += a.hi * b.lo + a.lo * b.hi;
+  return _dd_fast_two_sum(p.hi, p.lo);
+}
+
+/* Long division: each quotient digit is corrected by the exact remainder */
+static inline mcaquad_dd_t _dd_div(const mcaquad_dd_t a,
+                                   const mcaquad_dd_t b) {
+  const double q1 = a.hi / b.hi;
+  mcaquad_dd_t r = _dd_add(a, _dd_neg(_dd_mul_double(b, q1)));
+  const double q2 = r.hi / b.hi;
+  r = _dd_add(r, _dd_neg(_dd_mul_double(b, q2)));
+  const double q3 = r.hi / b.hi;
+  return _dd_add_double(_dd_fast_two_sum(q1, q2), q3);
+}
+
+/* Returns the exponent of hi + lo, which is the one of hi unless hi is a
+ * power of two and lo has the opposite sign */
+static inline int32_t _dd_get_exponent(const mcaquad_dd_t x) {
+  const binary64 b64 = {.f64 = x.hi};
+  const int32_t e = GET_EXP_FLT(x.hi);
+  if (b64.ieee.mantissa == 0 && x.lo != 0 && ((x.lo < 0) != (x.hi < 0))) {
+    return e - 1;
+  }
+  return e;
+}
+
+/* noise = rand * 2^(exp), exp is in the normal range of binary64 */
+static inline double _noise_dd(const int exp, rng_state_t *rng_state) {
+  const double d_rand = get_rand_double01(rng_state, &mcaquad_global_tid) - 0.5;
+  return d_rand * _fast_pow2_binary64(exp);
+}
+
+/* Adds the mca noise to the double-double x, same as _INEXACT */
+static inline void _mcaquad_inexact_dd(mcaquad_dd_t *x,
+                                       const int virtual_precision,
+                                       mcaquad_context_t *ctx,
+                                       _MCAQUAD_SPEC_PARAMS) {
+  _init_rng_state_struct(&rng_state, ctx->choose_seed,
+                         (unsigned long long)(ctx->seed), false);
+  if (mode == mcaquad_mode_ieee || _IS_NOT_NORMAL_OR_SUBNORMAL(x->hi)) {
+    return;
+  }
+  if (mode == mcaquad_mode_rr && x->lo == 0 &&
+      _IS_REPRESENTABLE(x->hi, virtual_precision)) {
+    return;
+  }
+  if (sparse &&
+      _mca_skip_eval(ctx->sparsity, &rng_state, &mcaquad_global_tid)) {
+    return;
+  }
+  if (rel_err) {
+    const int32_t e_n_rel = _dd_get_exponent(*x) - (virtual_precision - 1);
+    *x = _dd_add_double(*x, _noise_dd(e_n_rel, &rng_state));
+  }
+  if (abs_err) {
+    *x = _dd_add_double(*x, _noise_dd(ctx->absErr_exp, &rng_state));
+  }
+}
+
+/* Returns true if x is zero or its exponent is handled by the engine */
+static inline bool _dd_in_range(const double x) {
+  const int32_t e = GET_EXP_FLT(x);
+  return x == 0 || (MCAQUAD_DD_EXP_MIN <= e && e <= _dd_exp_max());
+}
+
+/* Returns true if binary64 operations are computed by the double-double
+ * engine, when their operands are in range */
+static inline bool _dd_engine_enabled(const mcaquad_context_t *ctx) {
+  if (ctx->engine != mcaquad_engine_dd ||
+      ctx->binary64_precision > DOUBLE_PREC) {
+    return false;
+  }
+  return !ctx->absErr || (MCAQUAD_DD_EXP_MIN <= ctx->absErr_exp &&
+                          ctx->absErr_exp <= _dd_exp_max());
+}
+
+/* Returns true if the operands and the result of a OP b are in range */
+static inline bool _dd_binary_op_in_range(const double a, const double b,
+                                          const mca_operations op) {
+  double res = 0;
+  PERFORM_BIN_OP(op, res, a, b);
+  /* the product or the quotient of non-zero values must not underflow */
+  if (res == 0 && a != 0 &&
+      ((op == mcaquad_mul && b != 0) || op == mcaquad_div)) {
+    return false;
+  }
+  return _dd_in_range(a) && _dd_in_range(b) && _dd_in_range(res);
+}
+
+/* Returns true if the operands and the result of fma(a, b, c) are in range */
+static inline bool _dd_fma_in_range(const double a, const double b,
+                                    const double c) {
+  return _dd_binary_op_in_range(a, b, mcaquad_mul) && _dd_in_range(c) &&
+         _dd_in_range(a * b + c);
+}
+
+/* Returns mca(A OP B) for binary64 A and B, same as _MCAQUAD_BINARY_OP */
+static inline double _mcaquad_binary64_binary_op_dd(const double a,
+                                                    const double b,
+                                                    const mca_operations op,
+                                                    mcaquad_context_t *ctx,
+                                                    _MCAQUAD_SPEC_PARAMS) {
+  mcaquad_dd_t da = {a, 0};
+  mcaquad_dd_t db = {b, 0};
+  mcaquad_dd_t res = {0, 0};
+  if (daz) {
+    da.hi = DAZ(a);
+    db.hi = DAZ(b);
+  }
+  if (mode == mcaquad_mode_pb || mode == mcaquad_mode_mca) {
+    _mcaquad_inexact_dd(&da, ctx->binary64_precision, ctx,
+                        _MCAQUAD_SPEC_ARGS);
+    _mcaquad_inexact_dd(&db, ctx->binary64_precision, ctx,
+                        _MCAQUAD_SPEC_ARGS);
+  }
+  switch (op) {
+  case mcaquad_add:
+    res = _dd_add(da, db);
+    break;
+  case mcaquad_sub:
+    res = _dd_add(da, _dd_neg(db));
+    break;
+  case mcaquad_mul:
+    res = _dd_mul(da, db);
+    break;
+  case mcaquad_div:
+    res = _dd_div(da, db);
+    break;
+  default:
+    logger_error("invalid operator %c", op);
+  }
+  if (mode == mcaquad_mode_rr || mode == mcaquad_mode_mca) {
+    _mcaquad_inexact_dd(&res, ctx->binary64_precision, ctx,
+                        _MCAQUAD_SPEC_ARGS);
+  }
+  /* hi is hi + lo rounded to nearest */
+  double r = res.hi;
+  if (ftz) {
+    r = FTZ(r);
+  }
+  return r;
+}
+
+/* Returns mca(fma(A, B, C)) for binary64 A, B and C, same as
+ * _MCAQUAD_TERNARY_OP */
+static inline double _mcaquad_binary64_fma_dd(const double a, const double b,
+                                              const double c,
+                                              mcaquad_context_t *ctx,
+                                              _MCAQUAD_SPEC_PARAMS) {
+  mcaquad_dd_t da = {a, 0};
+  mcaquad_dd_t db = {b, 0};
+  mcaquad_dd_t dc = {c, 0};
+  if (daz) {
+    da.hi = DAZ(a);
+    db.hi = DAZ(b);
+    dc.hi = DAZ(c);
+  }
+  if (mode == mcaquad_mode_pb || mode == mcaquad_mode_mca) {
+    _mcaquad_inexact_dd(&da, ctx->binary64_precision, ctx,
+                        _MCAQUAD_SPEC_ARGS);
+    _mcaquad_inexact_dd(&db, ctx->binary64_precision, ctx,
+                        _MCAQUAD_SPEC_ARGS);
+    _mcaquad_inexact_dd(&dc, ctx->binary64_precision, ctx,
+                        _MCAQUAD_SPEC_ARGS);
+  }
+  mcaquad_dd_t res = _dd_add(_dd_mul(da, db), dc);
+  if (mode == mcaquad_mode_rr || mode == mcaquad_mode_mca) {
+    _mcaquad_inexact_dd(&res, ctx->binary64_precision, ctx,
+                        _MCAQUAD_SPEC_ARGS);
+  }
+  double r = res.hi;
+  if (ftz) {
+    r = FTZ(r);
+  }
+  return r;
+}
+
 /* Performs mca(dop a) where a is a binary32 value */
 /* Intermediate computations are performed with binary64 */
-inline float _mcaquad_binary32_unary_op(const float a, const mca_operations dop,
-                                        void *context) {
-  _MCAQUAD_UNARY_OP(a, dop, context, (double)0);
+static inline float _mcaquad_binary32_unary_op(const float a,
+                                               const mca_operations dop,
+                                               void *context,
+                                               _MCAQUAD_SPEC_PARAMS) {
+  _MCAQUAD_UNARY_OP(a, dop, context, (double)0, _MCAQUAD_SPEC);
 }
 
 /* Performs mca(a dop b) where a and b are binary32 values */
 /* Intermediate computations are performed with binary64 */
-float _mcaquad_binary32_binary_op(float a, float b, mca_operations dop,
-                                  void *context);
-inline float _mcaquad_binary32_binary_op(const float a, const float b,
-                                         const mca_operations dop,
-                                         void *context) {
-  _MCAQUAD_BINARY_OP(a, b, dop, context, (double)0);
+static inline float _mcaquad_binary32_binary_op(const float a, const float b,
+                                                const mca_operations dop,
+                                                void *context,
+                                                _MCAQUAD_SPEC_PARAMS) {
+  _MCAQUAD_BINARY_OP(a, b, dop, context, (double)0, _MCAQUAD_SPEC);
 }
 
 /* Performs mca(a dop b dop c) where a, b and c are binary32 values
  */
 /* Intermediate computations are performed with binary64 */
-float _mcaquad_binary32_ternary_op(float a, float b, float c,
-                                   mca_operations dop, void *context);
-inline float _mcaquad_binary32_ternary_op(const float a, const float b,
-                                          const float c,
-                                          const mca_operations dop,
-                                          void *context) {
-  _MCAQUAD_TERNARY_OP(a, b, c, dop, context, (double)0);
+static inline float _mcaquad_binary32_ternary_op(const float a, const float b,
+                                                 const float c,
+                                                 const mca_operations dop,
+                                                 void *context,
+                                                 _MCAQUAD_SPEC_PARAMS) {
+  _MCAQUAD_TERNARY_OP(a, b, c, dop, context, (double)0, _MCAQUAD_SPEC);
 }
 
 /* Performs mca(qop a) where a is a binary64 value */
 /* Intermediate computations are performed with binary128 */
-double _mcaquad_binary64_unary_op(double a, mca_operations qop, void *context);
-inline double _mcaquad_binary64_unary_op(const double a,
-                                         const mca_operations qop,
-                                         void *context) {
-  _MCAQUAD_UNARY_OP(a, qop, context, (_Float128)0);
+static inline double _mcaquad_binary64_unary_op(const double a,
+                                                const mca_operations qop,
+                                                void *context,
+                                                _MCAQUAD_SPEC_PARAMS) {
+  _MCAQUAD_UNARY_OP(a, qop, context, (_Float128)0, _MCAQUAD_SPEC);
 }
 
 /* Performs mca(a qop b) where a and b are binary64 values */
 /* Intermediate computations are performed with binary128 */
-double _mcaquad_binary64_binary_op(double a, double b, mca_operations qop,
-                                   void *context);
-inline double _mcaquad_binary64_binary_op(const double a, const double b,
-                                          const mca_operations qop,
-                                          void *context) {
-  _MCAQUAD_BINARY_OP(a, b, qop, context, (_Float128)0);
+static inline double _mcaquad_binary64_binary_op(const double a, const double b,
+                                                 const mca_operations qop,
+                                                 void *context,
+                                                 _MCAQUAD_SPEC_PARAMS) {
+  mcaquad_context_t *ctx = (mcaquad_context_t *)context;
+  if (_dd_engine_enabled(ctx) && _dd_binary_op_in_range(a, b, qop)) {
+    return _mcaquad_binary64_binary_op_dd(a, b, qop, ctx, _MCAQUAD_SPEC_ARGS);
+  }
+  _MCAQUAD_BINARY_OP(a, b, qop, context, (_Float128)0, _MCAQUAD_SPEC);
 }
 
 /* Performs mca(a qop b qop c) where a, b and c are binary64 values
  */
 /* Intermediate computations are performed with binary128 */
-double _mcaquad_binary64_ternary_op(double a, double b, double c,
-                                    mca_operations qop, void *context);
-
-inline double _mcaquad_binary64_ternary_op(const double a, const double b,
-                                           const double c,
-                                           const mca_operations qop,
-                                           void *context) {
-  _MCAQUAD_TERNARY_OP(a, b, c, qop, context, (_Float128)0);
+static inline double _mcaquad_binary64_ternary_op(const double a,
+                                                  const double b,
+                                                  const double c,
+                                                  const mca_operations qop,
+                                                  void *context,
+                                                  _MCAQUAD_SPEC_PARAMS) {
+  mcaquad_context_t *ctx = (mcaquad_context_t *)context;
+  if (qop == mcaquad_fma && _dd_engine_enabled(ctx) &&
+      _dd_fma_in_range(a, b, c)) {
+    return _mcaquad_binary64_fma_dd(a, b, c, ctx, _MCAQUAD_SPEC_ARGS);
+  }
+  _MCAQUAD_TERNARY_OP(a, b, c, qop, context, (_Float128)0, _MCAQUAD_SPEC);
 }
 
 /************************* FPHOOKS FUNCTIONS
@@ -592,57 +941,224 @@ inline double _mcaquad_binary64_ternary_op(const double a, const double b,
 
 void INTERFLOP_MCAQUAD_API(add_float)(float a, float b, float *res,
                                       void *context) {
-  *res = _mcaquad_binary32_binary_op(a, b, mcaquad_add, context);
+  *res = _mcaquad_binary32_binary_op(a, b, mcaquad_add, context,
+                                     _MCAQUAD_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAQUAD_API(sub_float)(float a, float b, float *res,
                                       void *context) {
-  *res = _mcaquad_binary32_binary_op(a, b, mcaquad_sub, context);
+  *res = _mcaquad_binary32_binary_op(a, b, mcaquad_sub, context,
+                                     _MCAQUAD_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAQUAD_API(mul_float)(float a, float b, float *res,
                                       void *context) {
-  *res = _mcaquad_binary32_binary_op(a, b, mcaquad_mul, context);
+  *res = _mcaquad_binary32_binary_op(a, b, mcaquad_mul, context,
+                                     _MCAQUAD_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAQUAD_API(div_float)(float a, float b, float *res,
                                       void *context) {
-  *res = _mcaquad_binary32_binary_op(a, b, mcaquad_div, context);
+  *res = _mcaquad_binary32_binary_op(a, b, mcaquad_div, context,
+                                     _MCAQUAD_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAQUAD_API(fma_float)(float a, float b, float c, float *res,
                                       void *context) {
-  *res = _mcaquad_binary32_ternary_op(a, b, c, mcaquad_fma, context);
+  *res = _mcaquad_binary32_ternary_op(a, b, c, mcaquad_fma, context,
+                                      _MCAQUAD_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAQUAD_API(add_double)(double a, double b, double *res,
                                        void *context) {
-  *res = _mcaquad_binary64_binary_op(a, b, mcaquad_add, context);
+  *res = _mcaquad_binary64_binary_op(a, b, mcaquad_add, context,
+                                     _MCAQUAD_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAQUAD_API(sub_double)(double a, double b, double *res,
                                        void *context) {
-  *res = _mcaquad_binary64_binary_op(a, b, mcaquad_sub, context);
+  *res = _mcaquad_binary64_binary_op(a, b, mcaquad_sub, context,
+                                     _MCAQUAD_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAQUAD_API(mul_double)(double a, double b, double *res,
                                        void *context) {
-  *res = _mcaquad_binary64_binary_op(a, b, mcaquad_mul, context);
+  *res = _mcaquad_binary64_binary_op(a, b, mcaquad_mul, context,
+                                     _MCAQUAD_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAQUAD_API(div_double)(double a, double b, double *res,
                                        void *context) {
-  *res = _mcaquad_binary64_binary_op(a, b, mcaquad_div, context);
+  *res = _mcaquad_binary64_binary_op(a, b, mcaquad_div, context,
+                                     _MCAQUAD_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAQUAD_API(fma_double)(double a, double b, double c,
                                        double *res, void *context) {
-  *res = _mcaquad_binary64_ternary_op(a, b, c, mcaquad_fma, context);
+  *res = _mcaquad_binary64_ternary_op(a, b, c, mcaquad_fma, context,
+                                      _MCAQUAD_CONTEXT_SPEC_ARGS(context));
 }
 
 void INTERFLOP_MCAQUAD_API(cast_double_to_float)(double a, float *res,
                                                  void *context) {
-  *res = _mcaquad_binary64_unary_op(a, mcaquad_cast, context);
+  *res = _mcaquad_binary64_unary_op(a, mcaquad_cast, context,
+                                    _MCAQUAD_CONTEXT_SPEC_ARGS(context));
+}
+
+/******************** SPECIALIZED FPHOOKS FUNCTIONS ********************
+ * The configuration of the operations (mode, error mode, DAZ, FTZ and
+ * sparsity) does not change after the initialization. interflop_init
+ * installs FPHOOKS functions specialized for the configuration, where the
+ * compiler can fold the configuration tests and drop the unused noise
+ * paths. The INTERFLOP_MCAQUAD_API functions above, called by name
+ * in the static backend mode, keep reading the configuration from the
+ * context.
+ **********************************************************************/
+
+/* Defines the FPHOOKS functions NAME_add_float, ... for the configuration
+ * (mode, rel_err, abs_err, daz, ftz, sparse) given in the variable
+ * arguments, and NAME_set_interface that installs them in an interface */
+#define _MCAQUAD_SPECIALIZE(NAME, ...)                                         \
+  static void NAME##_add_float(float a, float b, float *res, void *context) {  \
+    *res = _mcaquad_binary32_binary_op(a, b, mcaquad_add, context,             \
+                                       __VA_ARGS__);                           \
+  }                                                                            \
+  static void NAME##_sub_float(float a, float b, float *res, void *context) {  \
+    *res = _mcaquad_binary32_binary_op(a, b, mcaquad_sub, context,             \
+                                       __VA_ARGS__);                           \
+  }                                                                            \
+  static void NAME##_mul_float(float a, float b, float *res, void *context) {  \
+    *res = _mcaquad_binary32_binary_op(a, b, mcaquad_mul, context,             \
+                                       __VA_ARGS__);                           \
+  }                                                                            \
+  static void NAME##_div_float(float a, float b, float *res, void *context) {  \
+    *res = _mcaquad_binary32_binary_op(a, b, mcaquad_div, context,             \
+                                       __VA_ARGS__);                           \
+  }                                                                            \
+  static void NAME##_fma_float(float a, float b, float c, float *res,          \
+                               void *context) {                                \
+    *res = _mcaquad_binary32_ternary_op(a, b, c, mcaquad_fma, context,         \
+                                        __VA_ARGS__);                          \
+  }                                                                            \
+  static void NAME##_add_double(double a, double b, double *res,               \
+                                void *context) {                               \
+    *res = _mcaquad_binary64_binary_op(a, b, mcaquad_add, context,             \
+                                       __VA_ARGS__);                           \
+  }                                                                            \
+  static void NAME##_sub_double(double a, double b, double *res,               \
+                                void *context) {                               \
+    *res = _mcaquad_binary64_binary_op(a, b, mcaquad_sub, context,             \
+                                       __VA_ARGS__);                           \
+  }                                                                            \
+  static void NAME##_mul_double(double a, double b, double *res,               \
+                                void *context) {                               \
+    *res = _mcaquad_binary64_binary_op(a, b, mcaquad_mul, context,             \
+                                       __VA_ARGS__);                           \
+  }                                                                            \
+  static void NAME##_div_double(double a, double b, double *res,               \
+                                void *context) {                               \
+    *res = _mcaquad_binary64_binary_op(a, b, mcaquad_div, context,             \
+                                       __VA_ARGS__);                           \
+  }                                                                            \
+  static void NAME##_fma_double(double a, double b, double c, double *res,     \
+                                void *context) {                               \
+    *res = _mcaquad_binary64_ternary_op(a, b, c, mcaquad_fma, context,         \
+                                        __VA_ARGS__);                          \
+  }                                                                            \
+  static void NAME##_cast_double_to_float(double a, float *res,                \
+                                          void *context) {                     \
+    *res = _mcaquad_binary64_unary_op(a, mcaquad_cast, context, __VA_ARGS__);  \
+  }                                                                            \
+  static void NAME##_set_interface(                                            \
+      struct interflop_backend_interface_t *interface) {                       \
+    interface->interflop_add_float = NAME##_add_float;                         \
+    interface->interflop_sub_float = NAME##_sub_float;                         \
+    interface->interflop_mul_float = NAME##_mul_float;                         \
+    interface->interflop_div_float = NAME##_div_float;                         \
+    interface->interflop_fma_float = NAME##_fma_float;                         \
+    interface->interflop_add_double = NAME##_add_double;                       \
+    interface->interflop_sub_double = NAME##_sub_double;                       \
+    interface->interflop_mul_double = NAME##_mul_double;                       \
+    interface->interflop_div_double = NAME##_div_double;                       \
+    interface->interflop_fma_double = NAME##_fma_double;                       \
+    interface->interflop_cast_double_to_float = NAME##_cast_double_to_float;   \
+  }
+
+typedef void (*mcaquad_set_interface_t)(struct interflop_backend_interface_t *);
+
+/* Specializes the FPHOOKS functions for each DAZ and FTZ flags of the mode
+ * MODE, the error mode (REL_ERR, ABS_ERR) and the sparse flag SPARSE */
+#define _MCAQUAD_SPECIALIZE_DAZ_FTZ(NAME, MODE, REL_ERR, ABS_ERR, SPARSE)      \
+  _MCAQUAD_SPECIALIZE(NAME##_nodaz_noftz, MODE, REL_ERR, ABS_ERR, false,       \
+                      false, SPARSE)                                           \
+  _MCAQUAD_SPECIALIZE(NAME##_nodaz_ftz, MODE, REL_ERR, ABS_ERR, false, true,   \
+                      SPARSE)                                                  \
+  _MCAQUAD_SPECIALIZE(NAME##_daz_noftz, MODE, REL_ERR, ABS_ERR, true, false,   \
+                      SPARSE)                                                  \
+  _MCAQUAD_SPECIALIZE(NAME##_daz_ftz, MODE, REL_ERR, ABS_ERR, true, true,      \
+                      SPARSE)
+
+#define _MCAQUAD_SPECIALIZE_SPARSE(NAME, MODE, REL_ERR, ABS_ERR)               \
+  _MCAQUAD_SPECIALIZE_DAZ_FTZ(NAME##_dense, MODE, REL_ERR, ABS_ERR, false)     \
+  _MCAQUAD_SPECIALIZE_DAZ_FTZ(NAME##_sparse, MODE, REL_ERR, ABS_ERR, true)
+
+#define _MCAQUAD_SPECIALIZE_ERR(NAME, MODE)                                    \
+  _MCAQUAD_SPECIALIZE_SPARSE(NAME##_rel, MODE, true, false)                    \
+  _MCAQUAD_SPECIALIZE_SPARSE(NAME##_abs, MODE, false, true)                    \
+  _MCAQUAD_SPECIALIZE_SPARSE(NAME##_all, MODE, true, true)
+
+_MCAQUAD_SPECIALIZE_ERR(_mcaquad_mca, mcaquad_mode_mca)
+_MCAQUAD_SPECIALIZE_ERR(_mcaquad_pb, mcaquad_mode_pb)
+_MCAQUAD_SPECIALIZE_ERR(_mcaquad_rr, mcaquad_mode_rr)
+/* the ieee mode does not add noise, only DAZ and FTZ matter */
+_MCAQUAD_SPECIALIZE_DAZ_FTZ(_mcaquad_ieee, mcaquad_mode_ieee, false, false,
+                            false)
+
+/* Table of the specializations, indexed by the DAZ and FTZ flags */
+#define _MCAQUAD_DAZ_FTZ_TABLE(NAME)                                           \
+  {                                                                            \
+    {NAME##_nodaz_noftz_set_interface, NAME##_nodaz_ftz_set_interface},        \
+        {NAME##_daz_noftz_set_interface, NAME##_daz_ftz_set_interface},        \
+  }
+
+#define _MCAQUAD_SPARSE_TABLE(NAME)                                            \
+  {_MCAQUAD_DAZ_FTZ_TABLE(NAME##_dense), _MCAQUAD_DAZ_FTZ_TABLE(NAME##_sparse)}
+
+#define _MCAQUAD_ERR_TABLE(NAME)                                               \
+  {_MCAQUAD_SPARSE_TABLE(NAME##_rel), _MCAQUAD_SPARSE_TABLE(NAME##_abs),       \
+   _MCAQUAD_SPARSE_TABLE(NAME##_all)}
+
+/* [mode][error mode][sparse][daz][ftz], the ieee mode is handled apart */
+static const mcaquad_set_interface_t
+    _mcaquad_specializations[_mcaquad_mode_end_][_mcaquad_err_mode_end_][2][2]
+                            [2] = {
+                                [mcaquad_mode_mca] =
+                                    _MCAQUAD_ERR_TABLE(_mcaquad_mca),
+                                [mcaquad_mode_pb] =
+                                    _MCAQUAD_ERR_TABLE(_mcaquad_pb),
+                                [mcaquad_mode_rr] =
+                                    _MCAQUAD_ERR_TABLE(_mcaquad_rr),
+};
+
+static const mcaquad_set_interface_t _mcaquad_ieee_specializations[2][2] =
+    _MCAQUAD_DAZ_FTZ_TABLE(_mcaquad_ieee);
+
+/* Installs in interface the FPHOOKS functions specialized for the
+ * configuration of ctx */
+static void _mcaquad_set_specialized_interface(
+    const mcaquad_context_t *ctx,
+    struct interflop_backend_interface_t *interface) {
+  if (ctx->mode == mcaquad_mode_ieee) {
+    _mcaquad_ieee_specializations[ctx->daz][ctx->ftz](interface);
+    return;
+  }
+  const mcaquad_err_mode err_mode =
+      (ctx->relErr && ctx->absErr) ? mcaquad_err_mode_all
+      : (ctx->absErr)              ? mcaquad_err_mode_abs
+                                   : mcaquad_err_mode_rel;
+  const bool sparse = ctx->sparsity < 1.0f;
+  _mcaquad_specializations[ctx->mode][err_mode][sparse][ctx->daz][ctx->ftz](
+      interface);
 }
 
 void _interflop_usercall_inexact(void *context, va_list ap) {
@@ -733,6 +1249,7 @@ static void _mcaquad_init_context(mcaquad_context_t *ctx) {
   ctx->ftz = MCAQUAD_FTZ_DEFAULT;
   ctx->seed = MCAQUAD_SEED_DEFAULT;
   ctx->sparsity = MCAQUAD_SPARSITY_DEFAULT;
+  ctx->engine = MCAQUAD_ENGINE_DEFAULT;
 }
 
 void INTERFLOP_MCAQUAD_API(pre_init)(interflop_panic_t panic, File *stream,
@@ -768,6 +1285,10 @@ static const struct argp_option options[] = {
      "one in {sparsity} operations will be perturbed. 0 < sparsity "
      "<= 1.",
      0},
+    {key_engine_str, KEY_ENGINE, "ENGINE", 0,
+     "select the arithmetic of binary64 operations among {quad, "
+     "double-double}",
+     0},
     {0}};
 
 static error_t parse_opt(int key, char *arg, struct argp_state *state) {
@@ -878,6 +1399,20 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
     }
     _set_mcaquad_sparsity(sparsity, ctx);
     break;
+  case KEY_ENGINE:
+    /* binary64 arithmetic */
+    if (interflop_strcasecmp(MCAQUAD_ENGINE_STR[mcaquad_engine_quad], arg) ==
+        0) {
+      _set_mcaquad_engine(mcaquad_engine_quad, ctx);
+    } else if (interflop_strcasecmp(MCAQUAD_ENGINE_STR[mcaquad_engine_dd],
+                                    arg) == 0) {
+      _set_mcaquad_engine(mcaquad_engine_dd, ctx);
+    } else {
+      logger_error("--%s invalid value provided, must be one of: "
+                   "{quad, double-double}.",
+                   key_engine_str);
+    }
+    break;
   default:
     return ARGP_ERR_UNKNOWN;
   }
@@ -912,6 +1447,7 @@ void INTERFLOP_MCAQUAD_API(configure)(void *configure, void *context) {
   }
   _set_mcaquad_daz(conf->daz, ctx);
   _set_mcaquad_ftz(conf->ftz, ctx);
+  _set_mcaquad_engine(conf->engine, ctx);
 }
 
 static void print_information_header(void *context) {
@@ -935,6 +1471,7 @@ static void print_information_header(void *context) {
   logger_info("%s = %s\n", key_daz_str, ctx->daz ? "true" : "false");
   logger_info("%s = %s\n", key_ftz_str, ctx->ftz ? "true" : "false");
   logger_info("%s = %f\n", key_sparsity_str, ctx->sparsity);
+  logger_info("%s = %s\n", key_engine_str, MCAQUAD_ENGINE_STR[ctx->engine]);
   logger_info("%s = %lu%s\n", key_seed_str, ctx->seed,
               ctx->choose_seed ? " (fixed)" : "");
 }
@@ -965,6 +1502,13 @@ INTERFLOP_MCAQUAD_API(init)(void *context) {
       .interflop_finalize = NULL,
   };
 
+  _mcaquad_set_specialized_interface(ctx, &interflop_backend_mcaquad);
+
+#ifdef MCAQUAD_DD_FMA_DISPATCH
+  __builtin_cpu_init();
+  _dd_hw_fma = __builtin_cpu_supports("fma");
+#endif
+
   /* The seed for the RNG is initialized upon the first request for a
   random number */
   _init_rng_state_struct(&rng_state, ctx->choose_seed, ctx->seed, false);
@@ -982,3 +1526,6 @@ void interflop_pre_init(interflop_panic_t panic, File *stream, void **context)
 
 void interflop_cli(int argc, char **argv, void *context)
     __attribute__((weak, alias("interflop_mcaquad_cli")));
+
+int interflop_get_interface_version(void)
+    __attribute__((weak, alias("interflop_mcaquad_get_interface_version")));
@@ -33,6 +33,7 @@
 #define MCAQUAD_ABSOLUTE_ERROR_EXPONENT_DEFAULT 112 // Why 112?
 #define MCAQUAD_DAZ_DEFAULT IFalse
 #define MCAQUAD_FTZ_DEFAULT IFalse
+#define MCAQUAD_ENGINE_DEFAULT mcaquad_engine_quad
 
 /* define the available MCA modes of operation */
 typedef enum {
@@ -51,6 +52,13 @@ typedef enum {
   _mcaquad_err_mode_end_
 } mcaquad_err_mode;
 
+/* define the available engines for binary64 operations */
+typedef enum {
+  mcaquad_engine_quad,
+  mcaquad_engine_dd,
+  _mcaquad_engine_end_
+} mcaquad_engine;
+
 /* Interflop context */
 typedef struct {
   IUint64_t seed;
@@ -64,6 +72,7 @@ typedef struct {
   IBool ftz;
   IBool choose_seed;
   mcaquad_mode mode;
+  mcaquad_engine engine;
 } mcaquad_context_t;
 
 typedef struct {
@@ -76,6 +85,7 @@ typedef struct {
   IInt64_t max_abs_err_exponent;
   IUint32_t daz;
   IUint32_t ftz;
+  mcaquad_engine engine;
 } mcaquad_conf_t;
 
 const char *get_mcaquad_mode_name(mcaquad_mode mode);
@@ -110,6 +120,7 @@ void INTERFLOP_MCAQUAD_API(user_call)(void *context, interflop_call_id id,
 
 const char *INTERFLOP_MCAQUAD_API(get_backend_name)(void);
 const char *INTERFLOP_MCAQUAD_API(get_backend_version)(void);
+int INTERFLOP_MCAQUAD_API(get_interface_version)(void);
 void INTERFLOP_MCAQUAD_API(pre_init)(interflop_panic_t panic, File *stream,
                                      void **context);
 void INTERFLOP_MCAQUAD_API(cli)(int argc, char **argv, void *context);
@@ -52,6 +52,8 @@ static const char key_err_mode_str[] = "error-mode";
 static const char key_err_exp_str[] = "max-abs-error-exponent";
 static const char key_daz_str[] = "daz";
 static const char key_ftz_str[] = "ftz";
+static const char key_shadow_str[] = "shadow";
+static const char key_shadow_output_file_str[] = "shadow-output-file";
 
 /* variables that control precision, range and mode */
 
@@ -568,6 +570,7 @@ static inline float _vprec_binary32_binary_op(float a, float b,
                                               void *context) {
   vprec_context_t *ctx = (vprec_context_t *)context;
   float res = 0;
+  const float a0 = a, b0 = b;
 
   logger_debug("[Inputs] binary32: a=%+.6a b=%+.6a op=%c\n", a, b, op);
 
@@ -588,6 +591,10 @@ static inline float _vprec_binary32_binary_op(float a, float b,
     logger_debug("[Round ] binary32: res=%+.6a\n", res);
   }
 
+  if (ctx->shadow->mode != vprec_shadow_none) {
+    _vprec_shadow_binary32_op(a0, b0, 0, res, op, context);
+  }
+
   return res;
 }
 
@@ -596,6 +603,7 @@ static inline double _vprec_binary64_binary_op(double a, double b,
                                                void *context) {
   vprec_context_t *ctx = (vprec_context_t *)context;
   double res = 0;
+  const double a0 = a, b0 = b;
   logger_debug("[Inputs] binary64: a=%+.13a b=%+.13a op=%c\n", a, b, op);
 
   if ((ctx->mode == vprecmode_full) || (ctx->mode == vprecmode_ib)) {
@@ -615,6 +623,10 @@ static inline double _vprec_binary64_binary_op(double a, double b,
     logger_debug("[Round ] binary64: res=%+.13a\n", res);
   }
 
+  if (ctx->shadow->mode != vprec_shadow_none) {
+    _vprec_shadow_binary64_op(a0, b0, 0, res, op, context);
+  }
+
   return res;
 }
 
@@ -624,6 +636,7 @@ static inline float _vprec_binary32_ternary_op(float a, float b, float c,
 
   vprec_context_t *ctx = (vprec_context_t *)context;
   float res = 0;
+  const float a0 = a, b0 = b, c0 = c;
   if (ctx->mode == vprecmode_ib || ctx->mode == vprecmode_full) {
     a = _vprec_round_binary32(a, 1, context, ctx->binary32_range,
                               ctx->binary32_precision);
@@ -640,6 +653,10 @@ static inline float _vprec_binary32_ternary_op(float a, float b, float c,
                                 ctx->binary32_precision);
   }
 
+  if (ctx->shadow->mode != vprec_shadow_none) {
+    _vprec_shadow_binary32_op(a0, b0, c0, res, op, context);
+  }
+
   return res;
 }
 
@@ -648,6 +665,7 @@ static inline double _vprec_binary64_ternary_op(double a, double b, double c,
                                                 void *context) {
   vprec_context_t *ctx = (vprec_context_t *)context;
   double res = 0;
+  const double a0 = a, b0 = b, c0 = c;
   if (ctx->mode == vprecmode_ib || ctx->mode == vprecmode_full) {
     a = _vprec_round_binary64(a, 1, context, ctx->binary64_range,
                               ctx->binary64_precision);
@@ -664,6 +682,10 @@ static inline double _vprec_binary64_ternary_op(double a, double b, double c,
                                 ctx->binary64_precision);
   }
 
+  if (ctx->shadow->mode != vprec_shadow_none) {
+    _vprec_shadow_binary64_op(a0, b0, c0, res, op, context);
+  }
+
   return res;
 }
 
@@ -726,8 +748,7 @@ void INTERFLOP_VPREC_API(div_double)(double a, double b, double *c,
 }
 #define MACROMIN(a, b) ((a) < (b) ? (a) : (b))
 
-void INTERFLOP_VPREC_API(cast_double_to_float)(double a, float *b,
-                                               void *context) {
+static void _vprec_cast_double_to_float(double a, float *b, void *context) {
   vprec_context_t *ctx = (vprec_context_t *)context;
   if ((ctx->mode == vprecmode_ieee)) {
     *b = (float)a;
@@ -758,6 +779,15 @@ void INTERFLOP_VPREC_API(cast_double_to_float)(double a, float *b,
   }
 }
 
+void INTERFLOP_VPREC_API(cast_double_to_float)(double a, float *b,
+                                               void *context) {
+  vprec_context_t *ctx = (vprec_context_t *)context;
+  _vprec_cast_double_to_float(a, b, context);
+  if (ctx->shadow->mode != vprec_shadow_none) {
+    _vprec_shadow_cast_double_to_float(a, *b, context);
+  }
+}
+
 void INTERFLOP_VPREC_API(fma_float)(float a, float b, float c, float *res,
                                     void *context) {
   *res = _vprec_binary32_ternary_op(a, b, c, vprec_fma, context);
@@ -793,6 +823,7 @@ void INTERFLOP_VPREC_API(user_call)(void *context, interflop_call_id id,
 void INTERFLOP_VPREC_API(finalize)(void *context) {
   vprec_context_t *ctx = (vprec_context_t *)context;
   _vfi_finalize(ctx);
+  _vprec_shadow_finalize(ctx);
 }
 
 const char *INTERFLOP_VPREC_API(get_backend_name)(void) { return backend_name; }
@@ -801,6 +832,10 @@ const char *INTERFLOP_VPREC_API(get_backend_version)(void) {
   return backend_version;
 }
 
+int INTERFLOP_VPREC_API(get_interface_version)(void) {
+  return INTERFLOP_INTERFACE_VERSION;
+}
+
 void _vprec_check_stdlib() {
   INTERFLOP_CHECK_IMPL(calloc);
   INTERFLOP_CHECK_IMPL(exit);
@@ -829,6 +864,7 @@ void _vprec_alloc_context(void **context) {
   vprec_context_t *ctx =
       (vprec_context_t *)interflop_malloc(sizeof(vprec_context_t));
   _vfi_alloc_context(ctx);
+  _vprec_shadow_alloc_context(ctx);
   *context = ctx;
 }
 
@@ -845,6 +881,7 @@ static void _vprec_init_context(vprec_context_t *ctx) {
   ctx->daz = false;
   ctx->ftz = false;
   _vfi_init_context(ctx);
+  _vprec_shadow_init_context(ctx);
 }
 
 void INTERFLOP_VPREC_API(pre_init)(interflop_panic_t panic, File *stream,
@@ -888,6 +925,12 @@ static const struct argp_option options[] = {
      "denormals-are-zero: sets denormals inputs to zero", 0},
     {key_ftz_str, KEY_FTZ, 0, 0, "flush-to-zero: sets denormal output to zero",
      0},
+    {key_shadow_str, KEY_SHADOW, "SHADOW", 0,
+     "compute each operation in IEEE SHADOW format among {none, binary64, "
+     "binary128} and report the deviation per call site",
+     0},
+    {key_shadow_output_file_str, KEY_SHADOW_OUTPUT_FILE, "FILE", 0,
+     "write the shadow deviation report to FILE", 0},
     {0}};
 
 static error_t parse_opt(int key, char *arg, struct argp_state *state) {
@@ -1016,6 +1059,29 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
     /* flush-to-zero */
     _set_vprec_ftz(true, ctx);
     break;
+  case KEY_SHADOW:
+    /* shadow mode */
+    if (interflop_strcasecmp(
+            get_vprec_shadow_mode_name(vprec_shadow_none), arg) == 0) {
+      _set_vprec_shadow_mode(vprec_shadow_none, ctx);
+    } else if (interflop_strcasecmp(
+                   get_vprec_shadow_mode_name(vprec_shadow_binary64), arg) ==
+               0) {
+      _set_vprec_shadow_mode(vprec_shadow_binary64, ctx);
+    } else if (interflop_strcasecmp(
+                   get_vprec_shadow_mode_name(vprec_shadow_binary128), arg) ==
+               0) {
+      _set_vprec_shadow_mode(vprec_shadow_binary128, ctx);
+    } else {
+      logger_error("--%s invalid value provided, must be one of: "
+                   "{none, binary64, binary128}.",
+                   key_shadow_str);
+    }
+    break;
+  case KEY_SHADOW_OUTPUT_FILE:
+    /* shadow report file */
+    _set_vprec_shadow_output_file(arg, ctx);
+    break;
   case KEY_PRESET:
     /* preset */
     if (interflop_strcmp(VPREC_PRESET_STR[vprec_preset_binary16], arg) == 0) {
@@ -1109,6 +1175,10 @@ void INTERFLOP_VPREC_API(configure)(void *configure, void *context) {
   if (conf->ftz) {
     _set_vprec_ftz(context, ctx);
   }
+  _set_vprec_shadow_mode(conf->shadow, ctx);
+  if (conf->shadow_output_file != NULL) {
+    _set_vprec_shadow_output_file(conf->shadow_output_file, ctx);
+  }
 }
 
 static void print_information_header(void *context) {
@@ -1135,6 +1205,8 @@ static void print_information_header(void *context) {
   logger_info("%s = %d\n", key_err_exp_str, ctx->absErr_exp);
   logger_info("%s = %s\n", key_daz_str, ctx->daz ? "true" : "false");
   logger_info("%s = %s\n", key_ftz_str, ctx->ftz ? "true" : "false");
+  logger_info("%s = %s\n", key_shadow_str,
+              get_vprec_shadow_mode_name(ctx->shadow->mode));
   _vfi_print_information_header(context);
 }
 
@@ -1178,3 +1250,6 @@ void interflop_pre_init(interflop_panic_t panic, File *stream, void **context)
 
 void interflop_cli(int argc, char **argv, void *context)
     __attribute__((weak, alias("interflop_vprec_cli")));
+
+int interflop_get_interface_version(void)
+    __attribute__((weak, alias("interflop_vprec_get_interface_version")));
@@ -24,6 +24,7 @@
 #include "interflop/common/float_const.h"
 #include "interflop/iostream/logger.h"
 #include "interflop_vprec_function_instrumentation.h"
+#include "interflop_vprec_shadow.h"
 
 #define INTERFLOP_VPREC_API(name) interflop_vprec_##name
 
@@ -61,6 +62,8 @@ typedef enum {
   KEY_OUTPUT_FILE,
   KEY_LOG_FILE,
   KEY_PRESET,
+  KEY_SHADOW,
+  KEY_SHADOW_OUTPUT_FILE,
   KEY_MODE = 'm',
   KEY_ERR_MODE = 'e',
   KEY_INSTRUMENT = 'i',
@@ -129,6 +132,8 @@ typedef enum {
 typedef struct {
   /* structure holding vprec function instrumentation variables */
   t_context_vfi *vfi;
+  /* structure holding vprec shadow mode variables */
+  t_context_shadow *shadow;
   /* arithmetic variables */
   int binary32_precision;
   int binary32_range;
@@ -153,6 +158,8 @@ typedef struct {
   long max_abs_err_exponent;
   unsigned int daz;
   unsigned int ftz;
+  vprec_shadow_mode shadow;
+  const char *shadow_output_file;
 } vprec_conf_t;
 
 void _set_vprec_precision_binary32(int precision, vprec_context_t *ctx);
@@ -204,6 +211,7 @@ void INTERFLOP_VPREC_API(finalize)(void *context);
 
 const char *INTERFLOP_VPREC_API(get_backend_name)(void);
 const char *INTERFLOP_VPREC_API(get_backend_version)(void);
+int INTERFLOP_VPREC_API(get_interface_version)(void);
 void INTERFLOP_VPREC_API(pre_init)(interflop_panic_t panic, File *stream,
                                    void **context);
 void INTERFLOP_VPREC_API(cli)(int argc, char **argv, void *context);
@@ -0,0 +1,276 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *                                                                           *\
+ *  Copyright (c) 2026                                                       *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+// VPREC shadow mode
+//
+// Each instrumented operation is also computed in IEEE binary64 or binary128
+// from the original operands. The relative deviation between the VPREC result
+// and this shadow value is accumulated per call site (the return address of
+// the instrumented operation) in per-thread tables that are merged at
+// finalization into a report ranked by maximum deviation.
+
+#include "interflop/fma/interflop_fma.h"
+#include "interflop/hashmap/vfc_call_sites.h"
+#include "interflop/interflop.h"
+#include "interflop/interflop_stdlib.h"
+#include "interflop/iostream/logger.h"
+#include "interflop_vprec.h"
+#include "interflop_vprec_shadow.h"
+
+/* operation code used for the double to float cast */
+#define VPREC_SHADOW_CAST 'c'
+
+static const char *const VPREC_SHADOW_MODE_STR[] = {
+    [vprec_shadow_none] = "none",
+    [vprec_shadow_binary64] = "binary64",
+    [vprec_shadow_binary128] = "binary128"};
+
+/* table of the current thread */
+static __thread vfc_call_site_cache_t _vprec_shadow_cache = {Null, 0, Null};
+
+const char *get_vprec_shadow_mode_name(vprec_shadow_mode mode) {
+  if (mode >= _vprec_shadow_end_) {
+    return Null;
+  }
+  return VPREC_SHADOW_MODE_STR[mode];
+}
+
+void _set_vprec_shadow_mode(vprec_shadow_mode mode, void *context) {
+  vprec_context_t *ctx = (vprec_context_t *)context;
+  if (mode >= _vprec_shadow_end_) {
+    logger_error("invalid shadow mode provided, must be one of: "
+                 "{none, binary64, binary128}.");
+  } else {
+    ctx->shadow->mode = mode;
+  }
+}
+
+void _set_vprec_shadow_output_file(const char *output_file, void *context) {
+  vprec_context_t *ctx = (vprec_context_t *)context;
+  ctx->shadow->output_file = output_file;
+}
+
+void _vprec_shadow_alloc_context(void *context) {
+  vprec_context_t *ctx = (vprec_context_t *)context;
+  ctx->shadow = (t_context_shadow *)interflop_malloc(sizeof(t_context_shadow));
+}
+
+static void _merge_site(void *dst, const void *src) {
+  _vprec_shadow_site_t *d = (_vprec_shadow_site_t *)dst;
+  const _vprec_shadow_site_t *s = (const _vprec_shadow_site_t *)src;
+  d->op = s->op;
+  d->type = s->type;
+  d->site.count += s->site.count;
+  d->sum_rel_dev += s->sum_rel_dev;
+  if (s->max_rel_dev > d->max_rel_dev) {
+    d->max_rel_dev = s->max_rel_dev;
+  }
+}
+
+void _vprec_shadow_init_context(void *context) {
+  vprec_context_t *ctx = (vprec_context_t *)context;
+  ctx->shadow->mode = VPREC_SHADOW_MODE_DEFAULT;
+  ctx->shadow->output_file = Null;
+  vfc_call_sites_init(&ctx->shadow->sites, sizeof(_vprec_shadow_site_t),
+                      _merge_site);
+}
+
+static void _record(void *context, char op, char type, double rel_dev) {
+  vprec_context_t *ctx = (vprec_context_t *)context;
+  _vprec_shadow_site_t *site = (_vprec_shadow_site_t *)vfc_call_sites_get(
+      &ctx->shadow->sites, &_vprec_shadow_cache, interflop_call_site);
+  if (site == Null) {
+    return;
+  }
+  site->op = op;
+  site->type = type;
+  site->site.count++;
+  site->sum_rel_dev += rel_dev;
+  if (rel_dev > site->max_rel_dev) {
+    site->max_rel_dev = rel_dev;
+  }
+}
+
+/* Relative deviation of <res> to the shadow value <ref>. Operations whose
+ * reference is not finite are not meaningful and return -1. When the
+ * reference is zero, the absolute deviation is used. */
+#define DEFINE_REL_DEV(NAME, TYPE)                                             \
+  static inline double NAME(TYPE res, TYPE ref) {                              \
+    if (ref != ref || ref - ref != 0) {                                        \
+      return -1;                                                               \
+    }                                                                          \
+    if (res != res || res - res != 0) {                                        \
+      return __builtin_inf();                                                  \
+    }                                                                          \
+    TYPE dev = (res > ref) ? res - ref : ref - res;                            \
+    if (ref != 0) {                                                            \
+      dev /= (ref > 0) ? ref : -ref;                                           \
+    }                                                                          \
+    return (double)dev;                                                        \
+  }
+
+DEFINE_REL_DEV(_rel_dev_binary64, double)
+DEFINE_REL_DEV(_rel_dev_binary128, _Float128)
+
+#define PERFORM_SHADOW_OP(op, res, a, b, c)                                    \
+  switch (op) {                                                                \
+  case vprec_add:                                                              \
+    (res) = (a) + (b);                                                         \
+    break;                                                                     \
+  case vprec_sub:                                                              \
+    (res) = (a) - (b);                                                         \
+    break;                                                                     \
+  case vprec_mul:                                                              \
+    (res) = (a) * (b);                                                         \
+    break;                                                                     \
+  case vprec_div:                                                              \
+    (res) = (a) / (b);                                                         \
+    break;                                                                     \
+  case vprec_fma:                                                              \
+    (res) = _Generic((a),                                                      \
+        double: interflop_fma_binary64,                                        \
+        _Float128: interflop_fma_binary128)((a), (b), (c));                    \
+    break;                                                                     \
+  default:                                                                     \
+    logger_error("invalid operator %c", op);                                   \
+  };
+
+static void _record_binary64(double a, double b, double c, double res,
+                             char op, char type, void *context) {
+  vprec_context_t *ctx = (vprec_context_t *)context;
+  double rel_dev = 0;
+
+  if (ctx->shadow->mode == vprec_shadow_binary128) {
+    _Float128 ref = 0;
+    PERFORM_SHADOW_OP(op, ref, (_Float128)a, (_Float128)b, (_Float128)c);
+    rel_dev = _rel_dev_binary128((_Float128)res, ref);
+  } else {
+    double ref = 0;
+    PERFORM_SHADOW_OP(op, ref, a, b, c);
+    rel_dev = _rel_dev_binary64(res, ref);
+  }
+
+  if (rel_dev >= 0) {
+    _record(context, op, type, rel_dev);
+  }
+}
+
+void _vprec_shadow_binary32_op(float a, float b, float c, float res, char op,
+                               void *context) {
+  /* the binary64 result is rounded too, but its relative error (at most
+   * 2^-53) is negligible against the binary32 rounding errors (up to 2^-24):
+   * it is an accurate enough reference for binary32 */
+  _record_binary64(a, b, c, res, op, FFLOAT, context);
+}
+
+void _vprec_shadow_binary64_op(double a, double b, double c, double res,
+                               char op, void *context) {
+  _record_binary64(a, b, c, res, op, FDOUBLE, context);
+}
+
+void _vprec_shadow_cast_double_to_float(double a, float res, void *context) {
+  double rel_dev = _rel_dev_binary64(res, a);
+  if (rel_dev >= 0) {
+    _record(context, VPREC_SHADOW_CAST, FDOUBLE, rel_dev);
+  }
+}
+
+/* Returns true if <a> must be ranked before <b> */
+static IBool _ranks_before(const void *site_a, const void *site_b) {
+  const _vprec_shadow_site_t *a = (const _vprec_shadow_site_t *)site_a;
+  const _vprec_shadow_site_t *b = (const _vprec_shadow_site_t *)site_b;
+  if (a->max_rel_dev != b->max_rel_dev) {
+    return a->max_rel_dev > b->max_rel_dev;
+  }
+  return a->sum_rel_dev / a->site.count > b->sum_rel_dev / b->site.count;
+}
+
+static const char *_op_str(char op) {
+  switch (op) {
+  case vprec_add:
+    return "add";
+  case vprec_sub:
+    return "sub";
+  case vprec_mul:
+    return "mul";
+  case vprec_div:
+    return "div";
+  case vprec_fma:
+    return "fma";
+  case VPREC_SHADOW_CAST:
+    return "cast";
+  default:
+    return "unknown";
+  }
+}
+
+static void _write_report(File *f, t_context_shadow *shadow,
+                          _vprec_shadow_site_t **sites, ISize_t n) {
+  interflop_fprintf(f, "# VPREC shadow report (reference: %s)\n",
+                    VPREC_SHADOW_MODE_STR[shadow->mode]);
+  interflop_fprintf(f, "# rank\tcall_site\tobject\toffset\ttype\top\t"
+                       "count\tmax_rel_dev\tmean_rel_dev\n");
+  for (ISize_t i = 0; i < n; i++) {
+    _vprec_shadow_site_t *site = sites[i];
+    const char *object = Null;
+    const ISize_t offset = vfc_call_site_object(site->site.call_site, &object);
+    interflop_fprintf(f, "%lu\t%p\t%s\t0x%lx\t%s\t%s\t%lu\t%.6e\t%.6e\n",
+                      i + 1, site->site.call_site,
+                      (object != Null) ? object : "??", offset,
+                      (site->type == FFLOAT) ? "binary32" : "binary64",
+                      _op_str(site->op), site->site.count, site->max_rel_dev,
+                      site->sum_rel_dev / site->site.count);
+  }
+}
+
+void _vprec_shadow_finalize(void *context) {
+  vprec_context_t *ctx = (vprec_context_t *)context;
+  t_context_shadow *shadow = ctx->shadow;
+
+  if (shadow->mode == vprec_shadow_none) {
+    return;
+  }
+
+  /* sites ranked by decreasing maximum deviation */
+  ISize_t n = 0;
+  _vprec_shadow_site_t **sites = (_vprec_shadow_site_t **)vfc_call_sites_merge(
+      &shadow->sites, _ranks_before, &n);
+
+  if (shadow->output_file != Null) {
+    int error = 0;
+    File *f = interflop_fopen(shadow->output_file, "w", &error);
+    if (f != Null) {
+      _write_report(f, shadow, sites, n);
+      interflop_fclose(f);
+    } else {
+      logger_error("Shadow output file can't be written: %s",
+                   interflop_strerror(error));
+    }
+  } else {
+    logger_info("shadow deviation per call site:\n");
+    for (ISize_t i = 0; i < n; i++) {
+      const char *object = Null;
+      const ISize_t offset =
+          vfc_call_site_object(sites[i]->site.call_site, &object);
+      logger_info("%p %s+0x%lx %s %s count=%lu max=%.6e mean=%.6e\n",
+                  sites[i]->site.call_site, (object != Null) ? object : "??",
+                  offset,
+                  (sites[i]->type == FFLOAT) ? "binary32" : "binary64",
+                  _op_str(sites[i]->op), sites[i]->site.count,
+                  sites[i]->max_rel_dev,
+                  sites[i]->sum_rel_dev / sites[i]->site.count);
+    }
+  }
+
+  vfc_call_sites_free_merged((void **)sites, n);
+  vfc_call_sites_finalize(&shadow->sites);
+}
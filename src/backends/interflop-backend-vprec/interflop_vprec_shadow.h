@@ -0,0 +1,72 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *                                                                           *\
+ *  Copyright (c) 2026                                                       *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+
+#ifndef __INTERFLOP_VPREC_SHADOW_H__
+#define __INTERFLOP_VPREC_SHADOW_H__
+
+#include "interflop/hashmap/vfc_call_sites.h"
+#include "interflop/interflop.h"
+#include "interflop/interflop_stdlib.h"
+
+/* define the shadow modes: the format in which the IEEE reference of each
+ * operation is computed */
+typedef enum {
+  vprec_shadow_none,
+  vprec_shadow_binary64,
+  vprec_shadow_binary128,
+  _vprec_shadow_end_
+} vprec_shadow_mode;
+
+/* default shadow mode */
+#define VPREC_SHADOW_MODE_DEFAULT vprec_shadow_none
+
+/* Deviation statistics of one call site */
+typedef struct _vprec_shadow_site {
+  /* call site and number of executions */
+  vfc_call_site_t site;
+  /* operation (vprec_operation) and type of the operands (FFLOAT, FDOUBLE) */
+  char op;
+  char type;
+  /* sum and maximum of the relative deviations to the shadow value */
+  double sum_rel_dev;
+  double max_rel_dev;
+} _vprec_shadow_site_t;
+
+typedef struct {
+  vprec_shadow_mode mode;
+  const char *output_file;
+  /* per-thread call-site tables */
+  vfc_call_sites_t sites;
+} t_context_shadow;
+
+const char *get_vprec_shadow_mode_name(vprec_shadow_mode mode);
+void _set_vprec_shadow_mode(vprec_shadow_mode mode, void *context);
+void _set_vprec_shadow_output_file(const char *output_file, void *context);
+
+/* Shadow context allocator and initializer */
+void _vprec_shadow_alloc_context(void *context);
+void _vprec_shadow_init_context(void *context);
+
+/* Record the deviation of the VPREC result <res> of the operation <op> on
+ * <a>, <b> and <c> (c is only used by fma) to the shadow result */
+void _vprec_shadow_binary32_op(float a, float b, float c, float res,
+                               char op, void *context);
+void _vprec_shadow_binary64_op(double a, double b, double c, double res,
+                               char op, void *context);
+void _vprec_shadow_cast_double_to_float(double a, float res, void *context);
+
+/* Merge the per-thread tables, write the ranked report and free the
+ * tables */
+void _vprec_shadow_finalize(void *context);
+
+#endif /* __INTERFLOP_VPREC_SHADOW_H__ */
@@ -64,9 +64,37 @@
     T = PRECISION;                                                             \
   }
 
+/* Natural logarithm of x > 0 (relative error below 1e-9), used to draw */
+/* the sparsity skip counts without linking the backends with libm */
+__attribute__((unused)) static double _mca_log(const double x) {
+  union {
+    double d;
+    uint64_t u;
+  } m = {.d = x};
+  int32_t e = (int32_t)((m.u >> 52) & 0x7ff) - 1023;
+  /* x = m * 2^e with m in [sqrt(2)/2, sqrt(2)) */
+  m.u = (m.u & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+  if (m.d > 0x1.6a09e667f3bcdp+0) {
+    m.d *= 0.5;
+    e++;
+  }
+  /* log(m) = 2 atanh(s) with s = (m - 1) / (m + 1), |s| < 0.172 */
+  const double s = (m.d - 1.0) / (m.d + 1.0);
+  const double s2 = s * s;
+  const double log_m =
+      2.0 * s *
+      (1.0 +
+       s2 * (1.0 / 3 +
+             s2 * (1.0 / 5 + s2 * (1.0 / 7 + s2 * (1.0 / 9 + s2 / 11)))));
+  return e * 0x1.62e42fefa39efp-1 + log_m;
+}
+
 /* Returns a bool for determining whether an operation should skip */
 /* perturbation. false -> perturb; true -> skip. */
-/* e.g. for sparsity=0.1, all random values > 0.1 = true -> no MCA*/
+/* Each call is a Bernoulli trial of probability sparsity. Instead of */
+/* drawing a random number per call, the number of skipped calls before the */
+/* next perturbed one is drawn from the geometric distribution, and counted */
+/* down in rng_state: the RNG is only used once per perturbed operation. */
 /* @param sparsity sparsity */
 /* @param rng_state pointer to the structure holding all the RNG-related data */
 /* @return false -> perturb; true -> skip */
@@ -77,7 +105,16 @@ __attribute__((unused)) static bool _mca_skip_eval(const float sparsity,
     return false;
   }
 
-  return (get_rand_double01(rng_state, global_tid) > sparsity);
+  if (rng_state->sparsity_countdown == 0) {
+    /* P(skip = k) = (1 - sparsity)^k * sparsity */
+    const double u = get_rand_double01(rng_state, global_tid);
+    const double skip = _mca_log(u) / _mca_log(1.0 - (double)sparsity);
+    rng_state->sparsity_countdown =
+        (skip < 0x1p62) ? (uint64_t)skip + 1 : (1ULL << 62);
+  }
+
+  rng_state->sparsity_countdown--;
+  return rng_state->sparsity_countdown > 0;
 }
 
 #endif /* __OPTIONS_H__ */
@@ -10,6 +10,8 @@
  *                                                                           *\
  ****************************************************************************/
 
+#include <stdint.h>
+
 #include "interflop_fma.h"
 #include "pfp128.h"
 
@@ -21,7 +23,158 @@ double interflop_fma_binary64(double a, double b, double c) {
   return __builtin_fma(a, b, c);
 }
 
+#ifdef __SIZEOF_INT128__
+
+typedef unsigned __int128 uint128_t;
+
+/* binary128 encoding */
+#define B128_PMAN_SIZE 112
+#define B128_EXP_COMP 16383
+#define B128_EXP_MASK 0x7FFF
+/* binary64 values have 52 significant fraction bits, the 60 low fraction bits
+ * of their binary128 encoding are zero */
+#define B128_B64_LOW_BITS 60
+#define B128_B64_EXP_MIN (B128_EXP_COMP - 1022)
+#define B128_B64_EXP_MAX (B128_EXP_COMP + 1023)
+
+typedef union {
+  _Float128 f128;
+  uint128_t u128;
+} b128_bits_t;
+
+/* Returns the number of leading zeros of x != 0 */
+static inline int _clz128(const uint128_t x) {
+  const uint64_t hi = (uint64_t)(x >> 64);
+  return (hi != 0) ? __builtin_clzll(hi)
+                   : 64 + __builtin_clzll((uint64_t)x);
+}
+
+/* Splits x into its sign, its 53-bit significand and its unbiased exponent.
+ * Returns 0 if x is not a normal binary64, the outputs are then not set. */
+static inline int _split_binary64(const uint128_t x, uint64_t *sign,
+                                  uint64_t *mant, int *exp) {
+  const int e = (int)(x >> B128_PMAN_SIZE) & B128_EXP_MASK;
+  const uint128_t low = ((uint128_t)1 << B128_B64_LOW_BITS) - 1;
+  if (e < B128_B64_EXP_MIN || e > B128_B64_EXP_MAX || (x & low) != 0) {
+    return 0;
+  }
+  *sign = (uint64_t)(x >> 127);
+  *mant = ((uint64_t)1 << 52) |
+          ((uint64_t)(x >> B128_B64_LOW_BITS) & (((uint64_t)1 << 52) - 1));
+  *exp = e - B128_EXP_COMP;
+  return 1;
+}
+
+/* Correctly rounded a * b + c for normal binary64 values a, b and c encoded
+ * in binary128, computed with integer arithmetic instead of the software
+ * binary128 operations. The 106-bit product of the significands is exact,
+ * the sum is exact as long as its alignment shift does not drop non-zero
+ * bits, otherwise the dropped bits are kept as a sticky bit. Binary128 has
+ * the range to represent the exact result of binary64 operands, so the result
+ * is never subnormal nor infinite. Returns 0 if an operand is not a normal
+ * binary64. */
+static inline int _fma_binary64_in_binary128(const uint128_t a,
+                                             const uint128_t b,
+                                             const uint128_t c,
+                                             uint128_t *res) {
+  uint64_t sa, sb, sc, ma, mb, mc;
+  int ea, eb, ec;
+  if (!_split_binary64(a, &sa, &ma, &ea)) {
+    return 0;
+  }
+  if (!_split_binary64(b, &sb, &mb, &eb)) {
+    return 0;
+  }
+  if (!_split_binary64(c, &sc, &mc, &ec)) {
+    return 0;
+  }
+
+  /* Both terms are normalized with their leading bit at bit 125, which leaves
+   * room for the carry of the sum. x = X * 2^qx */
+  uint128_t p = (uint128_t)ma * mb;
+  const int shift_p = _clz128(p) - 2;
+  p <<= shift_p;
+  int qp = ea + eb - 104 - shift_p;
+  uint64_t sp = sa ^ sb;
+  uint128_t q = (uint128_t)mc << 73;
+  int qc = ec - 52 - 73;
+
+  /* x is the term with the largest exponent */
+  uint128_t x = p, y = q;
+  int qx = qp, qy = qc;
+  uint64_t sx = sp, sy = sc;
+  if (qc > qp) {
+    x = q, y = p, qx = qc, qy = qp, sx = sc, sy = sp;
+  }
+
+  /* Align y on x. The low bits of both terms are zero, so the shift is exact
+   * when the terms are close, and the sum cancels at most one bit otherwise:
+   * dropped bits only need to be kept as a sticky bit. */
+  const int d = qx - qy;
+  if (d >= 128) {
+    y = 1;
+  } else if (d > 0) {
+    const uint128_t sticky = (y << (128 - d)) != 0;
+    y = (y >> d) | sticky;
+  }
+
+  uint128_t s;
+  uint64_t sign = sx;
+  if (sx == sy) {
+    s = x + y;
+  } else if (x >= y) {
+    s = x - y;
+  } else {
+    s = y - x;
+    sign = sy;
+  }
+  if (s == 0) {
+    /* exact cancellation gives +0 in round to nearest */
+    *res = 0;
+    return 1;
+  }
+
+  /* Round to nearest even on 113 bits */
+  const int msb = 127 - _clz128(s);
+  int exp = msb + qx;
+  uint128_t mant;
+  if (msb > B128_PMAN_SIZE) {
+    const int shift = msb - B128_PMAN_SIZE;
+    const uint128_t rem = s & (((uint128_t)1 << shift) - 1);
+    const uint128_t half = (uint128_t)1 << (shift - 1);
+    mant = s >> shift;
+    if (rem > half || (rem == half && (mant & 1))) {
+      mant++;
+      if (mant >> (B128_PMAN_SIZE + 1)) {
+        mant >>= 1;
+        exp++;
+      }
+    }
+  } else {
+    mant = s << (B128_PMAN_SIZE - msb);
+  }
+
+  *res = ((uint128_t)sign << 127) |
+         ((uint128_t)(exp + B128_EXP_COMP) << B128_PMAN_SIZE) |
+         (mant & (((uint128_t)1 << B128_PMAN_SIZE) - 1));
+  return 1;
+}
+
+#endif /* __SIZEOF_INT128__ */
+
+/* Binary64 FMAs computed in binary128 by the backends have binary64 operands
+ * (without inbound perturbation), their result is computed without the
+ * software binary128 FMA */
 _Float128 interflop_fma_binary128(_Float128 a, _Float128 b, _Float128 c) {
+#ifdef __SIZEOF_INT128__
+  b128_bits_t res;
+  if (_fma_binary64_in_binary128(((b128_bits_t){.f128 = a}).u128,
+                                 ((b128_bits_t){.f128 = b}).u128,
+                                 ((b128_bits_t){.f128 = c}).u128,
+                                 &res.u128)) {
+    return res.f128;
+  }
+#endif
 #ifdef HAS_QUADMATH
   return fmaq(a, b, c);
 #else
@@ -0,0 +1,240 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *                                                                           *\
+ *  Copyright (c) 2026                                                       *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+// Per-call-site records
+//
+// Backends attribute events to their call site (the return address of the
+// instrumented operation). Records are kept in per-thread tables, so that
+// recording never synchronizes threads, and the tables are merged at
+// finalization. The table of a thread is cached in a __thread variable of
+// the backend together with the id of the call sites; finalization changes
+// the id, which invalidates the caches of all threads at once. A thread may
+// still use its cached table while finalization runs, so tables are never
+// freed, as the per-thread counters of the ieee backend.
+
+#include "vfc_call_sites.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* layout of Dl_info */
+typedef struct {
+  const char *dli_fname;
+  void *dli_fbase;
+  const char *dli_sname;
+  void *dli_saddr;
+} _vfc_dl_info_t;
+
+/* e_type field of the ELF header, same offset in ELF32 and ELF64 */
+#define VFC_ELF_TYPE_OFFSET 16
+/* e_type of position independent executables and shared libraries */
+#define VFC_ELF_TYPE_DYN 3
+
+/* last id given to call sites, ids are never reused */
+static IUint64_t _vfc_call_sites_last_id = 0;
+
+static IUint64_t _new_id(void) {
+  return __atomic_add_fetch(&_vfc_call_sites_last_id, 1, __ATOMIC_RELAXED);
+}
+
+void vfc_call_sites_init(vfc_call_sites_t *sites, ISize_t size,
+                         vfc_call_site_merge_t merge) {
+  sites->size = size;
+  sites->merge = merge;
+  sites->id = _new_id();
+  sites->tables = Null;
+}
+
+/* Returns the table of the current thread, creates it on first use */
+static vfc_call_site_table_t *_get_table(vfc_call_sites_t *sites,
+                                         vfc_call_site_cache_t *cache) {
+  const IUint64_t id = __atomic_load_n(&sites->id, __ATOMIC_ACQUIRE);
+  if (cache->table != Null && cache->sites == sites && cache->id == id) {
+    return cache->table;
+  }
+
+  vfc_call_site_table_t *table =
+      (vfc_call_site_table_t *)interflop_malloc(sizeof(vfc_call_site_table_t));
+  if (table == Null) {
+    return Null;
+  }
+  table->map = vfc_hashmap_create();
+  if (table->map == Null) {
+    interflop_free(table);
+    return Null;
+  }
+  table->lock = 0;
+  table->next = __atomic_load_n(&sites->tables, __ATOMIC_RELAXED);
+  while (!__atomic_compare_exchange_n(&sites->tables, &table->next, table, 0,
+                                      __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    ;
+  cache->table = table;
+  cache->id = id;
+  cache->sites = sites;
+  return table;
+}
+
+static void _lock(vfc_call_site_table_t *table) {
+  while (__atomic_test_and_set(&table->lock, __ATOMIC_ACQUIRE))
+    ;
+}
+
+static void _unlock(vfc_call_site_table_t *table) {
+  __atomic_clear(&table->lock, __ATOMIC_RELEASE);
+}
+
+/* Returns the record of <call_site> in <map>, creates it if needed */
+static vfc_call_site_t *_get_site(vfc_hashmap_t map, ISize_t size,
+                                  void *call_site) {
+  vfc_call_site_t *site =
+      (vfc_call_site_t *)vfc_hashmap_get(map, (ISize_t)call_site);
+  if (site == Null) {
+    site = (vfc_call_site_t *)interflop_calloc(1, size);
+    if (site == Null) {
+      return Null;
+    }
+    site->call_site = call_site;
+    vfc_hashmap_insert(map, (ISize_t)call_site, site);
+  }
+  return site;
+}
+
+void *vfc_call_sites_get(vfc_call_sites_t *sites, vfc_call_site_cache_t *cache,
+                         void *call_site) {
+  vfc_call_site_table_t *table = _get_table(sites, cache);
+  if (table == Null) {
+    return Null;
+  }
+  /* lookups of the owning thread do not modify the table */
+  vfc_call_site_t *site =
+      (vfc_call_site_t *)vfc_hashmap_get(table->map, (ISize_t)call_site);
+  if (site != Null) {
+    return site;
+  }
+  /* inserting may rehash the table, not while it is merged */
+  _lock(table);
+  site = _get_site(table->map, sites->size, call_site);
+  _unlock(table);
+  return site;
+}
+
+static IBool _count_before(const void *a, const void *b) {
+  return ((const vfc_call_site_t *)a)->count >
+         ((const vfc_call_site_t *)b)->count;
+}
+
+/* Sort <n> records with <before> (shell sort) */
+static void _sort_sites(void **sites, ISize_t n,
+                        vfc_call_site_before_t before) {
+  for (ISize_t gap = n / 2; gap > 0; gap /= 2) {
+    for (ISize_t i = gap; i < n; i++) {
+      void *tmp = sites[i];
+      ISize_t j = i;
+      for (; j >= gap && before(tmp, sites[j - gap]); j -= gap) {
+        sites[j] = sites[j - gap];
+      }
+      sites[j] = tmp;
+    }
+  }
+}
+
+void **vfc_call_sites_merge(vfc_call_sites_t *sites,
+                            vfc_call_site_before_t before, ISize_t *n) {
+  *n = 0;
+  vfc_hashmap_t merged = vfc_hashmap_create();
+  if (merged == Null) {
+    return Null;
+  }
+  vfc_call_site_table_t *tables =
+      __atomic_load_n(&sites->tables, __ATOMIC_ACQUIRE);
+  for (vfc_call_site_table_t *table = tables; table != Null;
+       table = table->next) {
+    _lock(table);
+    vfc_hashmap_t map = table->map;
+    for (ISize_t ii = 0; ii < map->capacity; ii++) {
+      ISize_t value = get_value_at(map->items, ii);
+      if (value == 0 || value == 1) {
+        continue;
+      }
+      vfc_call_site_t *site = (vfc_call_site_t *)value;
+      vfc_call_site_t *dst = _get_site(merged, sites->size, site->call_site);
+      if (dst != Null) {
+        sites->merge(dst, site);
+      }
+    }
+    _unlock(table);
+  }
+
+  void **array = (void **)interflop_malloc(
+      (vfc_hashmap_num_items(merged) + 1) * sizeof(void *));
+  ISize_t k = 0;
+  for (ISize_t ii = 0; ii < merged->capacity; ii++) {
+    ISize_t value = get_value_at(merged->items, ii);
+    if (value == 0 || value == 1) {
+      continue;
+    }
+    if (array != Null) {
+      array[k++] = (void *)value;
+    } else {
+      interflop_free((void *)value);
+    }
+  }
+  /* the records now belong to the array */
+  vfc_hashmap_destroy(merged);
+
+  _sort_sites(array, k, (before != Null) ? before : _count_before);
+  *n = k;
+  return array;
+}
+
+void vfc_call_sites_free_merged(void **merged, ISize_t n) {
+  if (merged == Null) {
+    return;
+  }
+  for (ISize_t i = 0; i < n; i++) {
+    interflop_free(merged[i]);
+  }
+  interflop_free(merged);
+}
+
+ISize_t vfc_call_site_object(void *call_site, const char **object) {
+  *object = Null;
+  if (call_site == Null) {
+    return 0;
+  }
+  /* the return address follows the call instruction */
+  ISize_t address = (ISize_t)call_site - 1;
+  _vfc_dl_info_t info;
+  if (interflop_dladdr == Null || interflop_dladdr(call_site, &info) == 0 ||
+      info.dli_fbase == Null) {
+    return address;
+  }
+  *object = info.dli_fname;
+  const char *header = (const char *)info.dli_fbase;
+  if (*(const unsigned short *)(header + VFC_ELF_TYPE_OFFSET) ==
+      VFC_ELF_TYPE_DYN) {
+    address -= (ISize_t)info.dli_fbase;
+  }
+  return address;
+}
+
+void vfc_call_sites_finalize(vfc_call_sites_t *sites) {
+  /* caches of all threads become invalid, the detached tables stay
+   * allocated for the threads still writing to them */
+  __atomic_store_n(&sites->id, _new_id(), __ATOMIC_RELEASE);
+  __atomic_store_n(&sites->tables, Null, __ATOMIC_RELEASE);
+}
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,107 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *                                                                           *\
+ *  Copyright (c) 2026                                                       *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+#ifndef __VFC_CALL_SITES_H__
+#define __VFC_CALL_SITES_H__
+
+#ifdef __INTERFLOP_BOOTSTRAP__
+#include "interflop_stdlib.h"
+#include "vfc_hashmap.h"
+#else
+#include "interflop/hashmap/vfc_hashmap.h"
+#include "interflop/interflop_stdlib.h"
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* Header of a call site record, the first member of the record types of the
+ * backends */
+typedef struct {
+  /* return address of the instrumented operation */
+  void *call_site;
+  /* number of events recorded at the call site */
+  IUint64_t count;
+} vfc_call_site_t;
+
+/* Per-thread table of call sites, tables are chained to be merged at
+ * finalization. Only the owning thread inserts records; it holds <lock> while
+ * inserting, and the merge holds it while reading the table. */
+typedef struct vfc_call_site_table {
+  vfc_hashmap_t map;
+  char lock;
+  struct vfc_call_site_table *next;
+} vfc_call_site_table_t;
+
+/* Adds the counters of the record <src> to the record <dst> */
+typedef void (*vfc_call_site_merge_t)(void *dst, const void *src);
+/* Returns true if the record <a> is reported before the record <b> */
+typedef IBool (*vfc_call_site_before_t)(const void *a, const void *b);
+
+/* Call sites of a backend, with records of <size> bytes */
+typedef struct {
+  ISize_t size;
+  vfc_call_site_merge_t merge;
+  /* unique id of the current tables, changed at finalization */
+  IUint64_t id;
+  /* head of the list of per-thread tables */
+  vfc_call_site_table_t *tables;
+} vfc_call_sites_t;
+
+/* Table of the current thread, kept by the backend in a __thread variable.
+ * The cache is only valid for the call sites <sites> that own the table and
+ * while <id> is their id: records following a finalization go to new
+ * tables. */
+typedef struct {
+  vfc_call_site_table_t *table;
+  IUint64_t id;
+  vfc_call_sites_t *sites;
+} vfc_call_site_cache_t;
+
+/* Initialize <sites> with records of <size> bytes merged with <merge> */
+void vfc_call_sites_init(vfc_call_sites_t *sites, ISize_t size,
+                         vfc_call_site_merge_t merge);
+
+/* Returns the zero-initialized record of <call_site> in the table of the
+ * current thread, creates the table and the record on first use. Returns
+ * Null if they cannot be allocated. */
+void *vfc_call_sites_get(vfc_call_sites_t *sites, vfc_call_site_cache_t *cache,
+                         void *call_site);
+
+/* Merge the per-thread tables into an array of one record per call site,
+ * ordered by <before> (by decreasing count if Null). Sets <n> to the number
+ * of records. The array is freed with vfc_call_sites_free_merged. */
+void **vfc_call_sites_merge(vfc_call_sites_t *sites,
+                            vfc_call_site_before_t before, ISize_t *n);
+
+/* Free the <n> records of <merged> and the array */
+void vfc_call_sites_free_merged(void **merged, ISize_t n);
+
+/* Sets <object> to the path of the object file (executable or shared
+ * library) containing <call_site>, and returns the address of the call
+ * instruction in this file, as expected by addr2line: addresses of position
+ * independent objects are relative to their load address. <object> is Null
+ * and the address is absolute if the object cannot be found (dladdr handler
+ * not set). */
+ISize_t vfc_call_site_object(void *call_site, const char **object);
+
+/* Detach the per-thread tables, later records go to new tables. Tables are
+ * never freed: threads still recording may have checked their cache just
+ * before finalization and keep writing to their detached table. */
+void vfc_call_sites_finalize(vfc_call_sites_t *sites);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __VFC_CALL_SITES_H__ */
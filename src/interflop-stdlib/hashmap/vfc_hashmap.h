@@ -20,7 +20,11 @@
 
 #define __VFC_HASHMAP_HEADER__
 
+#ifdef __INTERFLOP_BOOTSTRAP__
+#include "interflop_stdlib.h"
+#else
 #include "interflop/interflop_stdlib.h"
+#endif
 
 struct vfc_hashmap_st {
   ISize_t nbits;
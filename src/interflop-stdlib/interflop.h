@@ -95,6 +95,12 @@ typedef struct interflop_function_stack {
   long int top;
 } interflop_function_stack_t;
 
+/* Version of struct interflop_backend_interface_t, increased when slots are
+ * appended to it:
+ *   1: scalar operations, function and user calls, finalize
+ *   2: vector operations */
+#define INTERFLOP_INTERFACE_VERSION 2
+
 struct interflop_backend_interface_t {
 
   void (*interflop_add_float)(float a, float b, float *c, void *context);
@@ -127,6 +133,30 @@ struct interflop_backend_interface_t {
   /* interflop_finalize: called at the end of the instrumented program
    * execution */
   void (*interflop_finalize)(void *context);
+
+  /* Optional vector operations on <size> packed lanes (version 2). When a
+   * backend does not provide them, the scalar operation is called on each
+   * lane. */
+  void (*interflop_add_float_vector)(int size, const float *a, const float *b,
+                                     float *c, void *context);
+  void (*interflop_sub_float_vector)(int size, const float *a, const float *b,
+                                     float *c, void *context);
+  void (*interflop_mul_float_vector)(int size, const float *a, const float *b,
+                                     float *c, void *context);
+  void (*interflop_div_float_vector)(int size, const float *a, const float *b,
+                                     float *c, void *context);
+  void (*interflop_add_double_vector)(int size, const double *a,
+                                      const double *b, double *c,
+                                      void *context);
+  void (*interflop_sub_double_vector)(int size, const double *a,
+                                      const double *b, double *c,
+                                      void *context);
+  void (*interflop_mul_double_vector)(int size, const double *a,
+                                      const double *b, double *c,
+                                      void *context);
+  void (*interflop_div_double_vector)(int size, const double *a,
+                                      const double *b, double *c,
+                                      void *context);
 };
 
 /**
@@ -139,6 +169,14 @@ const char *interflop_get_backend_name(void);
  */
 const char *interflop_get_backend_version(void);
 
+/**
+ * interflop_get_interface_version: returns the INTERFLOP_INTERFACE_VERSION the
+ * backend was built with. The slots of later versions in the interface
+ * returned by interflop_init are not set by the backend and are ignored.
+ * Backends that do not export this function have the version 1 interface.
+ */
+int interflop_get_interface_version(void);
+
 /**
  * @brief interflop_pre_init: called at initialization before calling
  *        interflop_init
@@ -74,9 +74,18 @@ interflop_cancellationHandler_t interflop_cancellationHandler = Null;
 interflop_denormalHandler_t interflop_denormalHandler = Null;
 interflop_debug_print_op_t interflop_debug_print_op = Null;
 interflop_gettimeofday_t interflop_gettimeofday = Null;
+interflop_fwrite_t interflop_fwrite = Null;
+interflop_pthread_create_t interflop_pthread_create = Null;
+interflop_pthread_join_t interflop_pthread_join = Null;
+interflop_nanosleep_t interflop_nanosleep = Null;
+interflop_vsnprintf_t interflop_vsnprintf = Null;
+interflop_dladdr_t interflop_dladdr = Null;
 interflop_register_printf_specifier_t interflop_register_printf_specifier =
     Null;
 
+__thread void *interflop_call_site
+    __attribute__((tls_model("initial-exec"))) = Null;
+
 void interflop_set_handler(const char *name, void *function_ptr) {
   if (name == Null) {
     return;
@@ -111,6 +120,12 @@ void interflop_set_handler(const char *name, void *function_ptr) {
   SET_HANDLER(denormalHandler)
   SET_HANDLER(debug_print_op)
   SET_HANDLER(gettimeofday)
+  SET_HANDLER(fwrite)
+  SET_HANDLER(pthread_create)
+  SET_HANDLER(pthread_join)
+  SET_HANDLER(nanosleep)
+  SET_HANDLER(vsnprintf)
+  SET_HANDLER(dladdr)
   SET_HANDLER(register_printf_specifier)
 }
 
@@ -38,6 +38,9 @@ typedef void File;
 typedef int IBool;
 typedef void Itimeval_t;
 typedef void Itimezone_t;
+typedef void Itimespec_t;
+typedef unsigned long Ipthread_t;
+typedef void IDl_info_t;
 
 /* IBool */
 #define ITrue 1
@@ -95,6 +98,16 @@ typedef void (*interflop_debug_print_op_t)(int, const char *,
                                            const double *args,
                                            const double *res);
 typedef int (*interflop_gettimeofday_t)(Itimeval_t *tv, Itimezone_t *tz);
+typedef ISize_t (*interflop_fwrite_t)(const void *ptr, ISize_t size,
+                                     ISize_t nmemb, File *stream);
+typedef int (*interflop_pthread_create_t)(Ipthread_t *thread, const void *attr,
+                                          void *(*start_routine)(void *),
+                                          void *arg);
+typedef int (*interflop_pthread_join_t)(Ipthread_t thread, void **retval);
+typedef int (*interflop_nanosleep_t)(const Itimespec_t *req, Itimespec_t *rem);
+typedef int (*interflop_vsnprintf_t)(char *str, ISize_t size,
+                                     const char *format, va_list ap);
+typedef int (*interflop_dladdr_t)(const void *addr, IDl_info_t *info);
 
 typedef int (*interflop_register_printf_specifier_t)(int __spec, void *__func,
                                                      void *__arginfo);
@@ -129,9 +142,21 @@ extern interflop_cancellationHandler_t interflop_cancellationHandler;
 extern interflop_denormalHandler_t interflop_denormalHandler;
 extern interflop_debug_print_op_t interflop_debug_print_op;
 extern interflop_gettimeofday_t interflop_gettimeofday;
+extern interflop_fwrite_t interflop_fwrite;
+extern interflop_pthread_create_t interflop_pthread_create;
+extern interflop_pthread_join_t interflop_pthread_join;
+extern interflop_nanosleep_t interflop_nanosleep;
+extern interflop_vsnprintf_t interflop_vsnprintf;
+extern interflop_dladdr_t interflop_dladdr;
 extern interflop_register_printf_specifier_t
     interflop_register_printf_specifier;
 
+/* Return address of the instrumented operation being processed. It is set
+ * by the wrapper before calling the backends and identifies the call site
+ * of the operation in the instrumented binary (Null if unknown). */
+extern __thread void *interflop_call_site
+    __attribute__((tls_model("initial-exec")));
+
 float fpow2i(int i);
 double pow2i(int i);
 int interflop_isnanf(float x);
@@ -22,6 +22,7 @@
 #include <stdio.h>
 
 #include "logger.h"
+#include "ring_writer.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -123,6 +124,23 @@ static File *logger_logfile = Null;
 static File *logger_stderr = Null;
 static int logger_level = logger_level_info;
 
+/* The environment is parsed by the first logger_init only, the backends
+ * initialized later share its settings */
+static IBool logger_env_parsed = IFalse;
+
+/* number of bytes of a per-thread buffer of the sink, a power of two */
+#define LOGGER_SINK_BUFFER_SIZE (1 << 16)
+/* longest message going through the buffers */
+#define LOGGER_LINE_SIZE 4096
+
+/* Destination of the debug and info messages. It is buffered when it is a
+ * log file, stderr is shared with the program and stays unbuffered. */
+static ring_writer_t logger_sink;
+static __thread ring_buffer_t *logger_sink_buffer = Null;
+
+/* Header and message of the current thread, written with one call */
+static __thread char logger_line[LOGGER_LINE_SIZE];
+
 /* Returns ITrue if the logger is enabled */
 IBool is_logger_enabled(void) {
   const char *is_logger_enabled_env = interflop_getenv(vfc_backends_logger);
@@ -215,13 +233,58 @@ static void logger_header(File *stream, const char *lvl_name,
   }
 }
 
+static int logger_snprintf(char *str, ISize_t size, const char *fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  int r = interflop_vsnprintf(str, size, fmt, ap);
+  va_end(ap);
+  return r;
+}
+
+/* Write the header and the message to the log file sink */
+static void logger_vprint(const char *lvl_name, const level_color lvl_color,
+                          const char *fmt, va_list argp) {
+  int header = -1;
+  if (interflop_vsnprintf != Null && interflop_fwrite != Null) {
+    if (logger_colored) {
+      header = logger_snprintf(
+          logger_line, LOGGER_LINE_SIZE, "%s%s%s [%s%s%s]: ",
+          ansi_colors[lvl_color], lvl_name, ansi_colors[reset_color],
+          ansi_colors[backend_color], backend_header, ansi_colors[reset_color]);
+    } else {
+      header = logger_snprintf(logger_line, LOGGER_LINE_SIZE, "%s [%s]: ",
+                               lvl_name, backend_header);
+    }
+  }
+
+  if (header >= 0 && header < LOGGER_LINE_SIZE) {
+    va_list aq;
+    va_copy(aq, argp);
+    int size = interflop_vsnprintf(logger_line + header,
+                                   LOGGER_LINE_SIZE - header, fmt, aq);
+    va_end(aq);
+    if (size >= 0 && header + size < LOGGER_LINE_SIZE) {
+      ring_buffer_t *buffer =
+          ring_writer_get_buffer(&logger_sink, &logger_sink_buffer);
+      ring_writer_write(&logger_sink, buffer, logger_line, header + size);
+      return;
+    }
+  }
+
+  /* no formatting handlers or message too long for the line: the header and
+   * the message are written directly, the writer thread waits for both */
+  ring_writer_lock(&logger_sink);
+  logger_header(logger_logfile, lvl_name, lvl_color, logger_colored);
+  interflop_vfprintf(logger_logfile, fmt, argp);
+  ring_writer_unlock(&logger_sink);
+}
+
 /* Display the debug message */
 void logger_debug(const char *fmt, ...) {
   if (logger_enabled && logger_level <= logger_level_debug) {
-    logger_header(logger_logfile, "Debug", debug_color, logger_colored);
     va_list ap;
     va_start(ap, fmt);
-    interflop_vfprintf(logger_logfile, fmt, ap);
+    logger_vprint("Debug", debug_color, fmt, ap);
     va_end(ap);
   }
 }
@@ -229,16 +292,17 @@ void logger_debug(const char *fmt, ...) {
 /* Display the info message */
 void logger_info(const char *fmt, ...) {
   if (logger_enabled && logger_level <= logger_level_info) {
-    logger_header(logger_logfile, "Info", info_color, logger_colored);
     va_list ap;
     va_start(ap, fmt);
-    interflop_vfprintf(logger_logfile, fmt, ap);
+    logger_vprint("Info", info_color, fmt, ap);
     va_end(ap);
   }
 }
 
 /* Display the warning message */
 void logger_warning(const char *fmt, ...) {
+  /* the pending messages come first */
+  ring_writer_flush(&logger_sink);
   if (logger_enabled && logger_level <= logger_level_warning) {
     logger_header(logger_stderr, "Warning", warning_color, logger_colored);
   }
@@ -250,6 +314,7 @@ void logger_warning(const char *fmt, ...) {
 
 /* Display the error message */
 void logger_error(const char *fmt, ...) {
+  ring_writer_flush(&logger_sink);
   if (logger_enabled && logger_level <= logger_level_error) {
     logger_header(logger_stderr, "Error", error_color, logger_colored);
   }
@@ -262,21 +327,20 @@ void logger_error(const char *fmt, ...) {
 /* Display the debug message */
 void vlogger_debug(const char *fmt, va_list argp) {
   if (logger_enabled && logger_level <= logger_level_debug) {
-    logger_header(logger_logfile, "Debug", debug_color, logger_colored);
-    interflop_vfprintf(logger_logfile, fmt, argp);
+    logger_vprint("Debug", debug_color, fmt, argp);
   }
 }
 
 /* Display the info message */
 void vlogger_info(const char *fmt, va_list argp) {
   if (logger_enabled && logger_level <= logger_level_info) {
-    logger_header(logger_logfile, "Info", info_color, logger_colored);
-    interflop_vfprintf(logger_logfile, fmt, argp);
+    logger_vprint("Info", info_color, fmt, argp);
   }
 }
 
 /* Display the warning message */
 void vlogger_warning(const char *fmt, va_list argp) {
+  ring_writer_flush(&logger_sink);
   if (logger_enabled && logger_level <= logger_level_warning) {
     logger_header(logger_stderr, "Warning", warning_color, logger_colored);
   }
@@ -285,6 +349,7 @@ void vlogger_warning(const char *fmt, va_list argp) {
 
 /* Display the error message */
 void vlogger_error(const char *fmt, va_list argp) {
+  ring_writer_flush(&logger_sink);
   if (logger_enabled && logger_level <= logger_level_error) {
     logger_header(logger_stderr, "Error", error_color, logger_colored);
   }
@@ -311,12 +376,19 @@ void logger_init(interflop_panic_t panic, File *stream,
   interflop_set_handler("panic", (void *)panic);
   _logger_check_stdlib();
 
-  logger_enabled = is_logger_enabled();
-  logger_colored = is_logger_colored();
-  logger_level = get_logger_level();
-  set_logger_logfile();
+  if (!logger_env_parsed) {
+    logger_enabled = is_logger_enabled();
+    logger_colored = is_logger_colored();
+    logger_level = get_logger_level();
+    set_logger_logfile();
+    logger_env_parsed = ITrue;
+  }
+  ring_writer_init(&logger_sink, logger_logfile, LOGGER_SINK_BUFFER_SIZE,
+                   logger_logfile != logger_stderr);
 }
 
+void logger_finalize(void) { ring_writer_finalize(&logger_sink); }
+
 #if defined(__cplusplus)
 }
 #endif
\ No newline at end of file
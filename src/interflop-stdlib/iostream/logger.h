@@ -55,6 +55,9 @@ void vlogger_error(const char *fmt, va_list argp);
 void logger_init(interflop_panic_t panic, File *stream,
                  const char *backend_name);
 
+/* Write the buffered messages, the later ones are written unbuffered */
+void logger_finalize(void);
+
 #if defined(__cplusplus)
 }
 #endif
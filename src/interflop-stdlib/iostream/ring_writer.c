@@ -0,0 +1,217 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *                                                                           *\
+ *  Copyright (c) 2026                                                       *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+// Ring writer
+//
+// Threads that write heavily to a stream (log messages, binary traces) do not
+// serialize on the lock of the stream: each thread copies its data to a ring
+// buffer it owns, and a background writer thread drains the buffers with
+// large writes. Writing to the stream always happens under the writer lock,
+// held by the writer thread, by a thread flushing the buffers because its own
+// buffer is full, or by a thread writing directly to the stream.
+
+#include "ring_writer.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* layout of struct timespec */
+typedef struct {
+  long tv_sec;
+  long tv_nsec;
+} _ring_writer_timespec_t;
+
+static void _sleep(long ns) {
+  if (interflop_nanosleep != Null) {
+    _ring_writer_timespec_t delay = {.tv_sec = 0, .tv_nsec = ns};
+    interflop_nanosleep(&delay, Null);
+  }
+}
+
+static IBool _try_lock(ring_writer_t *writer) {
+  return !__atomic_test_and_set(&writer->lock, __ATOMIC_ACQUIRE);
+}
+
+static void _lock(ring_writer_t *writer) {
+  while (!_try_lock(writer)) {
+    _sleep(RING_WRITER_PRODUCER_DELAY);
+  }
+}
+
+static void _unlock(ring_writer_t *writer) {
+  __atomic_clear(&writer->lock, __ATOMIC_RELEASE);
+}
+
+/* Write the bytes of <buffer> between tail and head, the writer lock must be
+ * held. Returns the number of bytes written. */
+static ISize_t _flush_buffer(ring_writer_t *writer, ring_buffer_t *buffer) {
+  const IUint64_t head = __atomic_load_n(&buffer->head, __ATOMIC_ACQUIRE);
+  const IUint64_t tail = buffer->tail;
+  if (head == tail) {
+    return 0;
+  }
+
+  const IUint64_t start = tail & (writer->buffer_size - 1);
+  const IUint64_t n = head - tail;
+  /* the pending bytes may wrap around the end of the ring */
+  const IUint64_t room = writer->buffer_size - start;
+  const IUint64_t first = (n > room) ? room : n;
+  interflop_fwrite(&buffer->data[start], 1, first, writer->stream);
+  if (first < n) {
+    interflop_fwrite(&buffer->data[0], 1, n - first, writer->stream);
+  }
+
+  __atomic_store_n(&buffer->tail, head, __ATOMIC_RELEASE);
+  return n;
+}
+
+/* Write the pending bytes of all buffers, the writer lock must be held */
+static ISize_t _flush_locked(ring_writer_t *writer) {
+  ISize_t n = 0;
+  ring_buffer_t *buffer = __atomic_load_n(&writer->buffers, __ATOMIC_ACQUIRE);
+  for (; buffer != Null; buffer = buffer->next) {
+    n += _flush_buffer(writer, buffer);
+  }
+  return n;
+}
+
+static ISize_t _flush_buffers(ring_writer_t *writer) {
+  _lock(writer);
+  const ISize_t n = _flush_locked(writer);
+  _unlock(writer);
+  return n;
+}
+
+static void *_writer(void *arg) {
+  ring_writer_t *writer = (ring_writer_t *)arg;
+  while (!__atomic_load_n(&writer->stop, __ATOMIC_ACQUIRE)) {
+    if (_flush_buffers(writer) == 0) {
+      _sleep(RING_WRITER_WRITER_DELAY);
+    }
+  }
+  return Null;
+}
+
+void ring_writer_init(ring_writer_t *writer, File *stream, ISize_t buffer_size,
+                      IBool buffered) {
+  if (writer->stream != Null) {
+    return;
+  }
+  writer->stream = stream;
+  writer->buffer_size = buffer_size;
+  writer->buffered = buffered && interflop_fwrite != Null &&
+                     interflop_malloc != Null && interflop_calloc != Null;
+  if (writer->buffered && interflop_pthread_create != Null &&
+      interflop_pthread_join != Null) {
+    writer->writer_started =
+        interflop_pthread_create(&writer->writer, Null, _writer, writer) == 0;
+  }
+}
+
+ring_buffer_t *ring_writer_get_buffer(ring_writer_t *writer,
+                                      ring_buffer_t **cache) {
+  if (!writer->buffered) {
+    return Null;
+  }
+  if (*cache != Null && (*cache)->writer == writer) {
+    return *cache;
+  }
+
+  ring_buffer_t *buffer =
+      (ring_buffer_t *)interflop_calloc(1, sizeof(ring_buffer_t));
+  char *data = (buffer != Null) ? (char *)interflop_malloc(writer->buffer_size)
+                                : Null;
+  if (data == Null) {
+    interflop_free(buffer);
+    return Null;
+  }
+  buffer->data = data;
+  buffer->writer = writer;
+  buffer->index = __atomic_fetch_add(&writer->nb_buffers, 1, __ATOMIC_RELAXED);
+  buffer->next = __atomic_load_n(&writer->buffers, __ATOMIC_RELAXED);
+  while (!__atomic_compare_exchange_n(&writer->buffers, &buffer->next, buffer,
+                                      0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    ;
+  *cache = buffer;
+  return buffer;
+}
+
+void ring_writer_write(ring_writer_t *writer, ring_buffer_t *buffer,
+                       const void *data, ISize_t size) {
+  if (buffer == Null) {
+    _lock(writer);
+    _flush_locked(writer);
+    interflop_fwrite(data, 1, size, writer->stream);
+    _unlock(writer);
+    return;
+  }
+
+  const ISize_t buffer_size = writer->buffer_size;
+  const IUint64_t head = buffer->head;
+
+  /* wait for room in the buffer, flush it if no other thread does */
+  while (buffer_size - (head - __atomic_load_n(&buffer->tail,
+                                               __ATOMIC_ACQUIRE)) <
+         size) {
+    if (_try_lock(writer)) {
+      _flush_locked(writer);
+      _unlock(writer);
+    } else {
+      _sleep(RING_WRITER_PRODUCER_DELAY);
+    }
+  }
+
+  const char *bytes = (const char *)data;
+  const IUint64_t start = head & (buffer_size - 1);
+  const IUint64_t room = buffer_size - start;
+  const ISize_t first = (size > room) ? room : size;
+  for (ISize_t i = 0; i < first; i++) {
+    buffer->data[start + i] = bytes[i];
+  }
+  for (ISize_t i = first; i < size; i++) {
+    buffer->data[i - first] = bytes[i];
+  }
+
+  __atomic_store_n(&buffer->head, head + size, __ATOMIC_RELEASE);
+}
+
+void ring_writer_flush(ring_writer_t *writer) {
+  if (writer->buffered) {
+    _flush_buffers(writer);
+  }
+}
+
+void ring_writer_lock(ring_writer_t *writer) {
+  _lock(writer);
+  _flush_locked(writer);
+}
+
+void ring_writer_unlock(ring_writer_t *writer) { _unlock(writer); }
+
+void ring_writer_finalize(ring_writer_t *writer) {
+  if (!writer->buffered) {
+    return;
+  }
+
+  if (writer->writer_started) {
+    __atomic_store_n(&writer->stop, 1, __ATOMIC_RELEASE);
+    interflop_pthread_join(writer->writer, Null);
+    writer->writer_started = 0;
+  }
+  _flush_buffers(writer);
+  writer->buffered = 0;
+}
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,110 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *                                                                           *\
+ *  Copyright (c) 2026                                                       *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+#ifndef __RING_WRITER_H__
+#define __RING_WRITER_H__
+
+#ifdef __INTERFLOP_BOOTSTRAP__
+#include "interflop_stdlib.h"
+#else
+#include "interflop/interflop_stdlib.h"
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* delay of the writer thread when all buffers are empty (ns) */
+#define RING_WRITER_WRITER_DELAY 1000000
+/* delay of a thread waiting for room in its buffer or for the lock (ns) */
+#define RING_WRITER_PRODUCER_DELAY 10000
+
+#define RING_WRITER_CACHE_LINE_SIZE 64
+
+struct ring_writer;
+
+/* Single-producer single-consumer ring buffer of one thread. head is only
+ * written by the owning thread, tail by the thread holding the writer lock;
+ * they are kept on different cache lines. */
+typedef struct ring_buffer {
+  char *data;
+  IUint64_t head;
+  char pad0[RING_WRITER_CACHE_LINE_SIZE];
+  IUint64_t tail;
+  char pad1[RING_WRITER_CACHE_LINE_SIZE];
+  /* writer owning the buffer */
+  struct ring_writer *writer;
+  /* index of the buffer, in creation order */
+  IUint32_t index;
+  struct ring_buffer *next;
+} ring_buffer_t;
+
+/* Buffered writer to a stream. Each thread appends its data to a ring buffer
+ * it owns, a background writer thread drains the buffers to the stream with
+ * large writes. Data of one thread keep their order, data of different
+ * threads are ordered by chunks. A thread whose buffer is full flushes the
+ * buffers itself if no other thread is doing it, which is also how buffers
+ * are drained when no writer thread can be created (pthread_create handler
+ * not set). An unbuffered writer writes each piece of data with one call.
+ * Writers and buffers are never freed: threads still running may access
+ * them. */
+typedef struct ring_writer {
+  File *stream;
+  IBool buffered;
+  /* number of bytes of a per-thread buffer, a power of two */
+  ISize_t buffer_size;
+  /* head of the list of per-thread buffers */
+  ring_buffer_t *buffers;
+  IUint32_t nb_buffers;
+  /* held by the thread writing to the stream */
+  char lock;
+  IBool stop;
+  /* true if the background writer thread runs */
+  IBool writer_started;
+  Ipthread_t writer;
+} ring_writer_t;
+
+/* Set the <stream> of <writer>, with per-thread buffers of <buffer_size>
+ * bytes (a power of two) and a writer thread if <buffered>. Only the first
+ * call has an effect. */
+void ring_writer_init(ring_writer_t *writer, File *stream, ISize_t buffer_size,
+                      IBool buffered);
+
+/* Returns the buffer of the current thread, kept by the caller in the
+ * __thread variable <cache>. The buffer is created on first use. Returns
+ * Null if <writer> is not buffered. */
+ring_buffer_t *ring_writer_get_buffer(ring_writer_t *writer,
+                                      ring_buffer_t **cache);
+
+/* Write <size> bytes of <data> to <buffer> (size <= buffer_size), or
+ * directly to the stream if <buffer> is Null */
+void ring_writer_write(ring_writer_t *writer, ring_buffer_t *buffer,
+                       const void *data, ISize_t size);
+
+/* Write the pending data of all buffers */
+void ring_writer_flush(ring_writer_t *writer);
+
+/* Write the pending data of all buffers and keep other threads from writing
+ * to the stream until ring_writer_unlock. The caller can then write to the
+ * stream directly. */
+void ring_writer_lock(ring_writer_t *writer);
+void ring_writer_unlock(ring_writer_t *writer);
+
+/* Stop the writer thread and flush the buffers, later data are written
+ * unbuffered */
+void ring_writer_finalize(ring_writer_t *writer);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __RING_WRITER_H__ */
@@ -0,0 +1,26 @@
+# SYNOPSIS
+#
+#   AX_LLVM_BITCODE
+#
+# DESCRIPTION
+#
+#   Create --disable-bitcode option. Unless disabled, look for clang
+#   (BITCODE_CC) and llvm-link (BITCODE_LINK) to build the LLVM bitcode of
+#   the backend, used by verificarlo --static-backend
+#
+
+AC_DEFUN([AX_LLVM_BITCODE],
+[
+AC_ARG_ENABLE(bitcode, AS_HELP_STRING([--disable-bitcode],[Do not build the LLVM bitcode of the backend]), [ENABLE_BITCODE="$enableval"], [ENABLE_BITCODE="yes"])
+AC_ARG_VAR([BITCODE_CC], [clang compiler used to build the backend bitcode])
+AC_ARG_VAR([BITCODE_LINK], [llvm-link used to build the backend bitcode])
+if test "x$ENABLE_BITCODE" = "xyes"; then
+   AC_PATH_PROGS([BITCODE_CC], [clang], [])
+   AC_PATH_PROGS([BITCODE_LINK], [llvm-link], [])
+   if test -z "$BITCODE_CC" || test -z "$BITCODE_LINK"; then
+      AC_MSG_NOTICE([clang or llvm-link not found, the backend bitcode is not built])
+      ENABLE_BITCODE="no"
+   fi
+fi
+AM_CONDITIONAL([ENABLE_BITCODE], [test "x$ENABLE_BITCODE" = "xyes"])
+])
@@ -50,6 +50,7 @@ static void _set_seed(rng_state_t *random_state, const bool choose_seed,
   }
   random_state->random_state[0] = next_seed(random_state->seed);
   random_state->random_state[1] = next_seed(random_state->seed);
+  random_state->sparsity_countdown = 0;
 }
 
 /* Get a new identifier for the calling thread */
@@ -29,6 +29,9 @@ typedef struct rng_state {
   uint64_t seed;
   bool random_state_valid;
   __INTERNAL_RNG_STATE random_state;
+  /* number of sparsity trials until the next perturbed operation, */
+  /* 0 if not drawn yet (see _mca_skip_eval) */
+  uint64_t sparsity_countdown;
 } rng_state_t;
 
 /* Get a new identifier for the calling thread */
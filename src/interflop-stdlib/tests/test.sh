@@ -16,6 +16,9 @@ function run() {
 
 run test_pow2
 run test_string_equal
+run test_fma
+run test_logger
+run test_call_sites
 
 echo "All tests passed"
 exit 0
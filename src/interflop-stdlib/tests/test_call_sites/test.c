@@ -0,0 +1,111 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../hashmap/vfc_call_sites.c"
+#include "../../hashmap/vfc_hashmap.c"
+#include "../../interflop_stdlib.c"
+
+#define NB_THREADS 8
+#define NB_SITES 100
+
+typedef struct {
+  vfc_call_site_t site;
+  IUint64_t sum;
+} record_t;
+
+static vfc_call_sites_t sites;
+static __thread vfc_call_site_cache_t cache = {NULL, 0, NULL};
+
+static void merge(void *dst, const void *src) {
+  ((record_t *)dst)->site.count += ((const record_t *)src)->site.count;
+  ((record_t *)dst)->sum += ((const record_t *)src)->sum;
+}
+
+static void record(void *call_site, IUint64_t value) {
+  record_t *r = (record_t *)vfc_call_sites_get(&sites, &cache, call_site);
+  assert(r != NULL && r->site.call_site == call_site);
+  r->site.count++;
+  r->sum += value;
+}
+
+static IBool stop = 0;
+
+/* site i is recorded i + 1 times by each thread */
+static void *record_sites(void *arg) {
+  const IUint64_t thread = (IUint64_t)arg;
+  for (IUint64_t i = 0; i < NB_SITES; i++) {
+    for (IUint64_t j = 0; j <= i; j++) {
+      record((void *)(i + 1), thread);
+    }
+  }
+  return NULL;
+}
+
+/* record new sites until stopped, many of them to rehash the tables */
+static void *record_until_stopped(void *arg) {
+  const IUint64_t thread = (IUint64_t)arg;
+  for (IUint64_t i = 0; !__atomic_load_n(&stop, __ATOMIC_ACQUIRE); i++) {
+    record((void *)((thread << 32) + i % 100000 + 1), 1);
+  }
+  return NULL;
+}
+
+int main() {
+  interflop_set_handler("malloc", malloc);
+  interflop_set_handler("calloc", calloc);
+  interflop_set_handler("free", free);
+
+  vfc_call_sites_init(&sites, sizeof(record_t), merge);
+  pthread_t threads[NB_THREADS];
+  for (IUint64_t t = 0; t < NB_THREADS; t++) {
+    pthread_create(&threads[t], NULL, record_sites, (void *)t);
+  }
+  for (int t = 0; t < NB_THREADS; t++) {
+    pthread_join(threads[t], NULL);
+  }
+  record_sites((void *)NB_THREADS);
+
+  /* one record per site, by decreasing count */
+  ISize_t n = 0;
+  record_t **merged = (record_t **)vfc_call_sites_merge(&sites, NULL, &n);
+  assert(n == NB_SITES);
+  for (ISize_t k = 0; k < n; k++) {
+    const IUint64_t i = NB_SITES - 1 - k;
+    assert(merged[k]->site.call_site == (void *)(i + 1));
+    assert(merged[k]->site.count == (NB_THREADS + 1) * (i + 1));
+    assert(merged[k]->sum == (i + 1) * NB_THREADS * (NB_THREADS + 1) / 2);
+  }
+  vfc_call_sites_free_merged((void **)merged, n);
+
+  /* the cache of the thread does not keep its detached table */
+  vfc_call_sites_finalize(&sites);
+  assert(sites.tables == NULL);
+  record((void *)1, 1);
+  assert(sites.tables != NULL && sites.tables == cache.table);
+  merged = (record_t **)vfc_call_sites_merge(&sites, NULL, &n);
+  assert(n == 1 && merged[0]->site.count == 1);
+  vfc_call_sites_free_merged((void **)merged, n);
+  vfc_call_sites_finalize(&sites);
+
+  /* threads keep recording while the tables are merged and finalized */
+  for (IUint64_t t = 0; t < NB_THREADS; t++) {
+    pthread_create(&threads[t], NULL, record_until_stopped, (void *)(t + 1));
+  }
+  for (int k = 0; k < 200; k++) {
+    merged = (record_t **)vfc_call_sites_merge(&sites, NULL, &n);
+    for (ISize_t i = 0; i < n; i++) {
+      assert(merged[i]->site.count > 0);
+    }
+    vfc_call_sites_free_merged((void **)merged, n);
+    vfc_call_sites_finalize(&sites);
+  }
+  __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+  for (int t = 0; t < NB_THREADS; t++) {
+    pthread_join(threads[t], NULL);
+  }
+
+  fprintf(stderr, "Test passed\n");
+  return 0;
+}
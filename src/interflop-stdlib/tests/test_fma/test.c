@@ -0,0 +1,97 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../fma/interflop_fma.c"
+
+/* The product of two binary64 is exact in binary128, the reference result is
+ * rounded once by the binary128 addition */
+static _Float128 reference(double a, double b, double c) {
+  return (_Float128)a * (_Float128)b + (_Float128)c;
+}
+
+static double random_double(int exp_min, int exp_max) {
+  double x = (double)rand() / RAND_MAX + (double)rand() / RAND_MAX * 0x1p-31;
+  x = ldexp(1 + x, exp_min + rand() % (exp_max - exp_min + 1));
+  return (rand() % 2) ? x : -x;
+}
+
+static int check(double a, double b, double c) {
+  _Float128 res = interflop_fma_binary128(a, b, c);
+  _Float128 ref = reference(a, b, c);
+  /* normal binary64 operands take the integer path */
+  if (isnormal(a) && isnormal(b) && isnormal(c)) {
+    b128_bits_t bits;
+    assert(_fma_binary64_in_binary128(((b128_bits_t){.f128 = a}).u128,
+                                      ((b128_bits_t){.f128 = b}).u128,
+                                      ((b128_bits_t){.f128 = c}).u128,
+                                      &bits.u128));
+    assert(memcmp(&res, &bits.f128, sizeof(res)) == 0);
+  }
+  if (memcmp(&res, &ref, sizeof(res)) != 0) {
+    fprintf(stderr, "==================\n");
+    fprintf(stderr, "a  : %.13a\n", a);
+    fprintf(stderr, "b  : %.13a\n", b);
+    fprintf(stderr, "c  : %.13a\n", c);
+    fprintf(stderr, "res: %.13a + %.13a\n", (double)res,
+            (double)(res - (_Float128)(double)res));
+    fprintf(stderr, "ref: %.13a + %.13a\n", (double)ref,
+            (double)(ref - (_Float128)(double)ref));
+    return 1;
+  }
+  return 0;
+}
+
+int main() {
+  int errors = 0;
+  srand(42);
+
+  /* random operands, from close exponents to no overlap at all */
+  for (int i = 0; i < 1000000; i++) {
+    const int range = (i % 4 == 0) ? 1 : (i % 4 == 1) ? 60 : 300;
+    errors += check(random_double(-range, range), random_double(-range, range),
+                    random_double(-2 * range, 2 * range));
+  }
+
+  /* cancellations: c is close to -a * b */
+  for (int i = 0; i < 1000000; i++) {
+    const double a = random_double(-100, 100);
+    const double b = random_double(-100, 100);
+    double c = -a * b;
+    if (i % 2) {
+      c = nextafter(c, (i % 4 == 1) ? INFINITY : -INFINITY);
+    }
+    errors += check(a, b, c);
+  }
+
+  /* ties and directed cases around the 113th bit */
+  for (int k = 100; k < 130; k++) {
+    for (int s = -1; s <= 1; s += 2) {
+      errors += check(1.0, 1.0, s * ldexp(1.0, -k));
+      errors += check(1 + 0x1p-52, 1 + 0x1p-52, s * ldexp(1.0, -k));
+      errors += check(1 + 0x1p-52, 1 - 0x1p-53, s * ldexp(1.0, -k));
+      errors += check(3.0, 1 + 0x1p-52, s * ldexp(1.0, -k));
+    }
+  }
+
+  /* extreme binary64 exponents */
+  errors += check(0x1p-1022, 0x1p-1022, 0x1p1023);
+  errors += check(0x1.fffffffffffffp1023, 0x1.fffffffffffffp1023, -0x1p-1022);
+  errors += check(0x1p-1022, -0x1p-1022, 0x1p-1022);
+
+  /* operands handled by the software fallback */
+  errors += check(0.0, 1.0, -0.0);
+  errors += check(0x1p-1074, 3.0, 1.0);
+  errors += check(INFINITY, 1.0, 1.0);
+  _Float128 inexact = (_Float128)1 + (_Float128)0x1p-60 * (_Float128)0x1p-30;
+  assert(interflop_fma_binary128(inexact, 1, 0) == inexact);
+
+  if (errors) {
+    fprintf(stderr, "%d errors\n", errors);
+    return 1;
+  }
+  fprintf(stderr, "Test passed\n");
+  return 0;
+}
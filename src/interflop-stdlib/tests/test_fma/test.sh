@@ -0,0 +1,10 @@
+#!/bin/bash
+set -e
+
+echo "-O0"
+gcc test.c -o test -lm -lquadmath -O0
+./test
+
+echo "-O3"
+gcc test.c -o test -lm -lquadmath -O3
+./test
@@ -0,0 +1,115 @@
+#define _GNU_SOURCE
+#include <assert.h>
+#include <err.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../../interflop_stdlib.c"
+#include "../../iostream/logger.c"
+#include "../../iostream/ring_writer.c"
+
+#define NB_THREADS 8
+#define NB_MESSAGES 20000
+
+static int get_tid(void) { return (int)gettid(); }
+
+static void panic(const char *msg) {
+  fprintf(stderr, "%s", msg);
+  exit(1);
+}
+
+static void set_handlers(void) {
+  interflop_set_handler("getenv", getenv);
+  interflop_set_handler("sprintf", sprintf);
+  interflop_set_handler("strerror", strerror);
+  interflop_set_handler("gettid", get_tid);
+  interflop_set_handler("fopen", fopen);
+  interflop_set_handler("strcasecmp", strcasecmp);
+  interflop_set_handler("vwarnx", vwarnx);
+  interflop_set_handler("fprintf", fprintf);
+  interflop_set_handler("exit", exit);
+  interflop_set_handler("vfprintf", vfprintf);
+  interflop_set_handler("malloc", malloc);
+  interflop_set_handler("calloc", calloc);
+  interflop_set_handler("fwrite", fwrite);
+  interflop_set_handler("vsnprintf", vsnprintf);
+  interflop_set_handler("pthread_create", pthread_create);
+  interflop_set_handler("pthread_join", pthread_join);
+  interflop_set_handler("nanosleep", nanosleep);
+}
+
+static void *log_messages(void *arg) {
+  const long thread = (long)arg;
+  for (int i = 0; i < NB_MESSAGES; i++) {
+    logger_info("thread %ld message %d\n", thread, i);
+  }
+  return NULL;
+}
+
+int main() {
+  char logfile[64];
+  sprintf(logfile, "test.log.%d", get_tid());
+  unlink(logfile);
+  setenv("VFC_BACKENDS_LOGGER", "True", 1);
+  setenv("VFC_BACKENDS_LOGGER_LEVEL", "info", 1);
+  setenv("VFC_BACKENDS_LOGFILE", "test.log", 1);
+
+  set_handlers();
+  logger_init(panic, stderr, "test");
+  assert(logger_sink.buffered && logger_sink.writer_started);
+
+  /* the environment is only parsed by the first initialization */
+  setenv("VFC_BACKENDS_LOGGER_LEVEL", "error", 1);
+  logger_init(panic, stderr, "test");
+  assert(logger_level == logger_level_info);
+
+  pthread_t threads[NB_THREADS];
+  for (long t = 0; t < NB_THREADS; t++) {
+    pthread_create(&threads[t], NULL, log_messages, (void *)t);
+  }
+  /* a message longer than the line is written directly */
+  char long_message[2 * LOGGER_LINE_SIZE];
+  memset(long_message, 'x', sizeof(long_message) - 1);
+  long_message[sizeof(long_message) - 1] = '\0';
+  logger_info("%s\n", long_message);
+  for (int t = 0; t < NB_THREADS; t++) {
+    pthread_join(threads[t], NULL);
+  }
+  logger_finalize();
+  assert(!logger_sink.buffered);
+  fclose(logger_logfile);
+
+  /* each message is written once, whole, in the order of its thread */
+  FILE *f = fopen(logfile, "r");
+  assert(f != NULL);
+  int next[NB_THREADS] = {0};
+  int long_messages = 0;
+  char line[3 * LOGGER_LINE_SIZE];
+  while (fgets(line, sizeof(line), f) != NULL) {
+    long thread;
+    int message;
+    if (sscanf(line, "Info [test]: thread %ld message %d\n", &thread,
+               &message) == 2) {
+      assert(0 <= thread && thread < NB_THREADS);
+      assert(message == next[thread]);
+      next[thread]++;
+    } else {
+      assert(strncmp(line, "Info [test]: ", 13) == 0);
+      assert(strlen(line) == 13 + sizeof(long_message));
+      long_messages++;
+    }
+  }
+  fclose(f);
+  unlink(logfile);
+
+  for (int t = 0; t < NB_THREADS; t++) {
+    assert(next[t] == NB_MESSAGES);
+  }
+  assert(long_messages == 1);
+  return 0;
+}
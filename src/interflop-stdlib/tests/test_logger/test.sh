@@ -0,0 +1,10 @@
+#!/bin/bash
+set -e
+
+echo "-O0"
+gcc test.c -o test -D__INTERFLOP_BOOTSTRAP__ -I../.. -lpthread -O0
+./test
+
+echo "-O3"
+gcc test.c -o test -D__INTERFLOP_BOOTSTRAP__ -I../.. -lpthread -O3
+./test
@@ -64,6 +64,27 @@ typedef llvm::LibFunc _LibFunc;
 
 using namespace llvm;
 
+// Place of the pass in the default pipeline when loaded with -fpass-plugin
+enum ExtensionPoint {
+  EPNone,
+  EPPipelineStart,
+  EPOptimizerEarly,
+  EPOptimizerLast
+};
+
+static cl::opt<ExtensionPoint> VfclibFuncExtensionPoint(
+    "vfclibfunc-extension-point",
+    cl::desc("Run the pass in the default pipeline of clang -fpass-plugin"),
+    cl::values(clEnumValN(EPNone, "none",
+                          "only run the pass with -passes=vfclibfunc"),
+               clEnumValN(EPPipelineStart, "pipeline-start",
+                          "before any optimization"),
+               clEnumValN(EPOptimizerEarly, "optimizer-early",
+                          "after inlining and function simplification"),
+               clEnumValN(EPOptimizerLast, "optimizer-last",
+                          "after the optimization pipeline")),
+    cl::init(EPNone));
+
 namespace {
 
 static Function *func_enter;
@@ -652,5 +673,24 @@ extern "C" LLVM_ATTRIBUTE_WEAK PassPluginLibraryInfo llvmGetPassPluginInfo() {
                   }
                   return false;
                 });
+            PB.registerPipelineStartEPCallback(
+                [](ModulePassManager &MPM, OptimizationLevel) {
+                  if (VfclibFuncExtensionPoint == EPPipelineStart) {
+                    MPM.addPass(VfclibFuncPass());
+                  }
+                });
+            // LLVM 20 adds the LTO phase to the callback arguments
+            PB.registerOptimizerEarlyEPCallback(
+                [](ModulePassManager &MPM, OptimizationLevel, auto...) {
+                  if (VfclibFuncExtensionPoint == EPOptimizerEarly) {
+                    MPM.addPass(VfclibFuncPass());
+                  }
+                });
+            PB.registerOptimizerLastEPCallback(
+                [](ModulePassManager &MPM, OptimizationLevel, auto...) {
+                  if (VfclibFuncExtensionPoint == EPOptimizerLast) {
+                    MPM.addPass(VfclibFuncPass());
+                  }
+                });
           }};
 }
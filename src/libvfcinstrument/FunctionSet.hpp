@@ -0,0 +1,203 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *                                                                           *\
+ *  Copyright (c) 2026                                                       *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+// Set of functions selected by --function, --include-file or --exclude-file.
+//
+// Inclusion and exclusion files generated by vfc_ddebug or vfc_precexp list
+// thousands of exact names. Instead of a single regex alternation, exact names
+// are stored in a hash set, patterns with the * wildcard are compiled to glob
+// patterns indexed by their literal prefix, and only patterns using other
+// regex operators are matched with std::regex.
+
+#ifndef VERIFICARLO_LIBVFCINSTRUMENT_FUNCTION_SET_HPP
+#define VERIFICARLO_LIBVFCINSTRUMENT_FUNCTION_SET_HPP
+
+#include <fstream>
+#include <regex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/ADT/StringSet.h>
+#include <llvm/Support/Allocator.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/GlobPattern.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/StringSaver.h>
+
+class FunctionSet {
+public:
+  /* Add a pattern of an inclusion/exclusion file: * matches any sequence of
+   * characters, . is a literal dot, and other regex operators keep their
+   * ECMAScript meaning */
+  void addPattern(llvm::StringRef pattern) {
+    if (pattern.find_first_of(regexOperators) != llvm::StringRef::npos) {
+      regexes.emplace_back(toRegex(pattern));
+    } else if (pattern.find('*') != llvm::StringRef::npos) {
+      addGlob(pattern);
+    } else {
+      names.insert(pattern);
+    }
+  }
+
+  /* Add an ECMAScript regex (--function option) */
+  void addRegex(llvm::StringRef regex) {
+    if (regex.find_first_of(regexOperators) != llvm::StringRef::npos ||
+        regex.find_first_of(".*") != llvm::StringRef::npos) {
+      regexes.emplace_back(regex.str());
+    } else {
+      names.insert(regex);
+    }
+  }
+
+  /* Add the functions of the lines of <fileName> whose module pattern matches
+   * <moduleName>. Returns false and sets <error> if the file cannot be read or
+   * is not well formatted. */
+  bool addFile(const std::string &fileName, llvm::StringRef moduleName,
+               std::string &error) {
+    std::ifstream stream(fileName.c_str());
+    if (!stream.is_open()) {
+      error = "Cannot open " + fileName;
+      return false;
+    }
+
+    // Lines of a file share a few module patterns, match each one once
+    llvm::StringMap<bool> moduleMatches;
+    int lineno = 0;
+    std::string line;
+    while (std::getline(stream, line)) {
+      lineno++;
+      llvm::StringRef l(line);
+
+      // Ignore empty or commented lines
+      if (l.trim().empty() || l[0] == '#') {
+        continue;
+      }
+
+      std::pair<llvm::StringRef, llvm::StringRef> p = l.split(" ");
+      if (p.second.empty()) {
+        error = "Syntax error in exclusion/inclusion file " + fileName + ":" +
+                std::to_string(lineno);
+        return false;
+      }
+
+      std::string mod = p.first.trim().str();
+      // If mod is not an absolute path,
+      // we search any module containing mod
+      if (llvm::sys::path::is_relative(mod)) {
+        mod = "*" + llvm::sys::path::get_separator().str() + mod;
+      }
+      // If the user does not specify extension for the module
+      // we match any extension
+      if (not llvm::sys::path::has_extension(mod)) {
+        mod += ".*";
+      }
+
+      auto it = moduleMatches.find(mod);
+      if (it == moduleMatches.end()) {
+        FunctionSet modulePattern;
+        modulePattern.addPattern(mod);
+        it = moduleMatches.insert({mod, modulePattern.match(moduleName)}).first;
+      }
+      if (it->second) {
+        addPattern(p.second.trim());
+      }
+    }
+    return true;
+  }
+
+  bool match(llvm::StringRef name) const {
+    if (names.count(name)) {
+      return true;
+    }
+    for (size_t length : globPrefixLengths) {
+      if (length > name.size()) {
+        break;
+      }
+      auto it = globs.find(name.take_front(length));
+      if (it == globs.end()) {
+        continue;
+      }
+      for (const llvm::GlobPattern &glob : it->second) {
+        if (glob.match(name)) {
+          return true;
+        }
+      }
+    }
+    const std::string str = name.str();
+    for (const std::regex &regex : regexes) {
+      if (std::regex_match(str, regex)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool empty() const {
+    return names.empty() && globs.empty() && regexes.empty();
+  }
+
+private:
+  /* characters that make a pattern a regex; . and * have a glob meaning */
+  static constexpr const char *regexOperators = "\\^$+?()[]{}|";
+
+  // https://thispointer.com/find-and-replace-all-occurrences-of-a-sub-string-in-c/
+  static void findAndReplaceAll(std::string &data, const std::string &toSearch,
+                                const std::string &replaceStr) {
+    // Get the first occurrence
+    size_t pos = data.find(toSearch);
+    // Repeat till end is reached
+    while (pos != std::string::npos) {
+      // Replace this occurrence of Sub String
+      data.replace(pos, toSearch.size(), replaceStr);
+      // Get the next occurrence from the current position
+      pos = data.find(toSearch, pos + replaceStr.size());
+    }
+  }
+
+  static std::string toRegex(llvm::StringRef pattern) {
+    std::string regex = pattern.str();
+    findAndReplaceAll(regex, ".", "\\.");
+    // ECMAScript needs .* instead of * for matching any charactere
+    // http://www.cplusplus.com/reference/regex/ECMAScript/
+    findAndReplaceAll(regex, "*", ".*");
+    return regex;
+  }
+
+  void addGlob(llvm::StringRef pattern) {
+    // GlobPattern may keep references to the pattern
+    pattern = llvm::StringSaver(allocator).save(pattern);
+    llvm::Expected<llvm::GlobPattern> glob = llvm::GlobPattern::create(pattern);
+    if (!glob) {
+      // Cannot happen with only literals and *, keep the regex semantics
+      llvm::consumeError(glob.takeError());
+      regexes.emplace_back(toRegex(pattern));
+      return;
+    }
+    llvm::StringRef prefix = pattern.take_until([](char c) { return c == '*'; });
+    globs[prefix].push_back(std::move(*glob));
+    globPrefixLengths.insert(prefix.size());
+  }
+
+  /* names without wildcard */
+  llvm::StringSet<> names;
+  /* glob patterns by the literal prefix before their first * */
+  llvm::StringMap<std::vector<llvm::GlobPattern>> globs;
+  std::set<size_t> globPrefixLengths;
+  llvm::BumpPtrAllocator allocator;
+  /* patterns using other regex operators */
+  std::vector<std::regex> regexes;
+};
+
+#endif /* VERIFICARLO_LIBVFCINSTRUMENT_FUNCTION_SET_HPP */
@@ -20,9 +20,21 @@
 #include "../../config.h"
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/Analysis/BranchProbabilityInfo.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ScalarEvolution.h"
+#include "llvm/Analysis/ScalarEvolutionExpressions.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/Analysis/ValueTracking.h"
+#include "llvm/IR/Dominators.h"
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Module.h"
+#include "llvm/Linker/Linker.h"
 #ifdef PIC
 #undef PIC
 #endif
@@ -32,30 +44,53 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/KnownBits.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/Utils/BasicBlockUtils.h"
+#include "llvm/Transforms/Utils/LoopUtils.h"
+#include "llvm/Transforms/Utils/ScalarEvolutionExpander.h"
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Support/SourceMgr.h>
 #pragma GCC diagnostic pop
 
+#include <algorithm>
+#include <array>
 #include <cxxabi.h>
 #include <fstream>
 #include <functional>
-#include <regex>
+#include <map>
+#include <optional>
 #include <set>
 #include <sstream>
 #include <utility>
 
-#define GET_VECTOR_TYPE(ty, size) FixedVectorType::get(ty, size)
+#include "FunctionSet.hpp"
 
-#if LLVM_VERSION_MAJOR >= 18
-#define STARTS_WITH(str, prefix) str.starts_with(prefix)
-#else
-#define STARTS_WITH(str, prefix) str.startswith(prefix)
-#endif
+#define GET_VECTOR_TYPE(ty, size) FixedVectorType::get(ty, size)
 
 using namespace llvm;
+
+#define DEBUG_TYPE "vfclibinst"
+
+STATISTIC(NumInstrumented, "Number of instrumented floating-point operations");
+STATISTIC(NumSkippedExact, "Number of provably exact operations not "
+                           "instrumented (-vfclibinst-skip-exact)");
+STATISTIC(NumBatchedLoops, "Number of loops replaced by a batched call "
+                           "(-vfclibinst-batch-loops)");
+
+// Operations left native by -vfclibinst-skip-exact
+enum SkipExactLevel { SkipExactNone, SkipExactZero, SkipExactNative };
+
+// Place of the pass in the default pipeline when loaded with -fpass-plugin
+enum ExtensionPoint {
+  EPNone,
+  EPPipelineStart,
+  EPOptimizerEarly,
+  EPOptimizerLast
+};
+
 // VfclibInst pass command line arguments
 static cl::opt<std::string>
     VfclibInstFunction("vfclibinst-function",
@@ -97,6 +132,59 @@ static cl::opt<bool> VfclibInstInstrumentCast(
     cl::desc("Instrument floating point cast instructions"),
     cl::value_desc("InstrumentCast"), cl::init(false));
 
+static cl::opt<std::string> VfclibInstStaticBackend(
+    "vfclibinst-static-backend-file",
+    cl::desc("Import the backend IR file StaticBackendIRFile to inline its "
+             "operations into the instrumented code"),
+    cl::value_desc("StaticBackendIRFile"), cl::init(""));
+
+static cl::opt<bool> VfclibInstStaticBackendPrepare(
+    "vfclibinst-static-backend-prepare",
+    cl::desc("Prepare the static backend IR to be linked with modules "
+             "instrumented with -vfclibinst-static-backend-file"),
+    cl::value_desc("StaticBackendPrepare"), cl::init(false));
+
+static cl::opt<SkipExactLevel> VfclibInstSkipExact(
+    "vfclibinst-skip-exact",
+    cl::desc("Do not instrument provably exact operations"),
+    cl::values(
+        clEnumValN(SkipExactNone, "none", "instrument all operations"),
+        clEnumValN(SkipExactZero, "zero",
+                   "skip operations exact at any precision: x-x, x*0"),
+        clEnumValN(SkipExactNative, "native",
+                   "also skip operations exact in the native format: x+0, "
+                   "x+x, scaling by a power of two, integer arithmetic, "
+                   "...")),
+    cl::init(SkipExactNone));
+
+static cl::opt<std::string> VfclibInstReportFile(
+    "vfclibinst-report-file",
+    cl::desc("Write a JSON report of the floating-point operations of each "
+             "function and loop to ReportFile"),
+    cl::value_desc("ReportFile"), cl::init(""));
+
+static cl::opt<bool> VfclibInstBatchLoops(
+    "vfclibinst-batch-loops",
+    cl::desc("Replace simple innermost map and reduction loops by a single "
+             "call to a batched wrapper"),
+    cl::value_desc("BatchLoops"), cl::init(false));
+
+static cl::opt<ExtensionPoint> VfclibInstExtensionPoint(
+    "vfclibinst-extension-point",
+    cl::desc("Run the pass in the default pipeline of clang -fpass-plugin"),
+    cl::values(clEnumValN(EPNone, "none",
+                          "only run the pass with -passes=vfclibinst"),
+               clEnumValN(EPPipelineStart, "pipeline-start",
+                          "before any optimization, vector operations only "
+                          "come from the source"),
+               clEnumValN(EPOptimizerEarly, "optimizer-early",
+                          "after inlining and function simplification, "
+                          "before the loop and SLP vectorizers"),
+               clEnumValN(EPOptimizerLast, "optimizer-last",
+                          "after the optimization pipeline, including the "
+                          "loop and SLP vectorizers")),
+    cl::init(EPNone));
+
 /* pointer that hold the vfcwrapper Module */
 static Module *vfcwrapperM = nullptr;
 
@@ -125,9 +213,25 @@ std::map<Type::TypeID, std::string> validTypesMap = {
 /* valid vector sizes to instrument */
 const std::set<unsigned> validVectorSizes = {2, 4, 8, 16};
 
+/* Instrumentation report: counters of the operations of a given kind, type
+ * and vector width in a function or a loop */
+struct OpCounters {
+  uint64_t instrumented = 0;
+  uint64_t skipped = 0;
+  uint64_t excluded = 0;
+  /* executions of the instrumented operations, from the profile data */
+  uint64_t dynamic = 0;
+};
+using OpKey = std::tuple<FPOps, std::string, unsigned>;
+using OpReport = std::map<OpKey, OpCounters>;
+
 struct VfclibInst : public ModulePass {
   static char ID;
 
+  /* number of instrumented and skipped operations per FPOps */
+  unsigned instrumentedOps[FOP_IGNORE] = {0};
+  unsigned skippedExactOps[FOP_IGNORE] = {0};
+
   VfclibInst() : ModulePass(ID) {}
 
   // Taken from
@@ -142,27 +246,6 @@ struct VfclibInst : public ModulePass {
     return tokens;
   }
 
-  // https://thispointer.com/find-and-replace-all-occurrences-of-a-sub-string-in-c/
-  void findAndReplaceAll(std::string &data, std::string toSearch,
-                         std::string replaceStr) {
-    // Get the first occurrence
-    size_t pos = data.find(toSearch);
-    // Repeat till end is reached
-    while (pos != std::string::npos) {
-      // Replace this occurrence of Sub String
-      data.replace(pos, toSearch.size(), replaceStr);
-      // Get the next occurrence from the current position
-      pos = data.find(toSearch, pos + replaceStr.size());
-    }
-  }
-
-  void escape_regex(std::string &str) {
-    findAndReplaceAll(str, ".", "\\.");
-    // ECMAScript needs .* instead of * for matching any charactere
-    // http://www.cplusplus.com/reference/regex/ECMAScript/
-    findAndReplaceAll(str, "*", ".*");
-  }
-
   std::string getSourceFileNameAbsPath(Module &M) {
 
     std::string filename = M.getSourceFileName();
@@ -179,119 +262,387 @@ struct VfclibInst : public ModulePass {
     }
   }
 
-  std::regex parseFunctionSetFile(Module &M, cl::opt<std::string> &fileName) {
+  FunctionSet parseFunctionSetFile(Module &M, cl::opt<std::string> &fileName) {
+    FunctionSet functionSet;
     // Skip if empty fileName
     if (fileName.empty()) {
-      return std::regex("");
+      return functionSet;
     }
 
-    // Open File
-    std::ifstream loopstream(fileName.c_str());
-    if (!loopstream.is_open()) {
-      errs() << "Cannot open " << fileName << "\n";
+    // return the absolute path of the source file
+    std::string moduleName = getSourceFileNameAbsPath(M);
+    moduleName = (moduleName.empty()) ? M.getModuleIdentifier() : moduleName;
+
+    // Parse File, if module name matches, add function to FunctionSet
+    std::string error;
+    if (not functionSet.addFile(fileName, moduleName, error)) {
+      errs() << error << "\n";
       report_fatal_error("libVFCInstrument fatal error");
     }
+    return functionSet;
+  }
 
-    // Parse File, if module name matches, add function to FunctionSet
-    int lineno = 0;
-    std::string line;
+  /* Load vfcwrapper.ll Module */
+  void loadVfcwrapperIR(Module &M) {
+    SMDiagnostic err;
+    std::unique_ptr<Module> _M =
+        parseIRFile(VfclibInstVfcwrapper, err, M.getContext());
+    if (_M.get() == nullptr) {
+      err.print(VfclibInstVfcwrapper.c_str(), errs());
+      report_fatal_error("libVFCInstrument fatal error");
+    }
+    vfcwrapperM = _M.release();
+  }
 
-    // return the absolute path of the source file
-    std::string moduleName = getSourceFileNameAbsPath(M);
-    moduleName = (moduleName.empty()) ? M.getModuleIdentifier() : moduleName;
+  /* Load an IR file in the context of M */
+  std::unique_ptr<Module> loadIR(Module &M, const std::string &filename) {
+    SMDiagnostic err;
+    std::unique_ptr<Module> _M = parseIRFile(filename, err, M.getContext());
+    if (_M.get() == nullptr) {
+      err.print(filename.c_str(), errs());
+      report_fatal_error("libVFCInstrument fatal error");
+    }
+    return _M;
+  }
+
+  /* Give an external hidden linkage to the internal variables of the static
+   * backend, so that the backend object and the copies of its functions
+   * imported in each instrumented module share the same state */
+  void externalizeStaticBackendGlobals(Module &M) {
+    for (auto &G : M.globals()) {
+      if (G.hasLocalLinkage() and not G.isConstant()) {
+        G.setName("__vfc_static_backend." + G.getName());
+        G.setLinkage(GlobalValue::ExternalLinkage);
+        G.setVisibility(GlobalValue::HiddenVisibility);
+      }
+    }
+  }
 
-    // Regex that contains all regex for each function
-    std::string moduleRegex = "";
+  /* True if the value V is, or uses, a variable or a function of tainted */
+  bool usesTainted(const Value *V, const std::set<const Value *> &tainted) {
+    if (tainted.count(V)) {
+      return true;
+    }
+    if (auto *C = dyn_cast<ConstantExpr>(V)) {
+      for (auto &Op : C->operands()) {
+        if (usesTainted(Op, tainted)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
 
-    while (std::getline(loopstream, line)) {
-      lineno++;
-      StringRef l = StringRef(line);
+  /* Import the definitions of the vfcwrapper and static backend functions
+   * called by M as available_externally functions. They are only used for
+   * inlining: the symbols are still resolved at link time by the vfcwrapper
+   * and static backend objects. Functions using internal variables of the
+   * vfcwrapper (e.g. ddebug state) are not imported, since each module would
+   * get its own copy of the variables. */
+  void importStaticBackend(Module &M) {
+    std::unique_ptr<Module> runtimeM = loadIR(M, VfclibInstStaticBackend);
+    externalizeStaticBackendGlobals(*runtimeM);
+    if (Linker::linkModules(*runtimeM, loadIR(M, VfclibInstVfcwrapper))) {
+      report_fatal_error(Twine("libVFCInstrument fatal error: cannot link ") +
+                         VfclibInstStaticBackend);
+    }
 
-      // Ignore empty or commented lines
-      if (STARTS_WITH(l, "#") || l.trim().empty()) {
-        continue;
+    /* constructors and the interflop_init aliases belong to the objects */
+    for (auto name : {"llvm.global_ctors", "llvm.global_dtors", "llvm.used",
+                      "llvm.compiler.used"}) {
+      if (GlobalVariable *G = runtimeM->getNamedGlobal(name)) {
+        G->eraseFromParent();
       }
-      std::pair<StringRef, StringRef> p = l.split(" ");
+    }
+    for (auto &A : make_early_inc_range(runtimeM->aliases())) {
+      A.replaceAllUsesWith(A.getAliasee());
+      A.eraseFromParent();
+    }
 
-      if (p.second.empty()) {
-        errs() << "Syntax error in exclusion/inclusion file " << fileName << ":"
-               << lineno << "\n";
-        report_fatal_error("libVFCInstrument fatal error");
-      } else {
-        std::string mod = p.first.trim().str();
-        std::string fun = p.second.trim().str();
+    std::set<std::string> runtimeNames;
+    for (auto &G : runtimeM->global_values()) {
+      if (not G.isDeclaration() and not G.hasLocalLinkage()) {
+        runtimeNames.insert(G.getName().str());
+      }
+    }
+
+    /* the linker renames the imported local values that clash with these */
+    std::set<std::string> moduleLocalNames;
+    for (auto &G : M.global_values()) {
+      if (G.hasLocalLinkage()) {
+        moduleLocalNames.insert(G.getName().str());
+      }
+    }
 
-        // If mod is not an absolute path,
-        // we search any module containing mod
-        if (sys::path::is_relative(mod)) {
-          mod = "*" + sys::path::get_separator().str() + mod;
+    if (Linker::linkModules(M, std::move(runtimeM),
+                            Linker::Flags::LinkOnlyNeeded)) {
+      report_fatal_error(Twine("libVFCInstrument fatal error: cannot link ") +
+                         VfclibInstStaticBackend);
+    }
+
+    /* True if G was imported from the runtime, the values of M are left
+     * untouched */
+    auto imported = [&](const GlobalValue &G) {
+      if (G.hasLocalLinkage()) {
+        return moduleLocalNames.count(G.getName().str()) == 0;
+      }
+      return runtimeNames.count(G.getName().str()) != 0;
+    };
+
+    /* Imported variables with a local state and the imported functions that
+     * use them */
+    std::set<const Value *> tainted;
+    for (auto &G : M.globals()) {
+      if (G.hasLocalLinkage() and not G.isConstant() and imported(G)) {
+        tainted.insert(&G);
+      }
+    }
+    for (bool changed = true; changed;) {
+      changed = false;
+      for (auto &F : M.functions()) {
+        if (tainted.count(&F) or F.isDeclaration() or not imported(F)) {
+          continue;
+        }
+        for (auto &I : instructions(F)) {
+          if (any_of(I.operands(),
+                     [&](const Use &U) { return usesTainted(U, tainted); })) {
+            tainted.insert(&F);
+            changed = true;
+            break;
+          }
         }
-        // If the user does not specify extension for the module
-        // we match any extension
-        if (not sys::path::has_extension(mod)) {
-          mod += ".*";
+      }
+    }
+
+    for (auto &F : M.functions()) {
+      if (F.hasLocalLinkage() or not imported(F) or F.isDeclaration()) {
+        continue;
+      }
+      if (tainted.count(&F)) {
+        F.deleteBody();
+      } else {
+        F.setLinkage(GlobalValue::AvailableExternallyLinkage);
+        F.setComdat(nullptr);
+      }
+    }
+    for (auto &G : make_early_inc_range(M.globals())) {
+      if (not G.hasLocalLinkage() and imported(G) and not G.isDeclaration()) {
+        G.setInitializer(nullptr);
+        G.setLinkage(GlobalValue::ExternalLinkage);
+        G.setComdat(nullptr);
+      } else if (tainted.count(&G)) {
+        G.removeDeadConstantUsers();
+        if (G.use_empty()) {
+          G.eraseFromParent();
         }
+      }
+    }
+  }
+
+  /* Returns the type name and the vector width of the operation I, or an
+   * empty name if I is not supported */
+  std::pair<std::string, unsigned> getOperationType(Instruction *I) {
+    Type *opType = I->getOperand(0)->getType();
+    unsigned width = 1;
+    if (auto *vecType = dyn_cast<FixedVectorType>(opType)) {
+      width = vecType->getNumElements();
+      if (validVectorSizes.find(width) == validVectorSizes.end()) {
+        return {"", width};
+      }
+    }
+    auto it = validTypesMap.find(opType->getScalarType()->getTypeID());
+    if (it == validTypesMap.end()) {
+      return {"", width};
+    }
+    return {it->second, width};
+  }
+
+  void writeOpReport(json::OStream &J, const OpReport &ops, bool profile) {
+    uint64_t instrumented = 0, skipped = 0, excluded = 0, dynamic = 0;
+    std::set<unsigned> widths;
+    for (auto &it : ops) {
+      instrumented += it.second.instrumented;
+      skipped += it.second.skipped;
+      excluded += it.second.excluded;
+      dynamic += it.second.dynamic;
+      widths.insert(std::get<2>(it.first));
+    }
+    J.attribute("instrumented", static_cast<int64_t>(instrumented));
+    J.attribute("skipped", static_cast<int64_t>(skipped));
+    J.attribute("excluded", static_cast<int64_t>(excluded));
+    if (profile) {
+      J.attribute("dynamic", static_cast<int64_t>(dynamic));
+    }
+    J.attributeArray("vector_widths", [&] {
+      for (unsigned width : widths) {
+        J.value(static_cast<int64_t>(width));
+      }
+    });
+    J.attributeArray("operations", [&] {
+      for (auto &it : ops) {
+        J.object([&] {
+          J.attribute("op", Fops2str[std::get<0>(it.first)]);
+          J.attribute("type", std::get<1>(it.first));
+          J.attribute("width", static_cast<int64_t>(std::get<2>(it.first)));
+          J.attribute("instrumented",
+                      static_cast<int64_t>(it.second.instrumented));
+          J.attribute("skipped", static_cast<int64_t>(it.second.skipped));
+          J.attribute("excluded", static_cast<int64_t>(it.second.excluded));
+          if (profile) {
+            J.attribute("dynamic", static_cast<int64_t>(it.second.dynamic));
+          }
+        });
+      }
+    });
+  }
 
-        escape_regex(mod);
-        escape_regex(fun);
+  /* Report the operations of F and of its loops. Operations of a loop are
+   * also counted in its parent loops. Dynamic counts are estimated from the
+   * block frequencies when F has profile data (-fprofile-use). */
+  void writeFunctionReport(json::OStream &J, Function &F, bool selected) {
+    DominatorTree DT(F);
+    LoopInfo LI(DT);
+    const bool profile = F.hasProfileData();
+    std::unique_ptr<BranchProbabilityInfo> BPI;
+    std::unique_ptr<BlockFrequencyInfo> BFI;
+    if (profile) {
+      BPI = std::make_unique<BranchProbabilityInfo>(F, LI);
+      BFI = std::make_unique<BlockFrequencyInfo>(F, *BPI, LI);
+    }
 
-        if (std::regex_match(moduleName, std::regex(mod))) {
-          moduleRegex += fun + "|";
+    OpReport functionOps;
+    std::map<Loop *, OpReport> loopOps;
+    for (auto &B : F) {
+      uint64_t count = 0;
+      if (profile) {
+        if (auto blockCount = BFI->getBlockProfileCount(&B)) {
+          count = *blockCount;
+        }
+      }
+      for (auto &I : B) {
+        FPOps opCode = mustReplace(I);
+        if (opCode == FOP_IGNORE) {
+          continue;
+        }
+        auto type = getOperationType(&I);
+        if (type.first.empty()) {
+          continue;
+        }
+        OpKey key = std::make_tuple(opCode, type.first, type.second);
+        std::vector<OpCounters *> counters = {&functionOps[key]};
+        for (Loop *L = LI.getLoopFor(&B); L; L = L->getParentLoop()) {
+          counters.push_back(&loopOps[L][key]);
+        }
+        for (auto *C : counters) {
+          if (not selected) {
+            C->excluded++;
+          } else if (VfclibInstSkipExact != SkipExactNone and
+                     isExactOperation(I, opCode)) {
+            C->skipped++;
+          } else {
+            C->instrumented++;
+            C->dynamic += count;
+          }
         }
       }
     }
 
-    loopstream.close();
-    // Remove the extra | at the end
-    if (not moduleRegex.empty()) {
-      moduleRegex.pop_back();
+    if (functionOps.empty()) {
+      return;
     }
-    return std::regex(moduleRegex);
+
+    J.object([&] {
+      J.attribute("name", F.getName());
+      J.attribute("selected", selected);
+      if (profile) {
+        J.attribute("entry_count",
+                    static_cast<int64_t>(F.getEntryCount()->getCount()));
+      }
+      writeOpReport(J, functionOps, profile);
+      J.attributeArray("loops", [&] {
+        for (Loop *L : LI.getLoopsInPreorder()) {
+          if (loopOps.find(L) == loopOps.end()) {
+            continue;
+          }
+          J.object([&] {
+            J.attribute("header", L->getHeader()->getName());
+            if (DebugLoc loc = L->getStartLoc()) {
+              J.attribute("line", static_cast<int64_t>(loc.getLine()));
+            }
+            J.attribute("depth", static_cast<int64_t>(L->getLoopDepth()));
+            writeOpReport(J, loopOps[L], profile);
+          });
+        }
+      });
+    });
   }
 
-  /* Load vfcwrapper.ll Module */
-  void loadVfcwrapperIR(Module &M) {
-    SMDiagnostic err;
-    std::unique_ptr<Module> _M =
-        parseIRFile(VfclibInstVfcwrapper, err, M.getContext());
-    if (_M.get() == nullptr) {
-      err.print(VfclibInstVfcwrapper.c_str(), errs());
+  /* Write the instrumentation report of M, functions are the functions
+   * selected for instrumentation */
+  void writeReport(Module &M, const std::vector<Function *> &functions) {
+    std::error_code EC;
+    raw_fd_ostream out(VfclibInstReportFile, EC, sys::fs::OF_Text);
+    if (EC) {
+      errs() << "Cannot open " << VfclibInstReportFile << ": " << EC.message()
+             << "\n";
       report_fatal_error("libVFCInstrument fatal error");
     }
-    vfcwrapperM = _M.release();
+
+    json::OStream J(out, 2);
+    J.object([&] {
+      J.attribute("module", M.getSourceFileName());
+      J.attributeArray("functions", [&] {
+        for (auto &F : M.functions()) {
+          if (F.isDeclaration()) {
+            continue;
+          }
+          bool selected = std::find(functions.begin(), functions.end(), &F) !=
+                          functions.end();
+          writeFunctionReport(J, F, selected);
+        }
+      });
+    });
+    out << "\n";
   }
 
   bool runOnModule(Module &M) {
     bool modified = false;
 
+    if (VfclibInstStaticBackendPrepare) {
+      externalizeStaticBackendGlobals(M);
+      return true;
+    }
+
     loadVfcwrapperIR(M);
 
     // Parse both included and excluded function set
-    std::regex includeFunctionRgx =
+    FunctionSet includeFunctions =
         parseFunctionSetFile(M, VfclibInstIncludeFile);
-    std::regex excludeFunctionRgx =
+    FunctionSet excludeFunctions =
         parseFunctionSetFile(M, VfclibInstExcludeFile);
 
     // Parse instrument single function option (--function)
     if (not VfclibInstFunction.empty()) {
-      includeFunctionRgx = std::regex(VfclibInstFunction);
-      excludeFunctionRgx = std::regex(".*");
+      includeFunctions = FunctionSet();
+      includeFunctions.addRegex(VfclibInstFunction);
+      excludeFunctions = FunctionSet();
+      excludeFunctions.addPattern("*");
     }
 
     // Find the list of functions to instrument
     std::vector<Function *> functions;
     for (auto &F : M.functions()) {
 
-      const std::string &name = F.getName().str();
+      StringRef name = F.getName();
 
       // Included-list
-      if (std::regex_match(name, includeFunctionRgx)) {
+      if (includeFunctions.match(name)) {
         functions.push_back(&F);
         continue;
       }
 
       // Excluded-list
-      if (std::regex_match(name, excludeFunctionRgx)) {
+      if (excludeFunctions.match(name)) {
         continue;
       }
 
@@ -303,10 +654,32 @@ struct VfclibInst : public ModulePass {
         functions.push_back(&F);
       }
     }
+    // Report the operations before they are replaced
+    if (not VfclibInstReportFile.empty()) {
+      writeReport(M, functions);
+    }
+
     // Do the instrumentation on selected functions
     for (auto F : functions) {
+      if (VfclibInstBatchLoops) {
+        modified |= batchLoops(M, *F);
+      }
       modified |= runOnFunction(M, *F);
     }
+
+    if (not VfclibInstStaticBackend.empty()) {
+      importStaticBackend(M);
+      modified = true;
+    }
+
+    if (VfclibInstVerbose and VfclibInstSkipExact != SkipExactNone) {
+      errs() << "Provably exact operations not instrumented:";
+      for (int op = 0; op < FOP_IGNORE; op++) {
+        errs() << " " << Fops2str[op] << "=" << skippedExactOps[op] << "/"
+               << skippedExactOps[op] + instrumentedOps[op];
+      }
+      errs() << "\n";
+    }
     // runOnModule must return true if the pass modifies the IR
     return modified;
   }
@@ -646,6 +1019,441 @@ struct VfclibInst : public ModulePass {
     }
   }
 
+  /* Returns the scalar value of V if V is a floating-point constant or a
+   * splat vector constant, nullptr otherwise */
+  const APFloat *getConstantFP(Value *V) {
+    auto *C = dyn_cast<Constant>(V);
+    if (C and V->getType()->isVectorTy()) {
+      C = C->getSplatValue();
+    }
+    if (auto *CFP = dyn_cast_or_null<ConstantFP>(C)) {
+      return &CFP->getValueAPF();
+    }
+    return nullptr;
+  }
+
+  /* Returns true and sets k if |C| = 2^k */
+  bool isPowerOfTwo(const APFloat &C, int &k) {
+    if (not C.isFiniteNonZero()) {
+      return false;
+    }
+    APFloat m = frexp(C, k, APFloat::rmNearestTiesToEven);
+    m.clearSign();
+    k--;
+    return m.compare(APFloat(m.getSemantics(), "0.5")) == APFloat::cmpEqual;
+  }
+
+  /* Precision (including the implicit bit) of the floating-point type Ty */
+  int getPrecision(Type *Ty) {
+    return APFloat::semanticsPrecision(Ty->getScalarType()->getFltSemantics());
+  }
+
+  /* Returns b if V is an integer of magnitude lower than 2^b, -1 if it cannot
+   * be proven. If arithmetic is true, integers computed by exact additions,
+   * subtractions and multiplications are also recognized. */
+  int getIntegerBits(Value *V, const DataLayout &DL, bool arithmetic,
+                     unsigned depth = 0) {
+    const unsigned maxDepth = 6;
+    if (const APFloat *C = getConstantFP(V)) {
+      if (not C->isInteger() or C->isInfinity() or C->isNaN()) {
+        return -1;
+      }
+      return C->isZero() ? 0 : ilogb(*C) + 1;
+    }
+
+    auto *I = dyn_cast<Instruction>(V);
+    if (I == nullptr or depth >= maxDepth) {
+      return -1;
+    }
+
+    int a, b;
+    int precision = getPrecision(I->getType());
+    switch (I->getOpcode()) {
+    case Instruction::UIToFP:
+      return computeKnownBits(I->getOperand(0), DL).countMaxActiveBits();
+    case Instruction::SIToFP:
+      return ComputeMaxSignificantBits(I->getOperand(0), DL);
+    case Instruction::FPExt:
+    case Instruction::FNeg:
+      return getIntegerBits(I->getOperand(0), DL, arithmetic, depth + 1);
+    case Instruction::FAdd:
+    case Instruction::FSub:
+      if (not arithmetic) {
+        return -1;
+      }
+      a = getIntegerBits(I->getOperand(0), DL, arithmetic, depth + 1);
+      b = getIntegerBits(I->getOperand(1), DL, arithmetic, depth + 1);
+      if (a < 0 or b < 0 or std::max(a, b) + 1 > precision) {
+        return -1;
+      }
+      return std::max(a, b) + 1;
+    case Instruction::FMul:
+      if (not arithmetic) {
+        return -1;
+      }
+      a = getIntegerBits(I->getOperand(0), DL, arithmetic, depth + 1);
+      b = getIntegerBits(I->getOperand(1), DL, arithmetic, depth + 1);
+      if (a < 0 or b < 0 or a + b > precision) {
+        return -1;
+      }
+      return a + b;
+    default:
+      return -1;
+    }
+  }
+
+  /* Returns true if the result of I is provably exact for any input:
+   *  - zero: the result is a zero or a NaN (x - x, x * 0), which is exact at
+   *    any virtual precision.
+   *  - native: the result is an operand, its opposite, an operand scaled by a
+   *    power of two without underflow (x + 0, x + x, 2 * x), or the sum or
+   *    product of small integers. These results are exact in the native
+   *    format, but backends working at a lower virtual precision would still
+   *    round them. */
+  bool isExactOperation(Instruction &I, FPOps opCode) {
+    const DataLayout &DL = I.getModule()->getDataLayout();
+    const bool native = VfclibInstSkipExact == SkipExactNative;
+    Value *A = I.getOperand(0);
+    Value *B = I.getNumOperands() > 1 ? I.getOperand(1) : nullptr;
+    const APFloat *CA = getConstantFP(A);
+    const APFloat *CB = B ? getConstantFP(B) : nullptr;
+    int k;
+
+    switch (opCode) {
+    case FOP_ADD:
+    case FOP_SUB:
+      // x - x
+      if (opCode == FOP_SUB and A == B) {
+        return true;
+      }
+      if (not native) {
+        return false;
+      }
+      // x + x, x + 0, 0 + x, x - 0, 0 - x
+      if (A == B or (CA and CA->isZero()) or (CB and CB->isZero())) {
+        return true;
+      }
+      return getIntegerBits(&I, DL, true) >= 0;
+    case FOP_MUL:
+    case FOP_DIV:
+      if (opCode == FOP_MUL and CB == nullptr) {
+        std::swap(A, B);
+        std::swap(CA, CB);
+      }
+      if (CB and opCode == FOP_MUL and CB->isZero()) {
+        return true;
+      }
+      if (not native) {
+        return false;
+      }
+      if (CB and isPowerOfTwo(*CB, k)) {
+        k = (opCode == FOP_DIV) ? -k : k;
+        // upscaling is exact or overflows to infinity
+        if (k >= 0) {
+          return true;
+        }
+        // a non-zero integer downscaled by 2^k is normal if k >= emin
+        if (k >= APFloat::semanticsMinExponent(CB->getSemantics()) and
+            getIntegerBits(A, DL, true) >= 0) {
+          return true;
+        }
+      }
+      return opCode == FOP_MUL and getIntegerBits(&I, DL, true) >= 0;
+    case FOP_CAST:
+      if (not native) {
+        return false;
+      }
+      // (float)(double)x
+      if (auto *Ext = dyn_cast<FPExtInst>(A)) {
+        return Ext->getSrcTy() == I.getType();
+      }
+      k = getIntegerBits(A, DL, true);
+      return k >= 0 and k <= getPrecision(I.getType());
+    default:
+      return false;
+    }
+  }
+
+  /* Returns the affine recurrence {start,+,step} of the address Ptr in L, or
+   * nullptr if Ptr is not an affine function of the loop iterations */
+  const SCEVAddRecExpr *getAddRec(ScalarEvolution &SE, Loop *L, Value *Ptr) {
+    auto *AR = dyn_cast<SCEVAddRecExpr>(SE.getSCEV(Ptr));
+    if (AR == nullptr or AR->getLoop() != L or not AR->isAffine()) {
+      return nullptr;
+    }
+    return AR;
+  }
+
+  /* Returns the constant value of S, or nullopt */
+  std::optional<int64_t> getConstant(const SCEV *S) {
+    if (auto *C = dyn_cast<SCEVConstant>(S)) {
+      return C->getAPInt().getSExtValue();
+    }
+    return std::nullopt;
+  }
+
+  /* True if V is a simple load of L only used by the instruction User */
+  bool isLoadFor(Value *V, Loop *L, Instruction *User) {
+    auto *Load = dyn_cast<LoadInst>(V);
+    return Load and Load->isSimple() and L->contains(Load) and
+           all_of(Load->users(), [&](const auto *U) { return U == User; });
+  }
+
+  /* Batch the loop L if it is a map or a reduction:
+   *   map:    c[i] = a[i] op b[i], possibly vectorized and interleaved by the
+   *           loop vectorizer. All the operations of the loop are the same
+   *           operation on the same type, and their loads and stores cover
+   *           contiguous elements.
+   *   reduce: s = s op a[i], on scalars.
+   * The batched wrapper is called in the preheader, the operations and
+   * memory accesses are removed from the loop, which is left empty and
+   * deleted by batchLoops. */
+  bool batchLoop(Module &M, Loop *L, ScalarEvolution &SE, DominatorTree &DT) {
+    BasicBlock *preheader = L->getLoopPreheader();
+    BasicBlock *body = L->getHeader();
+    if (preheader == nullptr or L->getNumBlocks() != 1 or
+        L->getExitingBlock() != body) {
+      return false;
+    }
+    const SCEV *BTC = SE.getBackedgeTakenCount(L);
+    if (isa<SCEVCouldNotCompute>(BTC)) {
+      return false;
+    }
+
+    // Collect the operations, all stores must store one of them
+    std::vector<Instruction *> ops;
+    std::vector<StoreInst *> stores;
+    for (auto &I : *body) {
+      FPOps opCode = mustReplace(I);
+      if (opCode != FOP_IGNORE) {
+        if (opCode > FOP_DIV or
+            (not ops.empty() and (I.getOpcode() != ops[0]->getOpcode() or
+                                  I.getType() != ops[0]->getType())) or
+            (VfclibInstSkipExact != SkipExactNone and
+             isExactOperation(I, opCode)) or
+            getOperationType(&I).first.empty()) {
+          return false;
+        }
+        ops.push_back(&I);
+      } else if (auto *Store = dyn_cast<StoreInst>(&I)) {
+        if (not Store->isSimple()) {
+          return false;
+        }
+        stores.push_back(Store);
+      } else if (isa<DbgInfoIntrinsic>(I)) {
+        continue;
+      } else if (I.mayHaveSideEffects() or
+                 (isa<LoadInst>(I) and not cast<LoadInst>(I).isSimple())) {
+        return false;
+      }
+    }
+    if (ops.empty()) {
+      return false;
+    }
+
+    const DataLayout &DL = M.getDataLayout();
+    LLVMContext &C = M.getContext();
+    Instruction *op = ops[0];
+    FPOps opCode = mustReplace(*op);
+    Type *scalarType = op->getType()->getScalarType();
+    Type *ptrType = PointerType::getUnqual(scalarType);
+    Type *longType = DL.getIntPtrType(C);
+    const int64_t elementSize = DL.getTypeStoreSize(scalarType);
+    const std::string name =
+        "_" + validTypesMap[scalarType->getTypeID()] + Fops2str[opCode];
+    SCEVExpander expander(SE, DL, "vfc.batch");
+    Instruction *insertPoint = preheader->getTerminator();
+    IRBuilder<> Builder(insertPoint);
+
+    // number of iterations of the loop, in elements
+    auto getCount = [&](int64_t elementsPerIteration) {
+      const SCEV *count = SE.getAddExpr(SE.getZeroExtendExpr(BTC, longType),
+                                        SE.getOne(longType));
+      count = SE.getMulExpr(count,
+                            SE.getConstant(longType, elementsPerIteration));
+      return expander.expandCodeFor(count, longType, insertPoint);
+    };
+
+    auto *PN = dyn_cast<PHINode>(op->getOperand(0));
+    if (stores.empty() and ops.size() == 1 and not op->getType()->isVectorTy()) {
+      // Reduction s = s op a[i], s op is commutative for add and mul
+      Value *x = op->getOperand(1);
+      if ((PN == nullptr or PN->getParent() != body) and
+          (opCode == FOP_ADD or opCode == FOP_MUL)) {
+        PN = dyn_cast<PHINode>(op->getOperand(1));
+        x = op->getOperand(0);
+      }
+      if (PN == nullptr or PN->getParent() != body or
+          PN->getNumIncomingValues() != 2 or
+          PN->getIncomingValueForBlock(body) != op or not PN->hasOneUse() or
+          not isLoadFor(x, L, op)) {
+        return false;
+      }
+      auto *Load = cast<LoadInst>(x);
+      const SCEVAddRecExpr *AR = getAddRec(SE, L, Load->getPointerOperand());
+      if (AR == nullptr or
+          getConstant(AR->getStepRecurrence(SE)) != elementSize) {
+        return false;
+      }
+      for (auto *U : op->users()) {
+        auto *UI = cast<Instruction>(U);
+        if (UI != PN and (L->contains(UI) or
+                          (not isa<PHINode>(UI) and
+                           not DT.dominates(preheader, UI->getParent())))) {
+          return false;
+        }
+      }
+
+      Value *a = expander.expandCodeFor(
+          AR->getStart(), Load->getPointerOperandType(), insertPoint);
+      Value *n = getCount(1);
+      FunctionCallee F = M.getOrInsertFunction(
+          name + "_reduce", scalarType, scalarType, ptrType, longType);
+      Value *s = Builder.CreateCall(
+          F, {PN->getIncomingValueForBlock(preheader),
+              Builder.CreatePointerCast(a, ptrType), n});
+      op->replaceUsesWithIf(s, [&](Use &U) {
+        return not L->contains(cast<Instruction>(U.getUser()));
+      });
+      PN->replaceAllUsesWith(UndefValue::get(PN->getType()));
+      op->eraseFromParent();
+      PN->eraseFromParent();
+      Load->eraseFromParent();
+    } else {
+      // Map c[i] = a[i] op b[i]
+      if (stores.size() != ops.size()) {
+        return false;
+      }
+      const unsigned width =
+          op->getType()->isVectorTy()
+              ? cast<FixedVectorType>(op->getType())->getNumElements()
+              : 1;
+      const int64_t opSize = elementSize * width;
+      const int64_t step = opSize * ops.size();
+
+      // The recurrences of a, b and c, ordered by their offset in c
+      std::vector<std::array<const SCEVAddRecExpr *, 3>> streams;
+      for (auto *I : ops) {
+        auto *Store = dyn_cast<StoreInst>(*I->user_begin());
+        if (not I->hasOneUse() or Store == nullptr or
+            Store->getValueOperand() != I or
+            not isLoadFor(I->getOperand(0), L, I) or
+            not isLoadFor(I->getOperand(1), L, I)) {
+          return false;
+        }
+        std::array<const SCEVAddRecExpr *, 3> stream = {
+            getAddRec(SE, L, getLoadStorePointerOperand(I->getOperand(0))),
+            getAddRec(SE, L, getLoadStorePointerOperand(I->getOperand(1))),
+            getAddRec(SE, L, Store->getPointerOperand())};
+        for (auto *AR : stream) {
+          if (AR == nullptr or getConstant(AR->getStepRecurrence(SE)) != step) {
+            return false;
+          }
+        }
+        streams.push_back(stream);
+      }
+      auto offset = [&](const SCEVAddRecExpr *AR, const SCEVAddRecExpr *Base) {
+        return getConstant(SE.getMinusSCEV(AR->getStart(), Base->getStart()));
+      };
+      std::vector<std::pair<int64_t, size_t>> order;
+      for (size_t j = 0; j < streams.size(); j++) {
+        auto off = offset(streams[j][2], streams[0][2]);
+        if (not off) {
+          return false;
+        }
+        order.push_back({*off, j});
+      }
+      std::sort(order.begin(), order.end());
+      const auto &first = streams[order[0].second];
+      for (size_t j = 0; j < order.size(); j++) {
+        const auto &stream = streams[order[j].second];
+        for (int k = 0; k < 3; k++) {
+          if (offset(stream[k], first[k]) != static_cast<int64_t>(j) * opSize) {
+            return false;
+          }
+        }
+      }
+
+      std::vector<Value *> args;
+      for (int k = 0; k < 3; k++) {
+        Value *ptr = expander.expandCodeFor(
+            first[k]->getStart(), first[k]->getStart()->getType(), insertPoint);
+        args.push_back(Builder.CreatePointerCast(ptr, ptrType));
+      }
+      args.push_back(getCount(width * ops.size()));
+      FunctionCallee F =
+          M.getOrInsertFunction(name + "_batch", Type::getVoidTy(C), ptrType,
+                                ptrType, ptrType, longType);
+      Builder.CreateCall(F, args);
+
+      for (size_t j = 0; j < ops.size(); j++) {
+        Instruction *I = ops[j];
+        auto *A = cast<Instruction>(I->getOperand(0));
+        auto *B = cast<Instruction>(I->getOperand(1));
+        stores[j]->eraseFromParent();
+        I->eraseFromParent();
+        A->eraseFromParent();
+        if (B != A) {
+          B->eraseFromParent();
+        }
+      }
+    }
+
+    SE.forgetLoop(L);
+    NumBatchedLoops++;
+    if (VfclibInstVerbose) {
+      errs() << "Batched loop " << body->getName() << " of "
+             << body->getParent()->getName() << " with " << name << "\n";
+    }
+    return true;
+  }
+
+  /* Delete the loop L emptied by batchLoop. Only its control flow is left,
+   * its values must not be used after the loop. At optimizer-last no later
+   * pass would delete it. */
+  bool deleteBatchedLoop(Loop *L, DominatorTree &DT, ScalarEvolution &SE,
+                         LoopInfo &LI) {
+    if (L->getUniqueExitBlock() == nullptr) {
+      return false;
+    }
+    for (auto *BB : L->blocks()) {
+      for (auto &I : *BB) {
+        if (I.mayHaveSideEffects() or
+            any_of(I.users(), [&](const User *U) {
+              return not L->contains(cast<Instruction>(U));
+            })) {
+          return false;
+        }
+      }
+    }
+    deleteDeadLoop(L, &DT, &SE, &LI);
+    return true;
+  }
+
+  /* Batch the simple innermost loops of F */
+  bool batchLoops(Module &M, Function &F) {
+    if (F.isDeclaration()) {
+      return false;
+    }
+    DominatorTree DT(F);
+    LoopInfo LI(DT);
+    TargetLibraryInfoImpl TLII(Triple(M.getTargetTriple()));
+    TargetLibraryInfo TLI(TLII);
+    AssumptionCache AC(F);
+    ScalarEvolution SE(F, TLI, AC, DT, LI);
+
+    bool modified = false;
+    for (Loop *L : LI.getLoopsInPreorder()) {
+      if (L->isInnermost()) {
+        if (batchLoop(M, L, SE, DT)) {
+          deleteBatchedLoop(L, DT, SE, LI);
+          modified = true;
+        }
+      }
+    }
+    return modified;
+  }
+
   bool runOnBasicBlock(Module &M, BasicBlock &B) {
     bool modified = false;
     std::set<std::pair<Instruction *, FPOps>> WorkList;
@@ -654,6 +1462,16 @@ struct VfclibInst : public ModulePass {
       FPOps opCode = mustReplace(I);
       if (opCode == FOP_IGNORE)
         continue;
+      if (VfclibInstSkipExact != SkipExactNone and
+          isExactOperation(I, opCode)) {
+        if (VfclibInstVerbose)
+          errs() << "Skipping exact" << I << '\n';
+        skippedExactOps[opCode]++;
+        NumSkippedExact++;
+        continue;
+      }
+      instrumentedOps[opCode]++;
+      NumInstrumented++;
       WorkList.insert(std::make_pair(&I, opCode));
     }
 
@@ -687,6 +1505,21 @@ struct VfclibInstPass : public PassInfoMixin<VfclibInstPass> {
     return PreservedAnalyses::none();
   }
 };
+
+/* Add the pass to MPM if EP is the -vfclibinst-extension-point */
+void addVfclibInstPass(PassBuilder &PB, ModulePassManager &MPM,
+                       OptimizationLevel Level, ExtensionPoint EP) {
+  if (VfclibInstExtensionPoint != EP) {
+    return;
+  }
+  MPM.addPass(VfclibInstPass());
+  // After the inliner of the default pipeline, inline the static backend
+  // functions into the instrumented code, as a second compilation of the
+  // instrumented IR would
+  if (EP != EPPipelineStart and Level != OptimizationLevel::O0) {
+    MPM.addPass(PB.buildInlinerPipeline(Level, ThinOrFullLTOPhase::None));
+  }
+}
 } // namespace
 
 extern "C" LLVM_ATTRIBUTE_WEAK PassPluginLibraryInfo llvmGetPassPluginInfo() {
@@ -701,5 +1534,20 @@ extern "C" LLVM_ATTRIBUTE_WEAK PassPluginLibraryInfo llvmGetPassPluginInfo() {
                   }
                   return false;
                 });
+            PB.registerPipelineStartEPCallback(
+                [&PB](ModulePassManager &MPM, OptimizationLevel Level) {
+                  addVfclibInstPass(PB, MPM, Level, EPPipelineStart);
+                });
+            // LLVM 20 adds the LTO phase to the callback arguments
+            PB.registerOptimizerEarlyEPCallback(
+                [&PB](ModulePassManager &MPM, OptimizationLevel Level,
+                      auto...) {
+                  addVfclibInstPass(PB, MPM, Level, EPOptimizerEarly);
+                });
+            PB.registerOptimizerLastEPCallback(
+                [&PB](ModulePassManager &MPM, OptimizationLevel Level,
+                      auto...) {
+                  addVfclibInstPass(PB, MPM, Level, EPOptimizerLast);
+                });
           }};
 }
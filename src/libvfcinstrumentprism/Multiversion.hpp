@@ -0,0 +1,252 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *                                                                           *\
+ *  Copyright (c) 2026                                                       *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+// Function-pointer tables of the multiversion dispatch.
+//
+// Each operator used by a module gets a global pointer, initialized with
+// the operator of the dynamic library. A module constructor checks once if
+// the CPU supports the target features of the static library and, if so,
+// replaces the pointers with the static operators. Calls are then indirect
+// calls through the pointers, without the per-call target selection of the
+// dynamic dispatch.
+//
+// Static vector operators take their operands by value, with an ABI that
+// depends on their target features. They are called through wrappers that
+// have the by-pointer signature of the dynamic operators and the target
+// features of the static library.
+
+#ifndef VERIFICARLO_LIBVFCINSTRUMENTPRISM_MULTIVERSION_HPP
+#define VERIFICARLO_LIBVFCINSTRUMENTPRISM_MULTIVERSION_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/InlineAsm.h>
+#include <llvm/IR/Module.h>
+#if LLVM_VERSION_MAJOR >= 16
+#include <llvm/TargetParser/Triple.h>
+#else
+#include <llvm/ADT/Triple.h>
+#endif
+#include <llvm/Transforms/Utils/ModuleUtils.h>
+
+#include "TargetFeatures.hpp"
+
+using namespace llvm;
+
+class MultiversionTable {
+public:
+  explicit MultiversionTable(Module &M) : M(M) {}
+
+  /* Returns the pointer to the version of Dynamic selected at load time,
+   * nullptr if Static cannot replace Dynamic */
+  auto getTable(Function *Dynamic, Function *Static) -> GlobalVariable * {
+    auto it = tables.find(Dynamic);
+    if (it != tables.end()) {
+      return it->second;
+    }
+
+    GlobalVariable *table = nullptr;
+    Function *version = getVersion(Dynamic, Static);
+    // Static is not registered if the CPU cannot be checked for one of its
+    // features, the dynamic dispatch is used instead
+    auto mask = (version != nullptr)
+                    ? getCpuSupportsMask_X86_64(TargetFeatures(
+                          Static->getFnAttribute("target-features")))
+                    : std::nullopt;
+    // cpuid clobbers ebx, the PIC register of 32-bit x86
+    if (mask.has_value() and not mask->cpuid.empty() and
+        not Triple(M.getTargetTriple()).isArch64Bit()) {
+      mask = std::nullopt;
+    }
+    if (mask.has_value()) {
+      table = createTable(Dynamic, version, *mask);
+    }
+    tables[Dynamic] = table;
+    return table;
+  }
+
+private:
+  Module &M;
+  std::map<Function *, GlobalVariable *> tables;
+  /* constructor selecting the versions */
+  Function *init = nullptr;
+  /* CPU features word, loaded by init */
+  Value *cpuFeatures = nullptr;
+  /* cpuid words, read by init */
+  std::map<CpuidWord, Value *> cpuidWords;
+
+  /* Returns Static if it has the signature of Dynamic, a wrapper with the
+   * signature of Dynamic if Dynamic takes its operands by pointer and Static
+   * by value, nullptr otherwise */
+  auto getVersion(Function *Dynamic, Function *Static) -> Function * {
+    // __cpu_model is only filled on x86
+    if (Static == nullptr or not Triple(M.getTargetTriple()).isX86()) {
+      return nullptr;
+    }
+    FunctionType *dynamicTy = Dynamic->getFunctionType();
+    FunctionType *staticTy = Static->getFunctionType();
+    if (dynamicTy == staticTy) {
+      return Static;
+    }
+    if (not dynamicTy->getReturnType()->isVoidTy() or
+        staticTy->getReturnType()->isVoidTy() or
+        dynamicTy->getNumParams() != staticTy->getNumParams() + 1) {
+      return nullptr;
+    }
+    for (auto *paramTy : dynamicTy->params()) {
+      if (not paramTy->isPointerTy()) {
+        return nullptr;
+      }
+    }
+    return createWrapper(Dynamic, Static);
+  }
+
+  /* Wrapper loading the operands of Static and storing its result */
+  auto createWrapper(Function *Dynamic, Function *Static) -> Function * {
+    const std::string name = "vfc_prism_mv_" + Static->getName().str();
+    if (auto *wrapper = M.getFunction(name)) {
+      return wrapper;
+    }
+    auto *wrapper =
+        Function::Create(Dynamic->getFunctionType(),
+                         GlobalValue::LinkOnceODRLinkage, name, M);
+    wrapper->setVisibility(GlobalValue::HiddenVisibility);
+    for (const char *kind : {"target-cpu", "target-features"}) {
+      if (Static->hasFnAttribute(kind)) {
+        wrapper->addFnAttr(Static->getFnAttribute(kind));
+      }
+    }
+
+    IRBuilder<> Builder(BasicBlock::Create(M.getContext(), "entry", wrapper));
+    FunctionType *staticTy = Static->getFunctionType();
+    SmallVector<Value *, 4> operands;
+    for (unsigned i = 0; i < staticTy->getNumParams(); i++) {
+      Type *operandTy = staticTy->getParamType(i);
+      Value *pointer = Builder.CreateBitCast(wrapper->getArg(i),
+                                             operandTy->getPointerTo());
+      operands.push_back(Builder.CreateLoad(operandTy, pointer));
+    }
+    Value *result = Builder.CreateCall(Static, operands);
+    Value *resultPointer = Builder.CreateBitCast(
+        wrapper->getArg(staticTy->getNumParams()),
+        result->getType()->getPointerTo());
+    Builder.CreateStore(result, resultPointer);
+    Builder.CreateRetVoid();
+    return wrapper;
+  }
+
+  /* Creates the constructor and loads the CPU features word */
+  void createInit() {
+    auto &C = M.getContext();
+    init = Function::Create(FunctionType::get(Type::getVoidTy(C), false),
+                            GlobalValue::InternalLinkage,
+                            "vfc_prism_mv_init", M);
+    IRBuilder<> Builder(BasicBlock::Create(C, "entry", init));
+    Builder.CreateRetVoid();
+    Builder.SetInsertPoint(init->getEntryBlock().getTerminator());
+
+    // __builtin_cpu_init(); the constructor of libgcc or compiler-rt may not
+    // have run yet
+    auto cpuInit = M.getOrInsertFunction(
+        "__cpu_indicator_init", FunctionType::get(Type::getVoidTy(C), false));
+    Builder.CreateCall(cpuInit);
+
+    auto *int32Ty = Type::getInt32Ty(C);
+    auto *cpuModelTy = StructType::get(int32Ty, int32Ty, int32Ty,
+                                       ArrayType::get(int32Ty, 1));
+    Constant *cpuModel = M.getOrInsertGlobal("__cpu_model", cpuModelTy);
+    Value *features =
+        Builder.CreateConstInBoundsGEP2_32(cpuModelTy, cpuModel, 0, 3);
+    cpuFeatures = Builder.CreateLoad(
+        int32Ty, Builder.CreateBitCast(features, int32Ty->getPointerTo()));
+
+    appendToGlobalCtors(M, init, 0);
+  }
+
+  /* Emits cpuid for leaf and subleaf, returns eax, ebx, ecx and edx */
+  static auto createCpuid(IRBuilder<> &Builder, uint32_t leaf,
+                          uint32_t subleaf) -> Value * {
+    auto *int32Ty = Builder.getInt32Ty();
+    auto *cpuidTy = FunctionType::get(
+        StructType::get(int32Ty, int32Ty, int32Ty, int32Ty),
+        {int32Ty, int32Ty}, false);
+    auto *cpuid = InlineAsm::get(
+        cpuidTy, "cpuid",
+        "={ax},={bx},={cx},={dx},0,2,~{dirflag},~{fpsr},~{flags}", false);
+    return Builder.CreateCall(
+        cpuid, {Builder.getInt32(leaf), Builder.getInt32(subleaf)});
+  }
+
+  /* Reads the cpuid word in init, 0 if the CPU does not have its leaf */
+  auto getCpuidWord(const CpuidWord &word) -> Value * {
+    auto it = cpuidWords.find(word);
+    if (it != cpuidWords.end()) {
+      return it->second;
+    }
+    IRBuilder<> Builder(init->getEntryBlock().getTerminator());
+    const auto [leaf, subleaf, reg] = word;
+    Value *value = Builder.CreateExtractValue(
+        createCpuid(Builder, leaf, subleaf), reg);
+    // leaves 0 and 0x80000000 give the highest basic and extended leaves
+    const uint32_t baseLeaf = leaf & 0x80000000U;
+    if (leaf != baseLeaf) {
+      Value *maxLeaf = getCpuidWord({baseLeaf, 0, 0});
+      Value *hasLeaf = Builder.CreateICmpULE(Builder.getInt32(leaf), maxLeaf);
+      value = Builder.CreateSelect(hasLeaf, value, Builder.getInt32(0));
+    }
+    cpuidWords[word] = value;
+    return value;
+  }
+
+  /* Creates the pointer to Dynamic, replaced by Version by the constructor
+   * if the CPU has the features of mask */
+  auto createTable(Function *Dynamic, Function *Version,
+                   const CpuFeaturesMask &mask) -> GlobalVariable * {
+    auto *table = new GlobalVariable(
+        M, Dynamic->getType(), false, GlobalValue::LinkOnceODRLinkage, Dynamic,
+        "vfc_prism_mv_table_" + Dynamic->getName().str());
+    table->setVisibility(GlobalValue::HiddenVisibility);
+
+    if (init == nullptr) {
+      createInit();
+    }
+    std::vector<std::pair<Value *, uint32_t>> words = {
+        {cpuFeatures, mask.cpuModel}};
+    for (const auto &[word, bits] : mask.cpuid) {
+      words.emplace_back(getCpuidWord(word), bits);
+    }
+    IRBuilder<> Builder(init->getEntryBlock().getTerminator());
+    Value *supported = Builder.getTrue();
+    for (const auto &[value, bits] : words) {
+      auto *maskValue = Builder.getInt32(bits);
+      supported = Builder.CreateAnd(
+          supported,
+          Builder.CreateICmpEQ(Builder.CreateAnd(value, maskValue), maskValue));
+    }
+    Value *version = Builder.CreateSelect(
+        supported, Builder.CreateBitCast(Version, Dynamic->getType()), Dynamic);
+    Builder.CreateStore(version, table);
+    return table;
+  }
+};
+
+#endif /* VERIFICARLO_LIBVFCINSTRUMENTPRISM_MULTIVERSION_HPP */
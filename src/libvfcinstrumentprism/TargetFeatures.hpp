@@ -2,8 +2,12 @@
 #ifndef VERIFICARLO_LIBVFCINSTRUMENTPRISM_TARGET_FEATURES_HPP
 #define VERIFICARLO_LIBVFCINSTRUMENTPRISM_TARGET_FEATURES_HPP
 
+#include <algorithm>
+#include <map>
+#include <optional>
 #include <set>
 #include <sstream>
+#include <tuple>
 
 #include <llvm/IR/Attributes.h>
 #include <llvm/IR/BasicBlock.h>
@@ -99,6 +103,10 @@ public:
     return "-" + name;
   }
 
+  [[nodiscard]] auto getName() const -> const std::string & { return name; }
+
+  [[nodiscard]] auto isEnabled() const -> bool { return enabled; }
+
   auto operator<(const TargetFeature &rhs) const -> bool {
     const auto repr = getAsString();
     const auto rhs_repr = rhs.getAsString();
@@ -220,6 +228,10 @@ public:
 
   [[nodiscard]] auto empty() const -> bool { return features.empty(); }
 
+  [[nodiscard]] auto getFeatures() const -> const std::set<TargetFeature> & {
+    return features;
+  }
+
   auto operator+(const TargetFeatures &rhs) -> TargetFeatures {
     TargetFeatures result;
     for (const auto &feature : features) {
@@ -299,6 +311,139 @@ getHighestSupportedISA_X86_64(const TargetFeatures &features) -> X86_64_ISA {
   return x86_64_NONE;
 }
 
+// Word returned by cpuid: leaf, subleaf and register (eax, ebx, ecx, edx)
+using CpuidWord = std::tuple<uint32_t, uint32_t, unsigned>;
+
+// Bits to check in the __cpu_model.__cpu_features[0] word and in cpuid words
+struct CpuFeaturesMask {
+  uint32_t cpuModel = 0;
+  std::map<CpuidWord, uint32_t> cpuid;
+};
+
+// Bits of the features of the CPU. Features with a bit in the
+// __cpu_model.__cpu_features[0] word that libgcc and compiler-rt fill for
+// __builtin_cpu_supports are checked there, since the runtimes also check
+// that the OS saves the AVX and AVX-512 registers. The other features are
+// read with cpuid, since the layout of __cpu_features2 differs between
+// runtime versions. Returns nullopt if an enabled feature has no known bit,
+// the CPU cannot be checked for it then.
+inline auto getCpuSupportsMask_X86_64(const TargetFeatures &features)
+    -> std::optional<CpuFeaturesMask> {
+  static const std::vector<std::string> cpuFeatures = {
+      "cmov",         "mmx",          "popcnt",          "sse",
+      "sse2",         "sse3",         "ssse3",           "sse4.1",
+      "sse4.2",       "avx",          "avx2",            "sse4a",
+      "fma4",         "xop",          "fma",             "avx512f",
+      "bmi",          "bmi2",         "aes",             "pclmul",
+      "avx512vl",     "avx512bw",     "avx512dq",        "avx512cd",
+      "avx512er",     "avx512pf",     "avx512vbmi",      "avx512ifma",
+      "avx5124vnniw", "avx5124fmaps", "avx512vpopcntdq", "avx512vbmi2"};
+  // Leaf, subleaf, register and bit of the other features. The ones using
+  // AVX or AVX-512 registers come with avx or avx512f, checked above.
+  static const std::map<std::string, std::pair<CpuidWord, unsigned>>
+      cpuidFeatures = {
+          {"cx16", {{1, 0, 2}, 13}},
+          {"movbe", {{1, 0, 2}, 22}},
+          {"f16c", {{1, 0, 2}, 29}},
+          {"rdrnd", {{1, 0, 2}, 30}},
+          {"fsgsbase", {{7, 0, 1}, 0}},
+          {"sgx", {{7, 0, 1}, 2}},
+          {"hle", {{7, 0, 1}, 4}},
+          {"invpcid", {{7, 0, 1}, 10}},
+          {"rtm", {{7, 0, 1}, 11}},
+          {"rdseed", {{7, 0, 1}, 18}},
+          {"adx", {{7, 0, 1}, 19}},
+          {"clflushopt", {{7, 0, 1}, 23}},
+          {"clwb", {{7, 0, 1}, 24}},
+          {"sha", {{7, 0, 1}, 29}},
+          {"prefetchwt1", {{7, 0, 2}, 0}},
+          {"pku", {{7, 0, 2}, 3}},
+          {"waitpkg", {{7, 0, 2}, 5}},
+          {"shstk", {{7, 0, 2}, 7}},
+          {"gfni", {{7, 0, 2}, 8}},
+          {"vaes", {{7, 0, 2}, 9}},
+          {"vpclmulqdq", {{7, 0, 2}, 10}},
+          {"avx512vnni", {{7, 0, 2}, 11}},
+          {"avx512bitalg", {{7, 0, 2}, 12}},
+          {"rdpid", {{7, 0, 2}, 22}},
+          {"kl", {{7, 0, 2}, 23}},
+          {"cldemote", {{7, 0, 2}, 25}},
+          {"movdiri", {{7, 0, 2}, 27}},
+          {"movdir64b", {{7, 0, 2}, 28}},
+          {"enqcmd", {{7, 0, 2}, 29}},
+          {"uintr", {{7, 0, 3}, 5}},
+          {"avx512vp2intersect", {{7, 0, 3}, 8}},
+          {"serialize", {{7, 0, 3}, 14}},
+          {"tsxldtrk", {{7, 0, 3}, 16}},
+          {"pconfig", {{7, 0, 3}, 18}},
+          {"amx-bf16", {{7, 0, 3}, 22}},
+          {"avx512fp16", {{7, 0, 3}, 23}},
+          {"amx-tile", {{7, 0, 3}, 24}},
+          {"amx-int8", {{7, 0, 3}, 25}},
+          {"sha512", {{7, 1, 0}, 0}},
+          {"sm3", {{7, 1, 0}, 1}},
+          {"sm4", {{7, 1, 0}, 2}},
+          {"raoint", {{7, 1, 0}, 3}},
+          {"avxvnni", {{7, 1, 0}, 4}},
+          {"avx512bf16", {{7, 1, 0}, 5}},
+          {"cmpccxadd", {{7, 1, 0}, 7}},
+          {"amx-fp16", {{7, 1, 0}, 21}},
+          {"hreset", {{7, 1, 0}, 22}},
+          {"avxifma", {{7, 1, 0}, 23}},
+          {"avxvnniint8", {{7, 1, 3}, 4}},
+          {"avxneconvert", {{7, 1, 3}, 5}},
+          {"avxvnniint16", {{7, 1, 3}, 10}},
+          {"prefetchi", {{7, 1, 3}, 14}},
+          {"xsaveopt", {{0xd, 1, 0}, 0}},
+          {"xsavec", {{0xd, 1, 0}, 1}},
+          {"xsaves", {{0xd, 1, 0}, 3}},
+          {"ptwrite", {{0x14, 0, 1}, 4}},
+          {"widekl", {{0x19, 0, 1}, 2}},
+          {"sahf", {{0x80000001, 0, 2}, 0}},
+          {"lzcnt", {{0x80000001, 0, 2}, 5}},
+          {"prfchw", {{0x80000001, 0, 2}, 8}},
+          {"lwp", {{0x80000001, 0, 2}, 15}},
+          {"tbm", {{0x80000001, 0, 2}, 21}},
+          {"mwaitx", {{0x80000001, 0, 2}, 29}},
+          {"clzero", {{0x80000008, 0, 1}, 0}},
+          {"rdpru", {{0x80000008, 0, 1}, 4}},
+          {"wbnoinvd", {{0x80000008, 0, 1}, 9}}};
+  // Features of every x86-64 CPU (no bit required), or implied by a feature
+  // of the word
+  static const std::map<std::string, std::string> impliedFeatures = {
+      {"64bit", ""},          {"x87", ""},      {"cx8", ""},
+      {"fxsr", ""},           {"crc32", "sse4.2"}, {"xsave", "avx"},
+      {"evex512", "avx512f"}};
+  CpuFeaturesMask mask;
+  for (const auto &feature : features.getFeatures()) {
+    if (not feature.isEnabled()) {
+      continue;
+    }
+    std::string name = feature.getName();
+    auto implied = impliedFeatures.find(name);
+    if (implied != impliedFeatures.end()) {
+      if (implied->second.empty()) {
+        continue;
+      }
+      name = implied->second;
+    }
+    auto bit = std::find(cpuFeatures.begin(), cpuFeatures.end(), name);
+    if (bit != cpuFeatures.end()) {
+      mask.cpuModel |= 1U << (bit - cpuFeatures.begin());
+      continue;
+    }
+    auto cpuidBit = cpuidFeatures.find(name);
+    if (cpuidBit == cpuidFeatures.end()) {
+      if (VfclibInstDebug) {
+        errs() << "No CPU bit for feature: " << name << "\n";
+      }
+      return std::nullopt;
+    }
+    mask.cpuid[cpuidBit->second.first] |= 1U << cpuidBit->second.second;
+  }
+  return mask;
+}
+
 inline auto hasFeatures_X86_64(const Attribute &src,
                                const Attribute &target) -> bool {
   std::vector<std::string> features = {"avx512f", "avx2", "avx", "sse4.2",
@@ -0,0 +1,354 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *                                                                           *\
+ *  Copyright (c) 2026                                                       *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+// Stochastic rounding to a virtual precision and exponent range.
+//
+// PRISM operators round stochastically to the precision of the type. The
+// result is then rounded stochastically to the virtual format. Both
+// roundings are unbiased and the virtual grid is a subset of the grid of the
+// type, so the composition rounds the exact result up or down to the
+// virtual grid with the probabilities of a single stochastic rounding.
+//
+// The rounding is emitted inline with integer operations on the bits of the
+// value, so vector results are rounded without being serialized. Random bits
+// come from a SplitMix64 generator whose state is a thread-local global of
+// the program, seeded by a module constructor.
+//
+// The same rounding implements the instrumentation of casts, that round a
+// binary64 value to the binary32 virtual format before truncating it, and of
+// comparisons, that move operands whose last bit is set to one of their
+// neighbours.
+
+#ifndef VERIFICARLO_LIBVFCINSTRUMENTPRISM_VIRTUAL_PRECISION_HPP
+#define VERIFICARLO_LIBVFCINSTRUMENTPRISM_VIRTUAL_PRECISION_HPP
+
+#include <cstdint>
+#include <string>
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/ErrorHandling.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
+
+using namespace llvm;
+
+class VirtualPrecision {
+public:
+  explicit VirtualPrecision(Module &M, bool upDown, unsigned precisionBinary32,
+                            unsigned rangeBinary32, unsigned precisionBinary64,
+                            unsigned rangeBinary64)
+      : M(M), upDown(upDown),
+        binary32(32, 23, precisionBinary32, rangeBinary32),
+        binary64(64, 52, precisionBinary64, rangeBinary64) {
+    binary32.check("binary32");
+    binary64.check("binary64");
+  }
+
+  /* Returns true if values of type Ty are rounded to a virtual format */
+  [[nodiscard]] auto isEnabled(Type *Ty) const -> bool {
+    const Format *format = getFormat(Ty);
+    return format != nullptr and format->isReduced();
+  }
+
+  /* Returns V rounded stochastically to the virtual format of its type */
+  auto round(IRBuilder<> &Builder, Value *V) -> Value * {
+    return roundToFormat(Builder, V, *getFormat(V->getType()), upDown);
+  }
+
+  /* Returns the binary64 value V rounded to the binary32 virtual format and
+   * truncated to float, which is exact */
+  auto roundCast(IRBuilder<> &Builder, Value *V, Type *DestTy) -> Value * {
+    const Format f(binary64.width, binary64.mantissa, binary32.precision,
+                   binary32.range);
+    return Builder.CreateFPTrunc(roundToFormat(Builder, V, f, upDown), DestTy);
+  }
+
+  /* Returns the operand V of a comparison rounded to one bit less than the
+   * virtual precision: values whose last bit is set move to one of their
+   * neighbours with probability 1/2, in both rounding modes */
+  auto perturbComparison(IRBuilder<> &Builder, Value *V) -> Value * {
+    const Format &type = *getFormat(V->getType());
+    if (type.precision == 1) {
+      return V;
+    }
+    const Format f(type.width, type.mantissa, type.precision - 1,
+                   type.exponent());
+    return roundToFormat(Builder, V, f, /*randomUpDown=*/false);
+  }
+
+private:
+  /* Binary format of a type and its virtual format */
+  struct Format {
+    int64_t width;
+    int64_t mantissa;
+    int64_t precision;
+    int64_t range;
+
+    Format(int64_t width, int64_t mantissa, int64_t precision, int64_t range)
+        : width(width), mantissa(mantissa), precision(precision),
+          range(range) {}
+
+    [[nodiscard]] auto exponent() const -> int64_t {
+      return width - mantissa - 1;
+    }
+    [[nodiscard]] auto bias() const -> int64_t {
+      return (int64_t{1} << (exponent() - 1)) - 1;
+    }
+    [[nodiscard]] auto emax() const -> int64_t {
+      return (int64_t{1} << (range - 1)) - 1;
+    }
+    [[nodiscard]] auto emin() const -> int64_t { return 1 - emax(); }
+    [[nodiscard]] auto isRangeReduced() const -> bool {
+      return range < exponent();
+    }
+    [[nodiscard]] auto isReduced() const -> bool {
+      return precision < mantissa + 1 or isRangeReduced();
+    }
+    [[nodiscard]] auto signMask() const -> int64_t {
+      return static_cast<int64_t>(uint64_t{1} << (width - 1));
+    }
+    [[nodiscard]] auto expMask() const -> int64_t {
+      return (int64_t{1} << exponent()) - 1;
+    }
+    [[nodiscard]] auto hiddenBit() const -> int64_t {
+      return int64_t{1} << mantissa;
+    }
+    [[nodiscard]] auto mantissaMask() const -> int64_t {
+      return hiddenBit() - 1;
+    }
+    [[nodiscard]] auto infBits() const -> int64_t {
+      return expMask() << mantissa;
+    }
+    /* bits of the largest value of the virtual format */
+    [[nodiscard]] auto maxBits() const -> int64_t {
+      const int64_t digits = ((int64_t{1} << (precision - 1)) - 1)
+                             << (mantissa - precision + 1);
+      return ((emax() + bias()) << mantissa) | digits;
+    }
+    /* bits of the smallest positive value of the virtual format */
+    [[nodiscard]] auto minSubnormalBits() const -> int64_t {
+      const int64_t exp = emin() - (precision - 1);
+      if (exp >= 1 - bias()) {
+        return (exp + bias()) << mantissa;
+      }
+      return int64_t{1} << (exp + bias() + mantissa - 1);
+    }
+
+    void check(const std::string &name) const {
+      if (precision < 1 or precision > mantissa + 1) {
+        errs() << "Invalid " << name << " virtual precision " << precision
+               << ", must be in [1, " << mantissa + 1 << "]\n";
+        report_fatal_error("libVFCInstrumentPRISM fatal error");
+      }
+      if (range < 2 or range > exponent()) {
+        errs() << "Invalid " << name << " virtual range " << range
+               << ", must be in [2, " << exponent() << "]\n";
+        report_fatal_error("libVFCInstrumentPRISM fatal error");
+      }
+    }
+  };
+
+  Module &M;
+  bool upDown;
+  Format binary32;
+  Format binary64;
+  GlobalVariable *state = nullptr;
+  GlobalVariable *seed = nullptr;
+
+  /* Returns V rounded to the format f, stochastically or up or down with
+   * probability 1/2 */
+  auto roundToFormat(IRBuilder<> &Builder, Value *V, const Format &f,
+                     bool randomUpDown) -> Value * {
+    Type *Ty = V->getType();
+    unsigned lanes = 1;
+    Type *intTy = Builder.getIntNTy(f.width);
+    if (auto *vecTy = dyn_cast<FixedVectorType>(Ty)) {
+      lanes = vecTy->getNumElements();
+      intTy = FixedVectorType::get(intTy, lanes);
+    }
+    auto C = [intTy](int64_t value) {
+      return ConstantInt::get(intTy, value, /*isSigned=*/true);
+    };
+    auto smax = [&Builder](Value *a, Value *b) {
+      return Builder.CreateBinaryIntrinsic(Intrinsic::smax, a, b);
+    };
+    auto umin = [&Builder](Value *a, Value *b) {
+      return Builder.CreateBinaryIntrinsic(Intrinsic::umin, a, b);
+    };
+
+    Value *random = getRandomBits(Builder, lanes);
+    if (f.width == 32) {
+      random = Builder.CreateTrunc(
+          Builder.CreateLShr(random, ConstantInt::get(random->getType(), 32)),
+          intTy);
+    }
+
+    Value *bits = Builder.CreateBitCast(V, intTy);
+    Value *sign = Builder.CreateAnd(bits, C(f.signMask()));
+    Value *abs = Builder.CreateAnd(bits, C(~f.signMask()));
+    Value *exp = Builder.CreateLShr(abs, C(f.mantissa));
+
+    // Exponent of the ulp of the value and of the virtual grid around it,
+    // that is fixed in the subnormal range of the virtual format
+    Value *ulpExp =
+        Builder.CreateSub(smax(exp, C(1)), C(f.bias() + f.mantissa));
+    Value *gridExp = Builder.CreateSub(
+        smax(Builder.CreateSub(exp, C(f.bias())), C(f.emin())),
+        C(f.precision - 1));
+    // The grid spacing is 2^k ulps
+    Value *k = Builder.CreateSub(gridExp, ulpExp);
+
+    // Add k random bits to the magnitude and truncate them. A carry into the
+    // exponent gives the next power of two, that is on the grid. Up-down
+    // rounding adds either no bits or all of them
+    Value *low = Builder.CreateSub(
+        Builder.CreateShl(C(1), umin(k, C(f.mantissa))), C(1));
+    Value *coin = Builder.CreateICmpSLT(random, C(0));
+    Value *offset = randomUpDown ? Builder.CreateSelect(coin, low, C(0))
+                                 : Builder.CreateAnd(random, low);
+    Value *sum = Builder.CreateAdd(abs, offset);
+    Value *rounded = Builder.CreateAnd(sum, Builder.CreateNot(low));
+
+    if (f.isRangeReduced()) {
+      // Overflow of the virtual exponent range
+      Value *overflow = Builder.CreateICmpUGT(rounded, C(f.maxBits()));
+      rounded = Builder.CreateSelect(overflow, C(f.infBits()), rounded);
+
+      // Values below the grid spacing, k is larger than the mantissa: round
+      // to zero or to the spacing with probability value / spacing
+      Value *significand = Builder.CreateSelect(
+          Builder.CreateICmpEQ(exp, C(0)), abs,
+          Builder.CreateOr(Builder.CreateAnd(abs, C(f.mantissaMask())),
+                           C(f.hiddenBit())));
+      Value *kRandom = umin(k, C(f.width - 1));
+      Value *kShift = umin(Builder.CreateSub(k, kRandom), C(f.width - 1));
+      Value *kLow = Builder.CreateSub(Builder.CreateShl(C(1), kRandom), C(1));
+      Value *up =
+          randomUpDown
+              ? Builder.CreateAnd(coin, Builder.CreateICmpNE(abs, C(0)))
+              : Builder.CreateICmpULT(Builder.CreateAnd(random, kLow),
+                                      Builder.CreateLShr(significand, kShift));
+      Value *tiny = Builder.CreateICmpUGT(k, C(f.mantissa));
+      rounded = Builder.CreateSelect(
+          tiny, Builder.CreateSelect(up, C(f.minSubnormalBits()), C(0)),
+          rounded);
+    }
+
+    // NaN and infinities are kept
+    Value *special = Builder.CreateICmpEQ(exp, C(f.expMask()));
+    rounded = Builder.CreateSelect(special, abs, rounded);
+
+    return Builder.CreateBitCast(Builder.CreateOr(rounded, sign), Ty);
+  }
+
+  [[nodiscard]] auto getFormat(Type *Ty) const -> const Format * {
+    Type *scalarTy = Ty->getScalarType();
+    if (scalarTy->isFloatTy()) {
+      return &binary32;
+    }
+    if (scalarTy->isDoubleTy()) {
+      return &binary64;
+    }
+    return nullptr;
+  }
+
+  // SplitMix64 increment
+  static constexpr uint64_t gamma = 0x9e3779b97f4a7c15ULL;
+
+  auto getGlobal(const std::string &name, bool threadLocal)
+      -> GlobalVariable * {
+    auto *int64Ty = Type::getInt64Ty(M.getContext());
+    auto *global = M.getGlobalVariable(name);
+    if (global == nullptr) {
+      global = new GlobalVariable(
+          M, int64Ty, false, GlobalValue::LinkOnceODRLinkage,
+          ConstantInt::get(int64Ty, threadLocal ? 0 : gamma), name, nullptr,
+          threadLocal ? GlobalValue::GeneralDynamicTLSModel
+                      : GlobalValue::NotThreadLocal);
+      global->setVisibility(GlobalValue::HiddenVisibility);
+    }
+    return global;
+  }
+
+  /* Creates the generator state and the constructor seeding it */
+  void createGenerator() {
+    state = getGlobal("vfc_prism_vp_state", /*threadLocal=*/true);
+    seed = getGlobal("vfc_prism_vp_seed", /*threadLocal=*/false);
+
+    const std::string ctorName = "vfc_prism_vp_seed_init";
+    if (M.getFunction(ctorName) != nullptr) {
+      return;
+    }
+    auto *ctor = Function::Create(
+        FunctionType::get(Type::getVoidTy(M.getContext()), false),
+        GlobalValue::LinkOnceODRLinkage, ctorName, M);
+    ctor->setVisibility(GlobalValue::HiddenVisibility);
+    IRBuilder<> Builder(BasicBlock::Create(M.getContext(), "entry", ctor));
+    Value *cycles =
+        Builder.CreateIntrinsic(Intrinsic::readcyclecounter, {}, {});
+    Value *address = Builder.CreatePtrToInt(seed, Builder.getInt64Ty());
+    Builder.CreateStore(Builder.CreateXor(cycles, address), seed);
+    Builder.CreateRetVoid();
+    appendToGlobalCtors(M, ctor, 0);
+  }
+
+  /* Returns lanes random 64-bit integers */
+  auto getRandomBits(IRBuilder<> &Builder, unsigned lanes) -> Value * {
+    if (state == nullptr) {
+      createGenerator();
+    }
+    auto *int64Ty = Builder.getInt64Ty();
+    Value *s = Builder.CreateLoad(int64Ty, state);
+    // Threads start with a null state, seed it with the address of their
+    // state
+    Value *fresh = Builder.CreateOr(
+        Builder.CreateXor(Builder.CreateLoad(int64Ty, seed),
+                          Builder.CreatePtrToInt(state, int64Ty)),
+        1);
+    s = Builder.CreateSelect(Builder.CreateICmpEQ(s, Builder.getInt64(0)),
+                             fresh, s);
+    Builder.CreateStore(Builder.CreateAdd(s, Builder.getInt64(gamma * lanes)),
+                        state);
+
+    Value *z = nullptr;
+    if (lanes == 1) {
+      z = Builder.CreateAdd(s, Builder.getInt64(gamma));
+    } else {
+      SmallVector<Constant *, 16> steps;
+      for (unsigned i = 0; i < lanes; i++) {
+        steps.push_back(Builder.getInt64(gamma * (i + 1)));
+      }
+      z = Builder.CreateAdd(Builder.CreateVectorSplat(lanes, s),
+                            ConstantVector::get(steps));
+    }
+    auto *zTy = z->getType();
+    auto mix = [&](Value *x, uint64_t shift, uint64_t multiplier) {
+      Value *y = Builder.CreateXor(
+          x, Builder.CreateLShr(x, ConstantInt::get(zTy, shift)));
+      return Builder.CreateMul(y, ConstantInt::get(zTy, multiplier));
+    };
+    z = mix(z, 30, 0xbf58476d1ce4e5b9ULL);
+    z = mix(z, 27, 0x94d049bb133111ebULL);
+    return Builder.CreateXor(z,
+                             Builder.CreateLShr(z, ConstantInt::get(zTy, 31)));
+  }
+};
+
+#endif /* VERIFICARLO_LIBVFCINSTRUMENTPRISM_VIRTUAL_PRECISION_HPP */
@@ -66,9 +66,11 @@
 #include <cmath>
 #include <cxxabi.h>
 #include <fstream>
-#include <regex>
 
+#include "../libvfcinstrument/FunctionSet.hpp"
+#include "Multiversion.hpp"
 #include "TargetFeatures.hpp"
+#include "VirtualPrecision.hpp"
 #include "libVFCInstrumentPRISMOptions.hpp"
 
 #define FUNCTION_CALLEE FunctionCallee
@@ -107,7 +109,9 @@ enum class type {
   MUL,
   DIV,
   FMA,
+  SQRT,
   CMP,
+  CAST,
   IGNORE,
 }; // namespace
 
@@ -124,25 +128,43 @@ auto getName(const type &ty) -> std::string {
     return "div";
   case type::FMA:
     return "fma";
+  case type::SQRT:
+    return "sqrt";
   case type::CMP:
     return "cmp";
+  case type::CAST:
+    return "cast";
   case type::IGNORE:
     return "ignore";
   }
   llvm_unreachable("unknown type");
 }
 
-auto isFMA(const Instruction *I) -> bool {
+auto isIntrinsic(const Instruction *I, StringRef prefix) -> bool {
   if (isa<CallInst>(I)) {
     const auto *call = dyn_cast<CallInst>(I);
     if (call->getCalledFunction() != nullptr) {
       auto name = call->getCalledFunction()->getName();
-      return (name.empty()) ? false : STARTS_WITH(name, "llvm.fma");
+      return (name.empty()) ? false : STARTS_WITH(name, prefix);
     }
   }
   return false;
 }
 
+auto isFMA(const Instruction *I) -> bool {
+  return isIntrinsic(I, "llvm.fma");
+}
+
+auto isSqrt(const Instruction *I) -> bool {
+  return isIntrinsic(I, "llvm.sqrt");
+}
+
+/* Only casts from double to float are instrumented */
+auto isValidCast(const Instruction *I) -> bool {
+  return I->getOperand(0)->getType()->getScalarType()->isDoubleTy() and
+         I->getType()->getScalarType()->isFloatTy();
+}
+
 auto getOpCode(const Instruction *I) -> type {
   switch (I->getOpcode()) {
   case Instruction::FAdd:
@@ -157,7 +179,17 @@ auto getOpCode(const Instruction *I) -> type {
 
     return type::DIV;
   case Instruction::Call:
-    return (isFMA(I)) ? type::FMA : type::IGNORE;
+    if (isFMA(I)) {
+      return type::FMA;
+    }
+    return (isSqrt(I)) ? type::SQRT : type::IGNORE;
+  case Instruction::FCmp:
+    // Only instrument FCMP if the flag --inst-fcmp is passed
+    return (VfclibInstInstrumentFCMP) ? type::CMP : type::IGNORE;
+  case Instruction::FPTrunc:
+    // Only instrument cast if the flag --inst-cast is passed
+    return (VfclibInstInstrumentCast and isValidCast(I)) ? type::CAST
+                                                         : type::IGNORE;
   default:
     return type::IGNORE;
   }
@@ -169,6 +201,9 @@ auto mustReplace(const Instruction &I) -> bool {
 
 auto getArity(const Instruction *I) -> uint32_t {
   switch (getOpCode(I)) {
+  case type::SQRT:
+  case type::CAST:
+    return 1;
   case type::ADD:
   case type::SUB:
   case type::MUL:
@@ -242,10 +277,13 @@ auto PassingModeNamespace(PrismPassingMode mode) -> std::string {
   prism_fatal_error("Invalid passing mode");
 }
 
+/* PRISM operators library. Only the declarations of the operators are
+ * copied into the instrumented module, so the function bodies of a bitcode
+ * library are never read. */
 class IRModule {
 public:
   explicit IRModule(Module &M, const std::string &irFile) {
-    libModule = loadVfcwrapperIR(M, irFile);
+    libModule = loadPrismIR(M, irFile);
     // if ir is null, an error message has already been printed
     if (libModule == nullptr) {
       prism_fatal_error("fatal error while reading library IR: " + irFile);
@@ -305,6 +343,12 @@ private:
       const std::string &mangled_name = F.getName().str();
       functionsToExclude.insert(mangled_name);
 
+      // Operators are looked up by their prism:: name, do not demangle the
+      // thousands of other symbols of the library
+      if (not STARTS_WITH(F.getName(), "_ZN5prism")) {
+        continue;
+      }
+
       std::string demangled_name = get_demangled_name(mangled_name);
       demangledNamesToMangled[demangled_name] = mangled_name;
 
@@ -318,11 +362,12 @@ private:
     // printDemangledNamesLibsSRShort();
   }
 
-  /* Load vfcwrapper.ll Module */
-  static auto loadVfcwrapperIR(Module &M, const std::string &irFile)
+  /* Load the PRISM library, lazily if it is a bitcode file */
+  static auto loadPrismIR(Module &M, const std::string &irFile)
       -> std::unique_ptr<Module> {
     SMDiagnostic err;
-    auto newM = parseIRFile(irFile, err, M.getContext());
+    auto newM = getLazyIRFileModule(irFile, err, M.getContext(),
+                                    /*ShouldLazyLoadMetadata=*/true);
     if (newM == nullptr) {
       err.print(irFile.c_str(), errs());
       prism_fatal_error();
@@ -367,22 +412,18 @@ class PrismModule {
 private:
   options::RoundingMode rounding_mode;
   options::DispatchMode dispatch_mode;
-  IRModule staticLib;
-  IRModule dynamicLib;
+  // library of the selected dispatch mode
+  IRModule lib;
+  // static library selected at load time by the multiversion dispatch
+  std::unique_ptr<IRModule> staticLib = nullptr;
 
   auto getFunction(StringRef name) -> Function * {
-    if (dispatch_mode.is_static()) {
-      return staticLib.getFunction(name.str());
-    }
-    return dynamicLib.getFunction(name.str());
+    return lib.getFunction(name.str());
   }
 
   auto getCopyFunction(Module *M, Function *F,
                        const std::string &functionName) -> FUNCTION_CALLEE {
-    if (dispatch_mode.is_static()) {
-      return staticLib.copyFunction(M, F, functionName);
-    }
-    return dynamicLib.copyFunction(M, F, functionName);
+    return lib.copyFunction(M, F, functionName);
   }
 
   static auto getFloatingPointTypeName(Type *Ty) -> std::string {
@@ -396,9 +437,9 @@ private:
     return fops::getFpTypeName(Ty->getTypeID());
   }
 
-  auto getFunctionNameScalar(Instruction *I, FPOps opCode) -> std::string {
+  auto getFunctionNameScalar(Instruction *I, FPOps opCode,
+                             const std::string &dispatch) -> std::string {
     const auto mode = rounding_mode.get_namespace();
-    const auto dispatch = dispatch_mode.get_namespace();
     const auto opname = fops::getName(opCode);
     const auto fpname = getFloatingPointTypeName(I->getType());
     const auto fname = opname + fpname;
@@ -406,11 +447,10 @@ private:
     return "prism::" + mode + "::scalar::" + dispatch + "::" + fname;
   }
 
-  auto
-  getFunctionNameVector(Instruction *I, FPOps opCode,
-                        const PrismPassingMode &passing_style) -> std::string {
+  auto getFunctionNameVector(Instruction *I, FPOps opCode,
+                             const PrismPassingMode &passing_style,
+                             const std::string &dispatch) -> std::string {
     const auto mode = rounding_mode.get_namespace();
-    const auto dispatch = dispatch_mode.get_namespace();
     const auto passing = PassingModeNamespace(passing_style);
     const auto opname = fops::getName(opCode);
     const auto fpname = getFloatingPointTypeName(I->getType());
@@ -421,7 +461,8 @@ private:
   }
 
   auto getFunctionName(Instruction *I, FPOps opCode,
-                       const PrismPassingMode &passing) -> std::string {
+                       const PrismPassingMode &passing,
+                       const std::string &dispatch) -> std::string {
 
     if (opCode == FPOps::IGNORE) {
       prism_fatal_error("Unsupported opcode: " + fops::getName(opCode));
@@ -430,10 +471,15 @@ private:
     auto *baseType = I->getType();
 
     if (baseType->isVectorTy()) {
-      return getFunctionNameVector(I, opCode, passing);
+      return getFunctionNameVector(I, opCode, passing, dispatch);
     }
 
-    return getFunctionNameScalar(I, opCode);
+    return getFunctionNameScalar(I, opCode, dispatch);
+  }
+
+  auto getFunctionName(Instruction *I, FPOps opCode,
+                       const PrismPassingMode &passing) -> std::string {
+    return getFunctionName(I, opCode, passing, dispatch_mode.get_namespace());
   }
 
 public:
@@ -443,8 +489,29 @@ public:
                        const cl::opt<std::string> &VfclibInstDynamicIRFile)
       : rounding_mode(std::move(rounding_mode)),
         dispatch_mode(std::move(dispatch_mode)),
-        staticLib(IRModule(M, VfclibInstStaticIRFile)),
-        dynamicLib(M, VfclibInstDynamicIRFile) {}
+        lib(M, this->dispatch_mode.is_static() ? VfclibInstStaticIRFile
+                                               : VfclibInstDynamicIRFile) {
+    if (this->dispatch_mode.is_multiversion()) {
+      staticLib = std::make_unique<IRModule>(M, VfclibInstStaticIRFile);
+    }
+  }
+
+  // return the static operator for the given instruction, that replaces the
+  // dynamic one when the CPU supports it, nullptr if it does not exist
+  auto getStaticFunction(Instruction *I, const FPOps &opcode) -> Function * {
+    const auto dispatch = dispatch_mode.get_static_namespace();
+    for (auto passing :
+         {PrismPassingMode::ByValue, PrismPassingMode::ByPointer}) {
+      auto functionName = getFunctionName(I, opcode, passing, dispatch);
+      Function *function = staticLib->getFunction(functionName);
+      if (function != nullptr) {
+        auto F =
+            staticLib->copyFunction(I->getModule(), function, functionName);
+        return dyn_cast<Function>(F.getCallee());
+      }
+    }
+    return nullptr;
+  }
 
   // return the corresponding prism function for the given instruction
   auto getPrismFunction(Instruction *I, const FPOps &opcode) -> PrismFunction {
@@ -481,6 +548,8 @@ public:
 struct VfclibInst : public ModulePass {
   static char ID;
   std::unique_ptr<PrismModule> prismModule = nullptr;
+  std::unique_ptr<VirtualPrecision> virtualPrecision = nullptr;
+  std::unique_ptr<MultiversionTable> multiversionTable = nullptr;
   constexpr static int returnIndex = -1;
   using prismAllocaKey = std::tuple<Function *, Type *, int>;
   std::map<prismAllocaKey, Instruction *> prismAllocaMap;
@@ -500,27 +569,6 @@ struct VfclibInst : public ModulePass {
     llvm::InitializeAllAsmPrinters();
   }
 
-  // https://thispointer.com/find-and-replace-all-occurrences-of-a-sub-string-in-c/
-  static void findAndReplaceAll(std::string &data, const std::string &toSearch,
-                                const std::string &replaceStr) {
-    // Get the first occurrence
-    size_t pos = data.find(toSearch);
-    // Repeat till end is reached
-    while (pos != std::string::npos) {
-      // Replace this occurrence of Sub String
-      data.replace(pos, toSearch.size(), replaceStr);
-      // Get the next occurrence from the current position
-      pos = data.find(toSearch, pos + replaceStr.size());
-    }
-  }
-
-  static void escape_regex(std::string &str) {
-    findAndReplaceAll(str, ".", "\\.");
-    // ECMAScript needs .* instead of * for matching any charactere
-    // http://www.cplusplus.com/reference/regex/ECMAScript/
-    findAndReplaceAll(str, "*", ".*");
-  }
-
   static auto getSourceFileNameAbsPath(Module &M) -> std::string {
     std::string filename = M.getSourceFileName();
     if (sys::path::is_absolute(filename)) {
@@ -538,75 +586,25 @@ struct VfclibInst : public ModulePass {
     return "";
   }
 
-  // TODO(yohan): raise a clean error if the file is not well formatted
   static auto
   parseFunctionSetFile(Module &M,
-                       const cl::opt<std::string> &fileName) -> std::regex {
+                       const cl::opt<std::string> &fileName) -> FunctionSet {
+    FunctionSet functionSet;
     // Skip if empty fileName
     if (fileName.empty()) {
-      return std::regex("");
-    }
-
-    // Open File
-    std::ifstream loopstream(fileName.c_str());
-    if (!loopstream.is_open()) {
-      prism_fatal_error("Cannot open " + fileName);
+      return functionSet;
     }
 
-    // Parse File, if module name matches, add function to FunctionSet
-    int lineno = 0;
-    std::string line;
-
     // return the absolute path of the source file
     std::string moduleName = getSourceFileNameAbsPath(M);
     moduleName = (moduleName.empty()) ? M.getModuleIdentifier() : moduleName;
 
-    // Regex that contains all regex for each function
-    std::string moduleRegex;
-
-    while (std::getline(loopstream, line)) {
-      lineno++;
-      auto l = StringRef(line);
-
-      // Ignore empty or commented lines
-      if (STARTS_WITH(l, "#") || l.trim() == "") {
-        continue;
-      }
-      std::pair<StringRef, StringRef> p = l.split(" ");
-
-      if (p.second.empty()) {
-        prism_fatal_error("Syntax error in exclusion/inclusion file " +
-                          fileName + ":" + std::to_string(lineno));
-      } else {
-        std::string mod = p.first.trim().str();
-        std::string fun = p.second.trim().str();
-
-        // If mod is not an absolute path,
-        // we search any module containing mod
-        if (sys::path::is_relative(mod)) {
-          mod = "*" + sys::path::get_separator().str() + mod;
-        }
-        // If the user does not specify extension for the module
-        // we match any extension
-        if (not sys::path::has_extension(mod)) {
-          mod += ".*";
-        }
-
-        escape_regex(mod);
-        escape_regex(fun);
-
-        if (std::regex_match(moduleName, std::regex(mod))) {
-          moduleRegex += fun + "|";
-        }
-      }
-    }
-
-    loopstream.close();
-    // Remove the extra | at the end
-    if (not moduleRegex.empty()) {
-      moduleRegex.pop_back();
+    // Parse File, if module name matches, add function to FunctionSet
+    std::string error;
+    if (not functionSet.addFile(fileName, moduleName, error)) {
+      prism_fatal_error(error);
     }
-    return std::regex(moduleRegex);
+    return functionSet;
   }
 
   auto runOnModule(Module &M) -> bool override {
@@ -616,16 +614,35 @@ struct VfclibInst : public ModulePass {
         PrismModule(M, rounding_mode, dispatch_mode, VfclibInstStaticIRFile,
                     VfclibInstDynamicIRFile));
 
+    const bool virtualFormatSet =
+        VfclibInstPrecisionBinary32.getNumOccurrences() > 0 or
+        VfclibInstPrecisionBinary64.getNumOccurrences() > 0 or
+        VfclibInstRangeBinary32.getNumOccurrences() > 0 or
+        VfclibInstRangeBinary64.getNumOccurrences() > 0;
+    if (virtualFormatSet and not rounding_mode.is_stochastic_rounding()) {
+      prism_fatal_error("Virtual precision and range require the "
+                        "stochastic-rounding mode");
+    }
+    if (dispatch_mode.is_multiversion()) {
+      multiversionTable = std::make_unique<MultiversionTable>(M);
+    }
+    virtualPrecision = std::make_unique<VirtualPrecision>(
+        M, not rounding_mode.is_stochastic_rounding(),
+        VfclibInstPrecisionBinary32, VfclibInstRangeBinary32,
+        VfclibInstPrecisionBinary64, VfclibInstRangeBinary64);
+
     // Parse both included and excluded function set
-    std::regex includeFunctionRgx =
+    FunctionSet includeFunctions =
         parseFunctionSetFile(M, VfclibInstIncludeFile);
-    std::regex excludeFunctionRgx =
+    FunctionSet excludeFunctions =
         parseFunctionSetFile(M, VfclibInstExcludeFile);
 
     // Parse instrument single function option (--function)
     if (not VfclibInstFunction.empty()) {
-      includeFunctionRgx = std::regex(VfclibInstFunction);
-      excludeFunctionRgx = std::regex(".*");
+      includeFunctions = FunctionSet();
+      includeFunctions.addRegex(VfclibInstFunction);
+      excludeFunctions = FunctionSet();
+      excludeFunctions.addPattern("*");
     }
 
     // Find the list of functions to instrument
@@ -639,13 +656,13 @@ struct VfclibInst : public ModulePass {
       }
 
       // Included-list
-      if (std::regex_match(name, includeFunctionRgx)) {
+      if (includeFunctions.match(name)) {
         functions.push_back(&F);
         continue;
       }
 
       // Excluded-list
-      if (std::regex_match(name, excludeFunctionRgx)) {
+      if (excludeFunctions.match(name)) {
         continue;
       }
 
@@ -897,6 +914,21 @@ struct VfclibInst : public ModulePass {
     return result;
   }
 
+  /* Returns the operator F, or its version selected at load time with the
+   * multiversion dispatch */
+  auto getCallee(IRBuilder<> &Builder, Instruction *I,
+                 const PrismFunction &F) -> Value * {
+    if (multiversionTable == nullptr) {
+      return F.getFunction();
+    }
+    auto *Static = prismModule->getStaticFunction(I, fops::getOpCode(I));
+    auto *table = multiversionTable->getTable(F.getFunction(), Static);
+    if (table == nullptr) {
+      return F.getFunction();
+    }
+    return Builder.CreateLoad(table->getValueType(), table);
+  }
+
   /* Replace arithmetic instructions with PR */
   auto replaceArithmeticWithPRCall(IRBuilder<> &Builder,
                                    Instruction *I) -> Value * {
@@ -912,7 +944,8 @@ struct VfclibInst : public ModulePass {
 
     auto operands = getOperands(Builder, I, F);
 
-    auto *call = Builder.CreateCall(F.getFunction(), operands);
+    auto *call = Builder.CreateCall(F.getFunction()->getFunctionType(),
+                                    getCallee(Builder, I, F), operands);
     call->setAttributes(F.getFunction()->getAttributes());
 
     Value *result = nullptr;
@@ -925,9 +958,28 @@ struct VfclibInst : public ModulePass {
       result = call;
     }
 
+    // Round the result of the operator to the virtual format
+    if (virtualPrecision->isEnabled(I->getType())) {
+      result = virtualPrecision->round(Builder, result);
+    }
+
     return result;
   }
 
+  /* Replace comparisons by comparisons of perturbed operands */
+  auto replaceComparison(IRBuilder<> &Builder, Instruction *I) -> Value * {
+    auto *cmp = cast<FCmpInst>(I);
+    Value *lhs = virtualPrecision->perturbComparison(Builder, I->getOperand(0));
+    Value *rhs = virtualPrecision->perturbComparison(Builder, I->getOperand(1));
+    return Builder.CreateFCmp(cmp->getPredicate(), lhs, rhs);
+  }
+
+  /* Replace double to float casts by a rounding to the binary32 format */
+  auto replaceCast(IRBuilder<> &Builder, Instruction *I) -> Value * {
+    return virtualPrecision->roundCast(Builder, I->getOperand(0),
+                                       I->getType());
+  }
+
   auto replaceWithPRCall(Instruction *I) -> Value * {
     if (not isValidInstruction(I)) {
       return nullptr;
@@ -944,7 +996,17 @@ struct VfclibInst : public ModulePass {
       Builder.SetInsertPoint(I->getNextNode());
     }
 
-    Value *newInst = replaceArithmeticWithPRCall(Builder, I);
+    Value *newInst = nullptr;
+    switch (fops::getOpCode(I)) {
+    case FPOps::CMP:
+      newInst = replaceComparison(Builder, I);
+      break;
+    case FPOps::CAST:
+      newInst = replaceCast(Builder, I);
+      break;
+    default:
+      newInst = replaceArithmeticWithPRCall(Builder, I);
+    }
 
     return newInst;
   }
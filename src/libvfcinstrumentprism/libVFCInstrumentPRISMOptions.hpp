@@ -38,14 +38,19 @@ public:
     errs() << "Invalid rounding mode\n";
     report_fatal_error("libVFCInstrumentPRISM fatal error");
   }
+
+  [[nodiscard]] auto is_stochastic_rounding() const -> bool {
+    return rounding_mode == PrismRoundingMode::StochasticRounding;
+  }
 };
 
 class DispatchMode {
 private:
-  enum class PrismDispatchMode { Static, Dynamic };
+  enum class PrismDispatchMode { Static, Dynamic, Multiversion };
   PrismDispatchMode dispatch_mode;
   std::string static_mode = "static";
   std::string dynamic_mode = "dynamic";
+  std::string multiversion_mode = "multiversion";
 
 public:
   explicit DispatchMode(const std::string &mode) {
@@ -53,6 +58,8 @@ public:
       dispatch_mode = PrismDispatchMode::Static;
     } else if (mode == dynamic_mode) {
       dispatch_mode = PrismDispatchMode::Dynamic;
+    } else if (mode == multiversion_mode) {
+      dispatch_mode = PrismDispatchMode::Multiversion;
     } else {
       errs() << "Invalid dispatch: " << mode << "\n";
       report_fatal_error("libVFCInstrumentPRISM fatal error");
@@ -63,7 +70,9 @@ public:
     if (dispatch_mode == PrismDispatchMode::Static) {
       return static_mode + "_dispatch";
     }
-    if (dispatch_mode == PrismDispatchMode::Dynamic) {
+    // Multiversioned calls fall back to the dynamic operators
+    if (dispatch_mode == PrismDispatchMode::Dynamic or
+        dispatch_mode == PrismDispatchMode::Multiversion) {
       return dynamic_mode + "_dispatch";
     }
     errs() << "Invalid dispatch mode\n";
@@ -77,6 +86,14 @@ public:
   [[nodiscard]] auto is_dynamic() const -> bool {
     return dispatch_mode == PrismDispatchMode::Dynamic;
   }
+
+  [[nodiscard]] auto is_multiversion() const -> bool {
+    return dispatch_mode == PrismDispatchMode::Multiversion;
+  }
+
+  [[nodiscard]] auto get_static_namespace() const -> std::string {
+    return static_mode + "_dispatch";
+  }
 };
 
 } // namespace options
@@ -112,6 +129,30 @@ static cl::opt<std::string> VfclibInstStaticIRFile(
     cl::desc("Name of the IR file that contains the static operators"),
     cl::value_desc("SRIRFile"), cl::init(""));
 
+static cl::opt<unsigned> VfclibInstPrecisionBinary32(
+    "vfclibinst-prism-precision-binary32",
+    cl::desc("Virtual precision of binary32 operations in stochastic-rounding "
+             "mode (default: 24)"),
+    cl::value_desc("Precision"), cl::init(24));
+
+static cl::opt<unsigned> VfclibInstPrecisionBinary64(
+    "vfclibinst-prism-precision-binary64",
+    cl::desc("Virtual precision of binary64 operations in stochastic-rounding "
+             "mode (default: 53)"),
+    cl::value_desc("Precision"), cl::init(53));
+
+static cl::opt<unsigned> VfclibInstRangeBinary32(
+    "vfclibinst-prism-range-binary32",
+    cl::desc("Bits of the exponent of binary32 operations in "
+             "stochastic-rounding mode (default: 8)"),
+    cl::value_desc("Range"), cl::init(8));
+
+static cl::opt<unsigned> VfclibInstRangeBinary64(
+    "vfclibinst-prism-range-binary64",
+    cl::desc("Bits of the exponent of binary64 operations in "
+             "stochastic-rounding mode (default: 11)"),
+    cl::value_desc("Range"), cl::init(11));
+
 static cl::opt<bool> VfclibInstVerbose("vfclibinst-verbose",
                                        cl::desc("Activate verbose mode"),
                                        cl::value_desc("Verbose"),
@@ -122,10 +163,20 @@ static cl::opt<std::string> VfclibInstMode(
     cl::desc("Instrumentation mode: up-down or stochastic-rounding"),
     cl::value_desc("Mode"));
 
-static cl::opt<std::string>
-    VfclibInstDispatch("vfclibinst-dispatch",
-                       cl::desc("Instrumentation dispatch: static or dynamic"),
-                       cl::value_desc("Dispatch"));
+static cl::opt<std::string> VfclibInstDispatch(
+    "vfclibinst-dispatch",
+    cl::desc("Instrumentation dispatch: static, dynamic or multiversion"),
+    cl::value_desc("Dispatch"));
+
+static cl::opt<bool>
+    VfclibInstInstrumentFCMP("vfclibinst-inst-fcmp",
+                             cl::desc("Instrument floating point comparisons"),
+                             cl::value_desc("InstrumentFCMP"), cl::init(false));
+
+static cl::opt<bool> VfclibInstInstrumentCast(
+    "vfclibinst-inst-cast",
+    cl::desc("Instrument floating point cast instructions"),
+    cl::value_desc("InstrumentCast"), cl::init(false));
 
 static cl::opt<bool>
     VfclibInstInstrumentFMA("vfclibinst-inst-fma",
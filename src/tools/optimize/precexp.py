@@ -1,8 +1,10 @@
 #!/usr/bin/env python3
 
 import argparse
+import concurrent.futures
 import math
 import os.path
+import queue
 import shlex
 import subprocess
 import sys
@@ -322,271 +324,194 @@ def Check(
     return cmp(cmpPath, reference_dir, current_dir, env)
 
 
-def dich_search_operations(
-    index,
-    field,
-    l,
-    r,
-    runPath,
-    cmpPath,
-    reference_dir,
-    current_dir,
-    config_file,
-    env,
-    Arguments,
-    Operations,
-):
-    """Dichotomic research to find the minimum precision for given field"""
+class Slot:
+    """Private execution context of one concurrent run: its own
+    configuration file, output directory and environment"""
 
-    Operations.at[index, field] = l
-
-    if not Check(
-        runPath,
-        cmpPath,
-        reference_dir,
-        current_dir,
-        config_file,
-        env,
-        Arguments,
-        Operations,
-    ):
-        flag = 1
-        while flag:
-            p = math.floor((r + l) / 2)
-            Operations.at[index, field] = p
-            if Check(
-                runPath,
-                cmpPath,
-                reference_dir,
-                current_dir,
-                config_file,
-                env,
-                Arguments,
-                Operations,
-            ):
-                if l >= r:
-                    flag = 0
-                    break
-                r = p
-            else:
-                l = p + 1
+    def __init__(self, rank, backend, env):
+        if rank == 0:
+            self.config_file = vfc_config_file
+            self.current_dir = output_dir[1]
+        else:
+            self.config_file = os.path.join(
+                "vfc_exp_data", "worker_{}".format(rank), vfc_config_file
+            )
+            self.current_dir = "{}_{}".format(output_dir[1], rank)
+            os.makedirs(os.path.dirname(self.config_file), exist_ok=True)
 
+        if not os.path.isdir(self.current_dir):
+            os.mkdir(self.current_dir)
 
-def search_minimum_operations(
-    runPath,
-    cmpPath,
-    reference_dir,
-    current_dir,
-    config_file,
-    env,
-    Arguments,
-    Operations,
-    index,
-):
-    """Find the minimum precision for the internal operations of the given function"""
-
-    # if the function uses double precision operations
-    if Operations.at[index, "Double"]:
-        # minimize mantissa
-        dich_search_operations(
-            index,
-            "Prec64",
-            1,
-            52,
-            runPath,
-            cmpPath,
-            reference_dir,
-            current_dir,
-            config_file,
-            env,
-            Arguments,
-            Operations,
-        )
-        # minimize exponent
-        dich_search_operations(
-            index,
-            "Range64",
-            2,
-            11,
-            runPath,
-            cmpPath,
-            reference_dir,
-            current_dir,
-            config_file,
-            env,
-            Arguments,
-            Operations,
-        )
-    else:
-        Operations.at[index, "Prec64"] = 1
-        Operations.at[index, "Range64"] = 2
-
-    # if the function uses simple precision operations
-    if Operations.at[index, "Float"]:
-        # minimize mantissa
-        dich_search_operations(
-            index,
-            "Prec32",
-            1,
-            23,
-            runPath,
-            cmpPath,
-            reference_dir,
-            current_dir,
-            config_file,
-            env,
-            Arguments,
-            Operations,
-        )
-        # minimize exponent
-        dich_search_operations(
-            index,
-            "Range32",
-            2,
-            8,
-            runPath,
-            cmpPath,
-            reference_dir,
-            current_dir,
-            config_file,
-            env,
-            Arguments,
-            Operations,
+        self.env = set_environment_variable(
+            "VFC_BACKENDS", backend.format(self.config_file), env.copy()
         )
-    else:
-        Operations.at[index, "Prec32"] = 1
-        Operations.at[index, "Range32"] = 2
 
 
-def dich_search_arguments(
-    index,
-    field,
-    l,
-    r,
-    runPath,
-    cmpPath,
-    reference_dir,
-    current_dir,
-    config_file,
-    env,
-    Arguments,
-    Operations,
-):
-    """Dichotomic research to find the minimum precision for given field"""
+class Explorer:
+    """Runs the precision searches on a bounded pool of slots.
 
-    Arguments.at[index, field] = l
+    jobs   -- maximum number of programs executed at the same time
+    points -- number of candidates evaluated at each step of a search,
+              1 is the classical bisection
+    """
 
-    # minimize mantissa
-    if not Check(
-        runPath,
-        cmpPath,
-        reference_dir,
-        current_dir,
-        config_file,
-        env,
-        Arguments,
-        Operations,
-    ):
-        flag = 1
-        while flag:
-            p = math.floor((r + l) / 2)
-            Arguments.at[index, field] = p
-            if Check(
-                runPath,
-                cmpPath,
-                reference_dir,
-                current_dir,
-                config_file,
-                env,
+    def __init__(self, runPath, cmpPath, backend, env, jobs=1, points=1):
+        self.runPath = runPath
+        self.cmpPath = cmpPath
+        self.jobs = max(1, jobs)
+        self.points = max(1, points)
+        self.slots = queue.Queue()
+        for rank in range(self.jobs):
+            self.slots.put(Slot(rank, backend, env))
+
+    def check(self, Arguments, Operations):
+        """Run the program on a free slot with the given configuration"""
+        slot = self.slots.get()
+        try:
+            return Check(
+                self.runPath,
+                self.cmpPath,
+                output_dir[0],
+                slot.current_dir,
+                slot.config_file,
+                slot.env,
                 Arguments,
                 Operations,
-            ):
-                if l >= r:
-                    flag = 0
+            )
+        finally:
+            self.slots.put(slot)
+
+    def check_candidates(self, frame, index, field, candidates, Arguments, Operations):
+        """Evaluate several precisions of the same field concurrently,
+        each one on a private copy of the configuration"""
+
+        def evaluate(p):
+            args = Arguments.copy()
+            ops = Operations.copy()
+            target = args if frame == "Arguments" else ops
+            target.at[index, field] = p
+            return self.check(args, ops)
+
+        if len(candidates) == 1:
+            return [evaluate(candidates[0])]
+
+        with concurrent.futures.ThreadPoolExecutor(len(candidates)) as pool:
+            return list(pool.map(evaluate, candidates))
+
+    def dich_search(self, frame, index, field, l, r, Arguments, Operations):
+        """Multi-point dichotomic research to find the minimum precision
+        for given field, assuming that the maximum precision r passes"""
+
+        target = Arguments if frame == "Arguments" else Operations
+
+        if self.check_candidates(frame, index, field, [l], Arguments, Operations)[0]:
+            target.at[index, field] = l
+            return
+
+        # invariant: l fails and r passes
+        while r - l > 1:
+            step = (r - l) / (self.points + 1)
+            candidates = sorted(
+                {l + max(1, math.floor(step * k)) for k in range(1, self.points + 1)}
+                - {r}
+            )
+            results = self.check_candidates(
+                frame, index, field, candidates, Arguments, Operations
+            )
+            for p, passed in zip(candidates, results):
+                if passed:
+                    r = p
                     break
-                r = p
-            else:
-                l = p + 1
-
-
-def search_minimum_arguments(
-    runPath,
-    cmpPath,
-    reference_dir,
-    current_dir,
-    config_file,
-    env,
-    Arguments,
-    Operations,
-    index,
-):
-    """Find the minimum precision for a given argument of a function"""
-
-    # If is a float or float ptr
-    if Arguments.at[index, "Type"] == 0 or Arguments.at[index, "Type"] == 2:
-        # minimize mantissa
-        dich_search_arguments(
-            index,
-            "Prec",
-            1,
-            23,
-            runPath,
-            cmpPath,
-            reference_dir,
-            current_dir,
-            config_file,
-            env,
-            Arguments,
-            Operations,
-        )
-        # minimize exponent
-        dich_search_arguments(
-            index,
-            "Range",
-            2,
-            8,
-            runPath,
-            cmpPath,
-            reference_dir,
-            current_dir,
-            config_file,
-            env,
-            Arguments,
-            Operations,
-        )
-
-    # If is a double or double ptr
-    elif Arguments.at[index, "Type"] == 1 or Arguments.at[index, "Type"] == 3:
-        # minimize mantissa
-        dich_search_arguments(
-            index,
-            "Prec",
-            1,
-            52,
-            runPath,
-            cmpPath,
-            reference_dir,
-            current_dir,
-            config_file,
-            env,
-            Arguments,
-            Operations,
-        )
-        # minimize exponent
-        dich_search_arguments(
-            index,
-            "Range",
-            2,
-            11,
-            runPath,
-            cmpPath,
-            reference_dir,
-            current_dir,
-            config_file,
-            env,
-            Arguments,
-            Operations,
-        )
+                l = p
+
+        target.at[index, field] = r
+
+    def search_minimum_operations(self, Arguments, Operations, index):
+        """Find the minimum precision for the internal operations of the given function"""
+
+        # if the function uses double precision operations
+        if Operations.at[index, "Double"]:
+            # minimize mantissa
+            self.dich_search("Operations", index, "Prec64", 1, 52, Arguments, Operations)
+            # minimize exponent
+            self.dich_search("Operations", index, "Range64", 2, 11, Arguments, Operations)
+        else:
+            Operations.at[index, "Prec64"] = 1
+            Operations.at[index, "Range64"] = 2
+
+        # if the function uses simple precision operations
+        if Operations.at[index, "Float"]:
+            # minimize mantissa
+            self.dich_search("Operations", index, "Prec32", 1, 23, Arguments, Operations)
+            # minimize exponent
+            self.dich_search("Operations", index, "Range32", 2, 8, Arguments, Operations)
+        else:
+            Operations.at[index, "Prec32"] = 1
+            Operations.at[index, "Range32"] = 2
+
+    def search_minimum_arguments(self, Arguments, Operations, index):
+        """Find the minimum precision for a given argument of a function"""
+
+        # If is a float or float ptr
+        if Arguments.at[index, "Type"] == 0 or Arguments.at[index, "Type"] == 2:
+            # minimize mantissa
+            self.dich_search("Arguments", index, "Prec", 1, 23, Arguments, Operations)
+            # minimize exponent
+            self.dich_search("Arguments", index, "Range", 2, 8, Arguments, Operations)
+
+        # If is a double or double ptr
+        elif Arguments.at[index, "Type"] == 1 or Arguments.at[index, "Type"] == 3:
+            # minimize mantissa
+            self.dich_search("Arguments", index, "Prec", 1, 52, Arguments, Operations)
+            # minimize exponent
+            self.dich_search("Arguments", index, "Range", 2, 11, Arguments, Operations)
+
+    def explore(self, tasks, Arguments, Operations):
+        """Run the given tasks, a task being a list of (kind, index) searches.
+
+        With a single job, tasks are run in order and each one sees the
+        precisions found by the previous ones. Otherwise independent tasks
+        are searched concurrently from the initial configuration, their
+        results are merged and the merged configuration is checked again.
+        """
+
+        def search(task, args, ops):
+            for kind, index in task:
+                if kind == "arguments":
+                    self.search_minimum_arguments(args, ops, index)
+                else:
+                    self.search_minimum_operations(args, ops, index)
+
+        if self.jobs == 1:
+            for cpt, task in enumerate(tasks, 1):
+                print(cpt, "/", len(tasks))
+                search(task, Arguments, Operations)
+            return
+
+        def run_task(task):
+            args = Arguments.copy()
+            ops = Operations.copy()
+            search(task, args, ops)
+            return task, args, ops
+
+        with concurrent.futures.ThreadPoolExecutor(self.jobs) as pool:
+            futures = [pool.submit(run_task, task) for task in tasks]
+            for cpt, future in enumerate(
+                concurrent.futures.as_completed(futures), 1
+            ):
+                task, args, ops = future.result()
+                print(cpt, "/", len(tasks))
+                for kind, index in task:
+                    if kind == "arguments":
+                        Arguments.loc[index] = args.loc[index]
+                    else:
+                        Operations.loc[index] = ops.loc[index]
+
+        if not self.check(Arguments, Operations):
+            print(
+                "Warning: the merged configuration does not pass the comparison, "
+                "rerun with --jobs=1 for a sequential search"
+            )
 
 
 def main():
@@ -616,6 +541,21 @@ def main():
         default="ob",
         help="vprec operating mode",
     )
+    parser.add_argument(
+        "-j",
+        "--jobs",
+        type=int,
+        default=1,
+        help="number of executions run concurrently, independent functions "
+        "and arguments are explored in parallel when greater than 1",
+    )
+    parser.add_argument(
+        "--search-points",
+        type=int,
+        default=1,
+        help="number of precisions evaluated concurrently at each step "
+        "of the dichotomic search (1 is a classical bisection)",
+    )
 
     args = parser.parse_known_args()
 
@@ -626,6 +566,7 @@ def main():
     runPath = args[0].runPath
     cmpPath = args[0].cmpPath
 
+    global vfc_maxTimeout
     vfc_vprec_mode = args[0].vprec_mode
     vfc_mode = args[0].mode
     if args[0].maxTimeout != None:
@@ -688,37 +629,23 @@ def main():
         vfc_profile_file, function_list
     )
 
+    backend = (
+        "libinterflop_vprec.so --prec-input-file={{}} --daz --ftz --mode={} "
+        "--instrument={}".format(vfc_vprec_mode, vfc_mode)
+    )
+    explorer = Explorer(
+        runPath, cmpPath, backend, env, args[0].jobs, args[0].search_points
+    )
+
     #########################################
     #  				Explore Operations 	    #
     #########################################
     if vfc_mode == "operations":
         print("-------------- Operations --------------")
 
-        # set backend
-        set_environment_variable(
-            "VFC_BACKENDS",
-            "libinterflop_vprec.so --prec-input-file={} --daz --ftz --mode={} --instrument=operations".format(
-                vfc_config_file, vfc_vprec_mode
-            ),
-            env,
-        )
-
         FunctionsFrameCopy = FunctionsFrame.copy()
-        cpt = 1
-        for i in FunctionsIndex:
-            print(cpt, "/", len(FunctionsIndex))
-            search_minimum_operations(
-                runPath,
-                cmpPath,
-                output_dir[0],
-                output_dir[1],
-                vfc_config_file,
-                env,
-                ArgumentsFrame,
-                FunctionsFrameCopy,
-                i,
-            )
-            cpt += 1
+        tasks = [[("operations", i)] for i in FunctionsIndex]
+        explorer.explore(tasks, ArgumentsFrame, FunctionsFrameCopy)
 
         FunctionsFrameCopy.to_csv("vfc_exp_data/OperationsResults.csv")
 
@@ -728,37 +655,15 @@ def main():
     if vfc_mode == "arguments":
         print("-------------- Arguments --------------")
 
-        # set backend
-        set_environment_variable(
-            "VFC_BACKENDS",
-            "libinterflop_vprec.so --prec-input-file={} --daz --ftz --mode={} --instrument=arguments".format(
-                vfc_config_file, vfc_vprec_mode
-            ),
-            env,
-        )
-
         ArgumentsFrameCopy = ArgumentsFrame.copy()
         FunctionsFrameCopy = FunctionsFrame.copy()
-        cpt = 1
+        tasks = []
         for i in range(len(FunctionsFrame.index)):
             tmp = ArgumentsFrameCopy[
                 (ArgumentsFrameCopy["ID"] == FunctionsFrameCopy.at[i, "ID"])
             ]
-            for j in tmp.index:
-                print(cpt, "/", len(ArgumentsFrameCopy.index))
-                search_minimum_arguments(
-                    runPath,
-                    cmpPath,
-                    output_dir[0],
-                    output_dir[1],
-                    vfc_config_file,
-                    env,
-                    ArgumentsFrameCopy,
-                    FunctionsFrameCopy,
-                    j,
-                )
-
-                cpt += 1
+            tasks += [[("arguments", j)] for j in tmp.index]
+        explorer.explore(tasks, ArgumentsFrameCopy, FunctionsFrameCopy)
 
         ArgumentsFrameCopy.to_csv("vfc_exp_data/ArgumentsResults.csv")
 
@@ -768,53 +673,18 @@ def main():
     if vfc_mode == "all":
         print("-------------- All --------------")
 
-        # set backend
-        set_environment_variable(
-            "VFC_BACKENDS",
-            "libinterflop_vprec.so --prec-input-file={} --daz --ftz --mode={} --instrument=all".format(
-                vfc_config_file, vfc_vprec_mode
-            ),
-            env,
-        )
-
         ArgumentsFrameCopy = ArgumentsFrame.copy()
         FunctionsFrameCopy = FunctionsFrame.copy()
-        cpt = 1
+        tasks = []
         for i in range(len(FunctionsFrameCopy.index)):
-            print(cpt, "/", len(FunctionsFrameCopy.index))
             tmp = ArgumentsFrameCopy[
                 (ArgumentsFrameCopy["ID"] == FunctionsFrameCopy.at[i, "ID"])
             ]
-            for j in tmp.index:
-                search_minimum_arguments(
-                    runPath,
-                    cmpPath,
-                    output_dir[0],
-                    output_dir[1],
-                    vfc_config_file,
-                    env,
-                    ArgumentsFrameCopy,
-                    FunctionsFrameCopy,
-                    j,
-                )
+            task = [("arguments", j) for j in tmp.index]
             if i in FunctionsIndex:
-                search_minimum_operations(
-                    runPath,
-                    cmpPath,
-                    output_dir[0],
-                    output_dir[1],
-                    vfc_config_file,
-                    env,
-                    ArgumentsFrameCopy,
-                    FunctionsFrameCopy,
-                    i,
-                )
-
-            tmp = ArgumentsFrameCopy[
-                (ArgumentsFrameCopy["ID"] == FunctionsFrameCopy.at[i, "ID"])
-            ]
-
-            cpt += 1
+                task.append(("operations", i))
+            tasks.append(task)
+        explorer.explore(tasks, ArgumentsFrameCopy, FunctionsFrameCopy)
 
         ArgumentsFrameCopy.to_csv("vfc_exp_data/AllArgsResults.csv")
         FunctionsFrameCopy.to_csv("vfc_exp_data/AllOpsResults.csv")
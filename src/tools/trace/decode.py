@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+"""Render a binary trace written by libinterflop_ieee.so --trace-file
+
+The output reproduces the text format of the --debug and --debug-binary
+options of the ieee backend.
+"""
+
+import argparse
+import math
+import struct
+import sys
+
+MAGIC = b"VFCTRACE"
+VERSION = 1
+
+# call_site, operands[3], result, op, type, predicate, reserved, thread
+RECORD = struct.Struct("@Q4dbbbbI")
+HEADER = struct.Struct("@8sII")
+
+# ieee_op
+OPS = ["+", "-", "*", "/", "fma", "cmp", "(float)"]
+OP_CMP = 5
+OP_CAST = 6
+OP_FMA = 4
+
+# enum FTYPES
+FFLOAT = 0
+
+FCMP_PREDICATES = [
+    "FCMP_FALSE",
+    "FCMP_OEQ",
+    "FCMP_OGT",
+    "FCMP_OGE",
+    "FCMP_OLT",
+    "FCMP_OLE",
+    "FCMP_ONE",
+    "FCMP_ORD",
+    "FCMP_UNO",
+    "FCMP_UEQ",
+    "FCMP_UGT",
+    "FCMP_UGE",
+    "FCMP_ULT",
+    "FCMP_ULE",
+    "FCMP_UNE",
+    "FCMP_TRUE",
+]
+
+# (exponent size, mantissa size, exponent bias)
+FORMATS = {"float": (8, 23, 127), "double": (11, 52, 1023)}
+
+
+def to_binary(x, fmt, subnormal_normalized):
+    """Format x as printf_specifier.c does for the %b specifier"""
+    exp_size, man_size, bias = FORMATS[fmt]
+    if fmt == "float":
+        bits = struct.unpack("<I", struct.pack("<f", x))[0]
+    else:
+        bits = struct.unpack("<Q", struct.pack("<d", x))[0]
+    sign = "-" if bits >> (exp_size + man_size) else "+"
+    exponent = (bits >> man_size) & ((1 << exp_size) - 1)
+    mantissa = bits & ((1 << man_size) - 1)
+
+    def mantissa_str(m, size):
+        s = format(m, "0{}b".format(size)).rstrip("0")
+        return s if s else "0"
+
+    if exponent == (1 << exp_size) - 1:
+        return "+nan" if mantissa else sign + "inf"
+    if exponent == 0 and mantissa == 0:
+        return "{}0.0 x 2^0".format(sign)
+    if exponent == 0:
+        if subnormal_normalized:
+            offset = man_size - mantissa.bit_length() + 1
+            m = (mantissa << offset) & ((1 << man_size) - 1)
+            return "{}1.{} x 2^{}".format(
+                sign, mantissa_str(m, man_size), -(bias - 1) - offset
+            )
+        return "{}0.{} x 2^{}".format(
+            sign, mantissa_str(mantissa, man_size), 1 - bias
+        )
+    return "{}1.{} x 2^{}".format(
+        sign, mantissa_str(mantissa, man_size), exponent - bias
+    )
+
+
+def to_decimal(x, fmt, _):
+    """Format x as printf %g does, including the sign of NaNs"""
+    if math.isnan(x):
+        return "-nan" if math.copysign(1, x) < 0 else "nan"
+    return "{:g}".format(x)
+
+
+def render(record, args, out):
+    call_site, a, b, c, res, op, ftype, predicate, _, thread = record
+    fmt = "float" if ftype == FFLOAT else "double"
+    if args.binary:
+        header = "Binary "
+        conv = to_binary
+    else:
+        header = "Decimal "
+        conv = to_decimal
+
+    def g(x, f=fmt):
+        return conv(x, f, args.subnormal_normalized)
+
+    nl = "\n" if args.print_new_line else ""
+    if args.call_site:
+        out.write("[{:#x}] ".format(call_site))
+    if not args.no_backend_name:
+        out.write("Info [interflop-ieee]: " + header + nl)
+
+    if op == OP_CMP:
+        parts = [
+            "{} [{}] ".format(g(a), FCMP_PREDICATES[predicate]),
+            "{} -> {}\n".format(g(b), "true" if res else "false"),
+        ]
+    elif op == OP_CAST:
+        parts = [
+            "{} (float) -> ".format(g(a, "double")),
+            "{}\n".format(g(res, "float")),
+        ]
+    elif op == OP_FMA:
+        parts = [
+            "{} * ".format(g(a)),
+            "{} + ".format(g(b)),
+            "{} -> ".format(g(c)),
+            "{}\n".format(g(res)),
+        ]
+    else:
+        parts = [
+            "{} {} ".format(g(a), OPS[op]),
+            "{} -> ".format(g(b)),
+            "{}\n".format(g(res)),
+        ]
+    for part in parts:
+        out.write(part + nl)
+
+
+def decode(stream, args, out):
+    header = stream.read(HEADER.size)
+    if len(header) != HEADER.size:
+        sys.exit("error: truncated trace header")
+    magic, version, record_size = HEADER.unpack(header)
+    if magic != MAGIC:
+        sys.exit("error: not a verificarlo trace")
+    if version != VERSION or record_size != RECORD.size:
+        sys.exit(
+            "error: unsupported trace version {} (record size {})".format(
+                version, record_size
+            )
+        )
+
+    while True:
+        chunk = stream.read(RECORD.size * 4096)
+        if not chunk:
+            break
+        if len(chunk) % RECORD.size:
+            sys.exit("error: truncated trace record")
+        for record in RECORD.iter_unpack(chunk):
+            if args.thread is not None and record[-1] != args.thread:
+                continue
+            render(record, args, out)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Render a binary trace written by "
+        "libinterflop_ieee.so --trace-file in the --debug text format"
+    )
+    parser.add_argument("trace", help="binary trace file")
+    parser.add_argument(
+        "-b",
+        "--binary",
+        action="store_true",
+        help="render values in the --debug-binary format",
+    )
+    parser.add_argument(
+        "-s",
+        "--no-backend-name",
+        action="store_true",
+        help="do not print backend name",
+    )
+    parser.add_argument(
+        "-n",
+        "--print-new-line",
+        action="store_true",
+        help="add a new line after each value",
+    )
+    parser.add_argument(
+        "-p",
+        "--subnormal-normalized",
+        action="store_true",
+        help="normalize subnormal numbers in --binary mode",
+    )
+    parser.add_argument(
+        "--call-site",
+        action="store_true",
+        help="prefix each operation with its call site address",
+    )
+    parser.add_argument(
+        "--thread", type=int, default=None, help="only render the given thread"
+    )
+    args = parser.parse_args()
+
+    with open(args.trace, "rb") as stream:
+        try:
+            decode(stream, args, sys.stdout)
+        except BrokenPipeError:
+            pass
+
+
+if __name__ == "__main__":
+    main()
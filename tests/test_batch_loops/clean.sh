@@ -0,0 +1,3 @@
+#!/bin/bash
+
+rm -f *.o *.log test-loop test-batch .vfcwrapper* *~
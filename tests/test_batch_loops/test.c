@@ -0,0 +1,43 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#define N 1000
+
+__attribute__((noinline)) void map(int n, const double *a, const double *b,
+                                   double *c) {
+  for (int i = 0; i < n; i++) {
+    c[i] = a[i] + b[i];
+  }
+}
+
+__attribute__((noinline)) void map_float(int n, const float *a,
+                                         const float *b, float *c) {
+  for (int i = 0; i < n; i++) {
+    c[i] = a[i] * b[i];
+  }
+}
+
+__attribute__((noinline)) double reduce(int n, const double *a) {
+  double s = 0;
+  for (int i = 0; i < n; i++) {
+    s += a[i];
+  }
+  return s;
+}
+
+int main(void) {
+  static double a[N], b[N], c[N];
+  static float fa[N], fb[N], fc[N];
+  for (int i = 0; i < N; i++) {
+    a[i] = 1.0 / (i + 1);
+    b[i] = 1.0 / (i + 3);
+    fa[i] = a[i];
+    fb[i] = b[i];
+  }
+  map(N, a, b, c);
+  map_float(N, fa, fb, fc);
+  /* in place */
+  map(N, c, b, c);
+  printf("%.17g %.9g %.17g\n", reduce(N, c), fc[N - 1], reduce(N, a));
+  return 0;
+}
@@ -0,0 +1,39 @@
+#!/bin/bash
+
+set -e
+
+export VFC_BACKENDS_LOGGER_SILENT_LOAD=True
+
+verificarlo-c -O2 test.c -o test-loop
+verificarlo-c -O2 --batch-loops --verbose test.c -o test-batch 2>verbose.log
+
+batched=$(grep -c "^Batched loop" verbose.log || true)
+echo "batched loops: $batched"
+if [ "$batched" -lt 3 ]; then
+    echo "loops not batched"
+    cat verbose.log
+    exit 1
+fi
+
+# Batching does not change the results of deterministic backends
+for backend in "libinterflop_ieee.so" \
+    "libinterflop_bitmask.so --operator=zero --precision-binary64=30 --precision-binary32=12" \
+    "libinterflop_vprec.so --precision-binary64=30 --precision-binary32=12"; do
+    VFC_BACKENDS="$backend" ./test-loop >loop.log
+    VFC_BACKENDS="$backend" ./test-batch >batch.log
+    if ! diff loop.log batch.log; then
+        echo "results differ with --batch-loops for $backend"
+        exit 1
+    fi
+done
+
+# Batched operations are still perturbed
+for i in $(seq 1 5); do
+    VFC_BACKENDS="libinterflop_mca.so --mode=rr" ./test-batch
+done >mca.log
+if [ "$(sort -u mca.log | wc -l)" -eq 1 ]; then
+    echo "batched operations are not instrumented"
+    exit 1
+fi
+
+echo "Test successed"
@@ -1,3 +1,3 @@
 #!/bin/bash
 
-rm -Rf *~ output.txt test.log test_float test_double *.o .*.o
+rm -Rf *~ output.txt test.log test_float test_double test_double_profile profile.json *.o .*.o
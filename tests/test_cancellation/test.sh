@@ -11,16 +11,36 @@ parallel --header : "verificarlo-c test_{type}.c -o test_{type}" ::: type float
 
 rm -f output.txt
 
+# Cancellations are reported per call site at exit, the addresses of the call
+# sites depend on the build
+filter_call_sites() {
+	sed -e 's/ detected at 0x[0-9a-f]*$/ detected at <call site>/'
+}
+
 for i in $(seq 0 23); do
 	export VFC_BACKENDS="libinterflop_cancellation.so --tolerance $i --seed=$SEED --warning=WARNING"
-	./test_float $i >>output.txt 2>&1
+	./test_float $i 2>&1 | filter_call_sites >>output.txt
 done
 
 for i in $(seq 0 52); do
 	export VFC_BACKENDS="libinterflop_cancellation.so --tolerance $i --seed=$SEED --warning=WARNING"
-	./test_double $i >>output.txt 2>&1
+	./test_double $i 2>&1 | filter_call_sites >>output.txt
 done
 
+# The profile attributes the cancellation to the subtraction of test_double.c
+verificarlo-c -g test_double.c -o test_double_profile
+export VFC_BACKENDS="libinterflop_cancellation.so --tolerance 10 --seed=$SEED --profile-file=profile.json"
+./test_double_profile 20 >/dev/null 2>&1
+python3 - <<EOF
+import json
+sites = json.load(open("profile.json"))["sites"]
+assert len(sites) == 1, sites
+site = sites[0]
+assert site["count"] == 1 and site["max"] == 20, site
+assert site["sizes"] == {"20": 1}, site
+assert "test_double.c:24" in site["location"], site
+EOF
+
 echo $(diff -U 0 result.txt output.txt | grep ^@ | wc -l)
 
 if [ $(diff -U 0 result.txt output.txt | grep ^@ | wc -l) == 0 ]; then
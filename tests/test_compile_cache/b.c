@@ -0,0 +1,12 @@
+#include <stdio.h>
+
+double f(double x, double y);
+
+int main(void) {
+  double s = 0;
+  for (int i = 1; i < 100; i++) {
+    s += f(1.0, i);
+  }
+  printf("%.17g\n", s);
+  return 0;
+}
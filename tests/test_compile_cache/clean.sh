@@ -0,0 +1,3 @@
+#!/bin/bash
+
+rm -rf *.o *.log test-ref test-miss test-hit .cache .vfcwrapper* *~
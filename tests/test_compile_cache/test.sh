@@ -0,0 +1,44 @@
+#!/bin/bash
+
+set -e
+
+export VFC_BACKENDS_LOGGER_SILENT_LOAD=True
+export VFC_BACKENDS="libinterflop_ieee.so"
+export VFC_CACHE_DIR=$PWD/.cache
+rm -rf $VFC_CACHE_DIR
+
+# Reference without cache
+VFC_CACHE_DIR= verificarlo-c a.c b.c -o test-ref
+./test-ref >ref.log
+
+# First build fills the cache, the second one reuses everything
+verificarlo-c -j 2 --show-cmd a.c b.c -o test-miss >miss.log
+verificarlo-c -j 2 --show-cmd a.c b.c -o test-hit >hit.log
+
+if grep -q "cache hit" miss.log; then
+    echo "unexpected cache hit on an empty cache"
+    exit 1
+fi
+# vfcwrapper IR, a.c, b.c and the vfcwrapper object
+hits=$(grep -c "cache hit" hit.log)
+if [ "$hits" -ne 4 ]; then
+    echo "expected 4 cache hits, got $hits"
+    cat hit.log
+    exit 1
+fi
+if grep -q -- "-vfclibinst" hit.log; then
+    echo "instrumentation pass run despite the cache"
+    exit 1
+fi
+
+./test-hit >out.log
+diff ref.log out.log
+
+# Changing the instrumentation options invalidates the cache
+verificarlo-c --show-cmd --inst-fcmp -c a.c -o a.o >fcmp.log
+if ! grep -q -- "-vfclibinst-inst-fcmp" fcmp.log; then
+    echo "cache reused with different instrumentation options"
+    exit 1
+fi
+
+echo "Test successed"
@@ -1,3 +1,3 @@
 #!/bin/bash
 
-rm -Rf *~ log* test test.log test_options_* *.ll *.o .vfcwrapper* .test*
+rm -Rf *~ log* profile_*.json trace_*.bin decoded_* test test.log test_options_* *.ll *.o .vfcwrapper* .test*
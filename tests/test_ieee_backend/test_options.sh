@@ -116,7 +116,37 @@ test7() {
     )" "Error no counts printed"
 }
 
+test8() {
+    local id=8
+    DEBUG_MODE="--profile-file=profile_${id}_$1.json"
+    OPTIONS=""
+    TYPE=$1
+    LOG=$(run $TYPE $id $DEBUG_MODE $OPTIONS)
+    check $id "$TYPE" "$(
+        python3 -c "import json; json.load(open('profile_${id}_${TYPE}.json'))['sites'][0]['call_site']"
+        echo $?
+    )" "Error invalid profile written"
+    # the object and offset of a site are symbolized by addr2line
+    local SITE=$(python3 -c "import json; s = json.load(open('profile_${id}_${TYPE}.json'))['sites'][0]; print(s['object'], s['offset'])")
+    check $id "$TYPE" "$(
+        addr2line -e $SITE | grep -q "test_options.c:"
+        echo $?
+    )" "Error profile call site not symbolized"
+}
+
+test9() {
+    local id=9
+    TYPE=$1
+    LOG=$(run $TYPE $id "--debug" "")
+    run $TYPE ${id}_trace "--trace-file=trace_${id}_${TYPE}.bin" "" >/dev/null
+    vfc_trace_decode trace_${id}_${TYPE}.bin >decoded_${id}_${TYPE}
+    check $id "$TYPE" "$(
+        diff <(grep "Decimal" ${LOG}) <(grep "Decimal" decoded_${id}_${TYPE})
+        echo $?
+    )" "Error decoded trace differs from debug output"
+}
+
 export -f run check
-export -f test1 test2 test3 test4 test5 test6 test7
+export -f test1 test2 test3 test4 test5 test6 test7 test8 test9
 
-parallel --header : "test{test} {type}" ::: test {1..7} ::: type float double
+parallel --header : "test{test} {type}" ::: test {1..9} ::: type float double
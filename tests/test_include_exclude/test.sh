@@ -247,7 +247,25 @@ HERE
     did_not_instrument g2 dir2_b
 }
 
+test10() {
+    new_env test10
+    echo "SUBTEST 10: Check large include-list with exact names, globs and regex"
+    for i in $(seq 1 20000); do
+        echo "a function_$i"
+    done >include.txt
+    cat >>include.txt <<HERE
+a f1
+a h*
+a g[2]
+HERE
+    verificarlo-c --verbose -c --include-file include.txt a.c 2>a
+    did_instrument f1 a
+    did_not_instrument f2 a
+    did_not_instrument g1 a
+    did_instrument g2 a
+}
+
 export -f new_env did_not_instrument did_instrument
-export -f test1 test2 test3 test4 test5 test6 test7 test8 test9
+export -f test1 test2 test3 test4 test5 test6 test7 test8 test9 test10
 
-parallel -j $(nproc) ::: test1 test2 test3 test4 test5 test6 test7 test8 test9
+parallel -j $(nproc) ::: test1 test2 test3 test4 test5 test6 test7 test8 test9 test10
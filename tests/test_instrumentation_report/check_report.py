@@ -0,0 +1,23 @@
+#!/usr/bin/env python3
+
+import json
+import sys
+
+with open(sys.argv[1]) as f:
+    report = json.load(f)
+
+functions = {f["name"]: f for f in report["functions"]}
+
+sum_div = functions["sum_div"]
+assert sum_div["selected"], "sum_div must be instrumented"
+assert sum_div["instrumented"] >= 2, "sum_div must have an add and a div"
+assert len(sum_div["loops"]) >= 1, "the loop of sum_div must be reported"
+assert sum_div["loops"][0]["instrumented"] >= 2, "the loop must hold the operations"
+ops = {op["op"] for op in sum_div["operations"]}
+assert {"add", "div"} <= ops, f"missing operations in {ops}"
+
+scale = functions["scale"]
+assert not scale["selected"], "scale must be excluded"
+assert scale["excluded"] == 1 and scale["instrumented"] == 0
+
+print("report ok")
@@ -0,0 +1,3 @@
+#!/bin/bash
+
+rm -f *.o *.vfcreport.json .vfcwrapper* *~
@@ -0,0 +1,22 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+double sum_div(int n, const double *x, const double *y) {
+  double s = 0;
+  for (int i = 0; i < n; i++) {
+    s += x[i] / y[i];
+  }
+  return s;
+}
+
+float scale(float x) { return x * 0.5f; }
+
+int main(int argc, char *argv[]) {
+  double x[100], y[100];
+  for (int i = 0; i < 100; i++) {
+    x[i] = 1.0 / (i + 1);
+    y[i] = i + 1;
+  }
+  printf("%f %f\n", sum_div(100, x, y), scale(argc));
+  return 0;
+}
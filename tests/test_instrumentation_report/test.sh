@@ -0,0 +1,14 @@
+#!/bin/bash
+
+set -e
+
+verificarlo-c -O1 -g --instrumentation-report --function sum_div -c test.c -o test.o
+
+if [ ! -f test.vfcreport.json ]; then
+    echo "report not written"
+    exit 1
+fi
+
+python3 check_report.py test.vfcreport.json
+
+echo "Test successed"
@@ -0,0 +1,3 @@
+#!/bin/bash
+
+rm -rf *.o *.log test-lto test-ref test-static-ref test-static-lto test-native .vfcwrapper* .vfcprogram* *~
@@ -0,0 +1 @@
+double axpy(double a, double x, double y) { return a * x + y; }
@@ -0,0 +1,12 @@
+#include <stdio.h>
+
+double axpy(double a, double x, double y);
+
+int main(void) {
+  double s = 0;
+  for (int i = 1; i < 100; i++) {
+    s = axpy(1.0 / i, 0.1, s);
+  }
+  printf("%.17g\n", s);
+  return 0;
+}
@@ -0,0 +1,51 @@
+#!/bin/bash
+
+set -e
+
+export VFC_BACKENDS_LOGGER_SILENT_LOAD=True
+
+# Sources are compiled to bitcode and instrumented when linking
+verificarlo-c -O2 --lto -c kernel.c -o kernel.o
+if [ "$(head -c 4 kernel.o | od -An -tx1 | tr -d ' ')" != "4243c0de" ]; then
+    echo "--lto -c did not produce a bitcode object"
+    exit 1
+fi
+verificarlo-c -O2 --lto main.c kernel.o -o test-lto
+verificarlo-c -O2 main.c kernel.c -o test-ref
+
+for backend in "libinterflop_ieee.so" \
+    "libinterflop_vprec.so --precision-binary64=30"; do
+    VFC_BACKENDS="$backend" ./test-ref >ref.log
+    VFC_BACKENDS="$backend" ./test-lto >lto.log
+    if ! diff ref.log lto.log; then
+        echo "results differ with --lto for $backend"
+        exit 1
+    fi
+done
+
+# The operations of the whole program are still perturbed
+for i in $(seq 1 5); do
+    VFC_BACKENDS="libinterflop_mca.so --mode=rr" ./test-lto
+done >mca.log
+if [ "$(sort -u mca.log | wc -l)" -eq 1 ]; then
+    echo "operations are not instrumented with --lto"
+    exit 1
+fi
+
+# Objects compiled without --lto are linked with the wrapper
+verificarlo-c -O2 -c main.c -o main-native.o
+verificarlo-c -O2 -c kernel.c -o kernel-native.o
+verificarlo-c -O2 --lto main-native.o kernel-native.o -o test-native
+VFC_BACKENDS="libinterflop_ieee.so" ./test-native >native.log
+VFC_BACKENDS="libinterflop_ieee.so" ./test-ref >ref.log
+diff ref.log native.log
+
+# The static backend is linked into the program as bitcode
+backend="libinterflop_vprec.so --precision-binary64=30"
+verificarlo-c -O2 --static-backend "$backend" main.c kernel.c -o test-static-ref
+verificarlo-c -O2 --lto --static-backend "$backend" main.c kernel.c -o test-static-lto
+./test-static-ref >ref.log
+./test-static-lto >lto.log
+diff ref.log lto.log
+
+echo "Test successed"
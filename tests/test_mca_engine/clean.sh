@@ -0,0 +1,3 @@
+#!/bin/bash
+
+rm -f test *.log *.o .vfcwrapper* *~
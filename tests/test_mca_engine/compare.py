@@ -0,0 +1,26 @@
+#!/usr/bin/env python3
+# Compare the mean and standard deviation of the errors computed by the quad
+# and double-double engines
+
+import math
+import sys
+
+if __name__ == "__main__":
+    quad_log, dd_log, samples = sys.argv[1], sys.argv[2], int(sys.argv[3])
+    quad = [l.split() for l in open(quad_log)]
+    dd = [l.split() for l in open(dd_log)]
+    status = 0
+    for (op, mean_q, sd_q), (_, mean_dd, sd_dd) in zip(quad, dd):
+        mean_q, sd_q, mean_dd, sd_dd = map(float, (mean_q, sd_q, mean_dd, sd_dd))
+        if any(math.isnan(x) for x in (mean_q, sd_q, mean_dd, sd_dd)):
+            print(f"op {op}: NaN error, quad ({mean_q}, {sd_q}), double-double ({mean_dd}, {sd_dd})")
+            status = 1
+            continue
+        # 5 standard errors of the difference of the means
+        tol = 5 * math.sqrt(2.0 / samples) * max(sd_q, sd_dd)
+        if abs(mean_q - mean_dd) > tol or abs(sd_q - sd_dd) > 0.05 * sd_q:
+            print(f"op {op}: quad ({mean_q}, {sd_q}) != double-double ({mean_dd}, {sd_dd})")
+            status = 1
+    if len(quad) != len(dd) or not quad:
+        status = 1
+    sys.exit(status)
@@ -0,0 +1,61 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Only kernel is instrumented */
+double kernel(int op, double a, double b) {
+  switch (op) {
+  case 0:
+    return a + b;
+  case 1:
+    return a - b;
+  case 2:
+    return a * b;
+  case 3:
+    return a / b;
+  default:
+    return fma(a, b, a);
+  }
+}
+
+double reference(int op, double a, double b) {
+  switch (op) {
+  case 0:
+    return a + b;
+  case 1:
+    return a - b;
+  case 2:
+    return a * b;
+  case 3:
+    return a / b;
+  default:
+    return fma(a, b, a);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 4) {
+    fprintf(stderr, "usage: %s a b samples\n", argv[0]);
+    return 1;
+  }
+  const double a = strtod(argv[1], NULL);
+  const double b = strtod(argv[2], NULL);
+  const int n = atoi(argv[3]);
+
+  /* mean and standard deviation of the error of each operation, in units of
+   * 2^exponent(ref) so that errors near the overflow threshold can be
+   * squared */
+  for (int op = 0; op < 5; op++) {
+    const double ref = reference(op, a, b);
+    const int scale = (ref == 0 || !isfinite(ref)) ? 0 : ilogb(ref);
+    double sum = 0, sum2 = 0;
+    for (int i = 0; i < n; i++) {
+      const double err = ldexp(kernel(op, a, b) - ref, -scale);
+      sum += err;
+      sum2 += err * err;
+    }
+    const double mean = sum / n;
+    printf("%d %.17e %.17e\n", op, mean, sqrt(sum2 / n - mean * mean));
+  }
+  return 0;
+}
@@ -0,0 +1,30 @@
+#!/bin/bash
+
+set -e
+
+export VFC_BACKENDS_LOGGER=False
+export VFC_BACKENDS_SILENT_LOAD=True
+
+SAMPLES=100000
+
+verificarlo-c -O0 --inst-fma --function=kernel test.c -o test -lm
+
+for mode in "--mode=rr" "--mode=rr --precision-binary64=30" \
+    "--mode=pb --precision-binary64=30" "--mode=mca --precision-binary64=40" \
+    "--mode=mca --error-mode=all --max-abs-error-exponent=-40"; do
+    # the last operands are close to the largest exponent handled by the
+    # double-double engine
+    for operands in "0.1 0.3" "1.5e100 -3.7e-50" "-2.5 2.5000000001" \
+        "0x1.8p999 0x1.8p-10" "0x1.fffffffffffffp994 0x1.8p-10"; do
+        VFC_BACKENDS="libinterflop_mca.so $mode --engine=quad" \
+            ./test $operands $SAMPLES >quad.log
+        VFC_BACKENDS="libinterflop_mca.so $mode --engine=double-double" \
+            ./test $operands $SAMPLES >dd.log
+        if ! ./compare.py quad.log dd.log $SAMPLES; then
+            echo "engines differ for $mode on $operands"
+            exit 1
+        fi
+    done
+done
+
+echo "Test successed"
@@ -0,0 +1,225 @@
+#define _GNU_SOURCE
+#include <argp.h>
+#include <dlfcn.h>
+#include <err.h>
+#include <errno.h>
+#include <printf.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <interflop/interflop.h>
+
+/* Runs operations on pseudo-random operands with the backend given on the
+ * command line, and prints the bits of the results. The operations are the
+ * ones of the interface returned by interflop_init, specialized for the
+ * configuration of the backend, or the generic interflop_<name>_ functions
+ * that read the configuration from the context. No floating-point operation
+ * is done here, so that only the backend computes.
+ *
+ * usage: test specialized|generic <name> <library> [backend options] */
+
+#define NB_OPERANDS 2000
+
+typedef void (*binary32_op_t)(float, float, float *, void *);
+typedef void (*binary64_op_t)(double, double, double *, void *);
+typedef void (*pre_init_t)(interflop_panic_t, FILE *, void **);
+typedef void (*cli_t)(int, char **, void *);
+typedef struct interflop_backend_interface_t (*init_t)(void *);
+
+static void *handle = NULL;
+
+static void *load(const char *name) {
+  void *f = dlsym(handle, name);
+  if (f == NULL) {
+    fprintf(stderr, "cannot load %s: %s\n", name, dlerror());
+    exit(EXIT_FAILURE);
+  }
+  return f;
+}
+
+/* Returns the generic function <op> of the backend <name> */
+static void *load_generic(const char *name, const char *op) {
+  char symbol[256];
+  snprintf(symbol, sizeof(symbol), "interflop_%s_%s", name, op);
+  return load(symbol);
+}
+
+static long _strtol(const char *nptr, char **endptr, int *error) {
+  errno = 0;
+  long val = strtol(nptr, endptr, 10);
+  *error = errno != 0;
+  return val;
+}
+
+static double _strtod(const char *nptr, char **endptr, int *error) {
+  errno = 0;
+  double val = strtod(nptr, endptr);
+  *error = errno != 0;
+  return val;
+}
+
+static pid_t _gettid(void) { return syscall(__NR_gettid); }
+
+static void panic(const char *msg) {
+  fprintf(stderr, "%s", msg);
+  exit(EXIT_FAILURE);
+}
+
+static void set_handlers(void) {
+  interflop_set_handler_t set_handler =
+      (interflop_set_handler_t)load("interflop_set_handler");
+  set_handler("getenv", getenv);
+  set_handler("sprintf", sprintf);
+  set_handler("strerror", strerror);
+  set_handler("gettid", _gettid);
+  set_handler("strcasecmp", strcasecmp);
+  set_handler("fprintf", fprintf);
+  set_handler("vfprintf", vfprintf);
+  set_handler("vsnprintf", vsnprintf);
+  set_handler("fwrite", fwrite);
+  set_handler("exit", exit);
+  set_handler("malloc", malloc);
+  set_handler("calloc", calloc);
+  set_handler("free", free);
+  set_handler("strcmp", strcmp);
+  set_handler("strtol", _strtol);
+  set_handler("strtod", _strtod);
+  set_handler("strcpy", strcpy);
+  set_handler("strncpy", strncpy);
+  set_handler("fopen", fopen);
+  set_handler("fclose", fclose);
+  set_handler("fgets", fgets);
+  set_handler("vwarnx", vwarnx);
+  set_handler("strtok_r", strtok_r);
+  set_handler("argp_parse", argp_parse);
+  set_handler("gettimeofday", gettimeofday);
+  set_handler("register_printf_specifier", register_printf_specifier);
+  set_handler("pthread_create", pthread_create);
+  set_handler("pthread_join", pthread_join);
+  set_handler("nanosleep", nanosleep);
+  set_handler("dladdr", dladdr);
+}
+
+/* xorshift64, the operands do not depend on the backend */
+static uint64_t state = 0x9e3779b97f4a7c15ULL;
+
+static uint64_t next(void) {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+/* Random sign, significand and exponent within [bias - range, bias + range],
+ * which includes subnormals and overflows for the largest ranges */
+static float random_binary32(int range) {
+  const uint64_t r = next();
+  const uint32_t exponent = 127 - range + (r >> 32) % (2 * range + 1);
+  const uint32_t bits = (uint32_t)(r >> 63) << 31 | (exponent & 0xff) << 23 |
+                        (uint32_t)(r & 0x7fffff);
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+static double random_binary64(int range) {
+  const uint64_t r = next();
+  const uint64_t exponent = 1023 - range + next() % (2 * range + 1);
+  const uint64_t bits =
+      (r >> 63) << 63 | (exponent & 0x7ff) << 52 | (r & 0xfffffffffffffULL);
+  double d;
+  memcpy(&d, &bits, sizeof(d));
+  return d;
+}
+
+static void print_binary32(float f) {
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  printf("%08x\n", bits);
+}
+
+static void print_binary64(double d) {
+  uint64_t bits;
+  memcpy(&bits, &d, sizeof(bits));
+  printf("%016lx\n", bits);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 4) {
+    fprintf(stderr, "usage: %s specialized|generic <name> <library> ...\n",
+            argv[0]);
+    return EXIT_FAILURE;
+  }
+  const int specialized = strcmp(argv[1], "specialized") == 0;
+  const char *name = argv[2];
+  handle = dlopen(argv[3], RTLD_NOW);
+  if (handle == NULL) {
+    fprintf(stderr, "cannot open %s: %s\n", argv[3], dlerror());
+    return EXIT_FAILURE;
+  }
+  set_handlers();
+
+  void *context = NULL;
+  ((pre_init_t)load("interflop_pre_init"))(panic, stderr, &context);
+  /* argv[3] is the library, as argv[0] in the backend arguments */
+  ((cli_t)load("interflop_cli"))(argc - 3, argv + 3, context);
+  struct interflop_backend_interface_t interface =
+      ((init_t)load("interflop_init"))(context);
+
+  if (!specialized) {
+    interface.interflop_add_float = load_generic(name, "add_float");
+    interface.interflop_sub_float = load_generic(name, "sub_float");
+    interface.interflop_mul_float = load_generic(name, "mul_float");
+    interface.interflop_div_float = load_generic(name, "div_float");
+    interface.interflop_fma_float = load_generic(name, "fma_float");
+    interface.interflop_add_double = load_generic(name, "add_double");
+    interface.interflop_sub_double = load_generic(name, "sub_double");
+    interface.interflop_mul_double = load_generic(name, "mul_double");
+    interface.interflop_div_double = load_generic(name, "div_double");
+    interface.interflop_fma_double = load_generic(name, "fma_double");
+    interface.interflop_cast_double_to_float =
+        load_generic(name, "cast_double_to_float");
+  }
+
+  const binary32_op_t binary32_ops[] = {
+      interface.interflop_add_float, interface.interflop_sub_float,
+      interface.interflop_mul_float, interface.interflop_div_float};
+  const binary64_op_t binary64_ops[] = {
+      interface.interflop_add_double, interface.interflop_sub_double,
+      interface.interflop_mul_double, interface.interflop_div_double};
+
+  /* operands of 1 to 2^7 binades around 1, so that results cover normal,
+   * subnormal, zero and overflowing values */
+  for (int i = 0; i < NB_OPERANDS; i++) {
+    const int range = 1 << (i % 8);
+    const float a32 = random_binary32(range), b32 = random_binary32(range),
+                c32 = random_binary32(range);
+    const double a64 = random_binary64(range * 8),
+                 b64 = random_binary64(range * 8),
+                 c64 = random_binary64(range * 8);
+    float r32;
+    double r64;
+    for (int op = 0; op < 4; op++) {
+      binary32_ops[op](a32, b32, &r32, context);
+      print_binary32(r32);
+      binary64_ops[op](a64, b64, &r64, context);
+      print_binary64(r64);
+    }
+    interface.interflop_fma_float(a32, b32, c32, &r32, context);
+    print_binary32(r32);
+    interface.interflop_fma_double(a64, b64, c64, &r64, context);
+    print_binary64(r64);
+    interface.interflop_cast_double_to_float(random_binary64(range * 16), &r32,
+                                             context);
+    print_binary32(r32);
+  }
+
+  return EXIT_SUCCESS;
+}
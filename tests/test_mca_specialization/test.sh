@@ -0,0 +1,48 @@
+#!/bin/bash
+
+# Check that the operations specialized for the configuration of mcaquad and
+# mcaint give the same bits as the generic operations, with the same seed
+
+set -e
+
+source "$(dirname "$0")/../paths.sh"
+
+export VFC_BACKENDS="libinterflop_ieee.so"
+export VFC_BACKENDS_LOGGER=False
+export VFC_BACKENDS_SILENT_LOAD=True
+
+verificarlo-c -O2 test.c -o test -ldl
+
+check() {
+    local name=$1
+    local library="${INTERFLOP_LIBDIR}/$2"
+    shift 2
+    ./test specialized $name $library --seed=42 "$@" >specialized.log
+    ./test generic $name $library --seed=42 "$@" >generic.log
+    if ! cmp -s specialized.log generic.log; then
+        echo "specialized and generic $name differ with: $*"
+        exit 1
+    fi
+}
+
+for daz_ftz in "" "--daz" "--ftz" "--daz --ftz"; do
+    check mcaquad libinterflop_mca.so --mode=ieee $daz_ftz
+    check mcaint libinterflop_mca_int.so --mode=ieee $daz_ftz
+    for mode in mca pb rr; do
+        for sparsity in "" "--sparsity=0.5"; do
+            options="--mode=$mode $sparsity $daz_ftz"
+            # mcaint has fixed precisions and no error mode
+            check mcaint libinterflop_mca_int.so $options
+            for precision in "" "--precision-binary32=10 --precision-binary64=30"; do
+                for error_mode in rel abs all; do
+                    check mcaquad libinterflop_mca.so $options $precision \
+                        --error-mode=$error_mode --max-abs-error-exponent=-20
+                done
+                check mcaquad libinterflop_mca.so $options $precision \
+                    --engine=double-double
+            done
+        done
+    done
+done
+
+echo "Test successed"
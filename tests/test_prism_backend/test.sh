@@ -35,6 +35,7 @@ function run() {
 
 DYNAMIC=0
 STATIC=1
+MULTIVERSION=2
 
 BASELINE=0
 NATIVE=1
@@ -49,6 +50,8 @@ for mode in up-down sr; do
     run $mode "Test scalar static dispatch" test_scalar.sh $STATIC $BASELINE $XFAIL
     run $mode "Test scalar dynamic dispatch -march=native" test_scalar.sh $DYNAMIC $NATIVE
     run $mode "Test scalar static dispatch -march=native" test_scalar.sh $STATIC $NATIVE
+    run $mode "Test scalar multiversion dispatch" test_scalar.sh $MULTIVERSION $BASELINE
+    run $mode "Test multiversion dispatch selects the static operators" test_multiversion.sh
 
     # VECTOR TESTS
     run $mode "Test vector dynamic dispatch" test_vector.sh $DYNAMIC $BASELINE
@@ -56,7 +59,13 @@ for mode in up-down sr; do
     run $mode "Test vector static dispatch" test_vector.sh $STATIC $BASELINE $XFAIL
     run $mode "Test vector dynamic dispatch -march=native" test_vector.sh $DYNAMIC $NATIVE
     run $mode "Test vector static dispatch -march=native" test_vector.sh $STATIC $NATIVE
+    run $mode "Test vector multiversion dispatch" test_vector.sh $MULTIVERSION $BASELINE
+
+    # CAST AND COMPARISON TESTS
+    run $mode "Test cast and comparison" test_cast_fcmp.sh
 
 done
 
+run sr "Test virtual precision" test_virtual_precision.sh
+
 exit 0
@@ -0,0 +1,23 @@
+#include <cstdio>
+#include <cstdlib>
+
+__attribute__((noinline)) auto cast(double a) -> float {
+  return static_cast<float>(a);
+}
+
+__attribute__((noinline)) auto less(double a, double b) -> bool {
+  return a < b;
+}
+
+auto main(int argc, const char *argv[]) -> int {
+  if (argc != 3) {
+    fprintf(stderr, "usage: ./test_cast_fcmp a b\n");
+    return EXIT_FAILURE;
+  }
+
+  const double a = strtod(argv[1], nullptr);
+  const double b = strtod(argv[2], nullptr);
+  printf("%.6a %d\n", cast(a), less(a, b));
+
+  return EXIT_SUCCESS;
+}
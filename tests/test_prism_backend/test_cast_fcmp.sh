@@ -0,0 +1,53 @@
+#!/bin/bash
+
+set -e
+
+# Check that --inst-cast and --inst-fcmp instrument double to float casts and
+# comparisons with the PRISM backend
+
+SAMPLES=100
+
+if [[ "$PRISM_BACKEND" != "up-down" && "$PRISM_BACKEND" != "sr" ]]; then
+    echo "Error: PRISM_BACKEND must be set to 'up-down' or 'sr'"
+    exit 1
+fi
+
+mkdir -p .objects .bin .results
+
+export VFC_BACKENDS_LOGGER=False
+
+verificarlo-c++ -O2 --prism-backend=${PRISM_BACKEND} --inst-cast --inst-fcmp \
+    -c test_cast_fcmp.cpp -o .objects/test_cast_fcmp.o
+verificarlo-c++ .objects/test_cast_fcmp.o -o .bin/test_cast_fcmp \
+    --prism-backend=${PRISM_BACKEND} -lm
+
+# 1 and its successor compare randomly, 0.1 is not a binary32 value
+for i in $(seq 1 $SAMPLES); do
+    .bin/test_cast_fcmp 0.1 0x1.0000000000001p+0 >>.results/cast_fcmp.txt
+done
+
+if [[ $(cut -d' ' -f1 .results/cast_fcmp.txt | sort -u | wc -l) != 2 ]]; then
+    echo "Cast of 0.1 is not rounded randomly"
+    exit 1
+fi
+
+# The comparison 0.1 < 1 is stable
+if [[ $(cut -d' ' -f2 .results/cast_fcmp.txt | sort -u) != 1 ]]; then
+    echo "Comparison 0.1 < 1+ulp is not stable"
+    exit 1
+fi
+
+rm -f .results/cast_fcmp.txt
+for i in $(seq 1 $SAMPLES); do
+    .bin/test_cast_fcmp 1 0x1.0000000000001p+0 >>.results/cast_fcmp.txt
+done
+
+if [[ $(cut -d' ' -f1 .results/cast_fcmp.txt | sort -u | wc -l) != 1 ]]; then
+    echo "Exact cast of 1 is not exact"
+    exit 1
+fi
+
+if [[ $(cut -d' ' -f2 .results/cast_fcmp.txt | sort -u | wc -l) != 2 ]]; then
+    echo "Comparison 1 < 1+ulp is not random"
+    exit 1
+fi
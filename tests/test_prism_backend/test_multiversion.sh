@@ -0,0 +1,65 @@
+#!/bin/bash
+
+set -e
+
+# Check that the multiversion dispatch selects the static operators. The
+# static library is compiled with -march=native, so the CPU running the test
+# has all its target features.
+
+if [[ "$(uname -m)" != "x86_64" ]]; then
+    echo "the multiversion dispatch is only available on x86_64"
+    exit 0
+fi
+
+if [[ "$PRISM_BACKEND" != "up-down" && "$PRISM_BACKEND" != "sr" ]]; then
+    echo "Error: PRISM_BACKEND must be set to 'up-down' or 'sr'"
+    exit 1
+fi
+
+OPTIONS="--prism-backend=${PRISM_BACKEND} --prism-backend-dispatch=multiversion"
+
+mkdir -p .objects .bin
+
+export VFC_BACKENDS_LOGGER=False
+
+verificarlo-c++ -O2 ${OPTIONS} -c test_scalar.cpp \
+    -o .objects/test_multiversion.o
+
+# tables of the operators, named after the dynamic operators
+tables=$(nm .objects/test_multiversion.o |
+    awk '$3 ~ /^vfc_prism_mv_table_/ { print $3 }')
+if [[ -z $tables ]]; then
+    echo "No multiversion table: the static operators are never selected"
+    exit 1
+fi
+
+# constructor run after the one setting the tables, checks that no table
+# points to its dynamic operator
+{
+    echo "#include <stdio.h>"
+    echo "#include <stdlib.h>"
+    i=0
+    for table in $tables; do
+        echo "extern void *table_$i __asm__(\"$table\");"
+        echo "extern char dynamic_$i __asm__(\"${table#vfc_prism_mv_table_}\");"
+        i=$((i + 1))
+    done
+    echo "__attribute__((constructor)) static void check(void) {"
+    i=0
+    for table in $tables; do
+        echo "  if (table_$i == (void *)&dynamic_$i) {"
+        echo "    fprintf(stderr, \"$table: dynamic operator selected\\n\");"
+        echo "    exit(EXIT_FAILURE);"
+        echo "  }"
+        i=$((i + 1))
+    done
+    echo "}"
+} >.objects/check_multiversion.c
+
+verificarlo-c -O2 ${OPTIONS} -c .objects/check_multiversion.c \
+    -o .objects/check_multiversion.o
+verificarlo-c++ .objects/test_multiversion.o .objects/check_multiversion.o \
+    -o .bin/test_multiversion ${OPTIONS} -lm
+
+.bin/test_multiversion double + 0.1 0.01
+.bin/test_multiversion float x 0.1 0.01
@@ -9,6 +9,8 @@ export SAMPLES=100
 
 if [[ $STATIC_DISPATCH -eq 1 ]]; then
     DISPATCH="static=1"
+elif [[ $STATIC_DISPATCH -eq 2 ]]; then
+    DISPATCH="multiversion=1"
 else
     DISPATCH=
 fi
@@ -128,7 +130,7 @@ export -f run_test
 parallel --bar --halt now,fail=1 --header : \
     "run_test {type} {optimization} {op}" \
     ::: type float double \
-    ::: op "+" "-" "x" "/" \
+    ::: op "+" "-" "x" "/" "s" \
     ::: optimization "${optimizations[@]}"
 
 if [[ $? != 0 ]]; then
@@ -134,11 +134,16 @@ auto fma(const V a, const V b, const V c) -> V {
 
 template <typename T, int size, typename V = typename vectortype<T, size>::type>
 auto sqrt(const V a) -> V {
+#if __has_builtin(__builtin_elementwise_sqrt)
+  /* llvm.sqrt on the whole vector */
+  return __builtin_elementwise_sqrt(a);
+#else
   V res = {0};
   for (int i = 0; i < size; i++) {
     res[i] = sqrt(a[i]);
   }
   return res;
+#endif
 }
 
 template <typename T, int size, typename V = typename vectortype<T, size>::type,
@@ -9,6 +9,8 @@ export SAMPLES=100
 
 if [[ $STATIC_DISPATCH -eq 1 ]]; then
     DISPATCH="static=1"
+elif [[ $STATIC_DISPATCH -eq 2 ]]; then
+    DISPATCH="multiversion=1"
 else
     DISPATCH=
 fi
@@ -62,7 +64,7 @@ parallel --halt now,fail=1 --header : \
     ::: size 2 4 8 16
 
 run_test() {
-    declare -A operation_name=(["+"]="add" ["-"]="sub" ["x"]="mul" ["/"]="div")
+    declare -A operation_name=(["+"]="add" ["-"]="sub" ["x"]="mul" ["/"]="div" ["s"]="sqrt")
 
     declare -A args
     args["float+"]="0.1 0.01"
@@ -137,13 +139,13 @@ if [[ ${TEST_DEBUG} -eq 1 ]]; then
     echo "Running in debug mode"
     parallel --header : "run_test {type} {optimization} {op} {size}" \
         ::: type double float \
-        ::: op "+" "-" "x" "/" \
+        ::: op "+" "-" "x" "/" "s" \
         ::: optimization "${optimizations[@]}" \
         ::: size 2 4 8 16
 else
     parallel --bar --halt now,fail=1 --header : "run_test {type} {optimization} {op} {size}" \
         ::: type double float \
-        ::: op "+" "-" "x" "/" \
+        ::: op "+" "-" "x" "/" "s" \
         ::: optimization "${optimizations[@]}" \
         ::: size 2 4 8 16
 fi
@@ -0,0 +1,46 @@
+#!/bin/bash
+
+set -e
+
+# Check that results are rounded to the virtual precision and range
+
+SAMPLES=100
+
+mkdir -p .objects .bin .results
+
+export VFC_BACKENDS_LOGGER=False
+
+verificarlo-c++ -O2 --prism-backend=sr \
+    --prism-backend-precision-binary32=11 --prism-backend-range-binary32=5 \
+    --prism-backend-precision-binary64=12 \
+    -c test_scalar.cpp -o .objects/test_virtual_precision.o
+verificarlo-c++ .objects/test_virtual_precision.o \
+    -o .bin/test_virtual_precision --prism-backend=sr -lm
+
+for i in $(seq 1 $SAMPLES); do
+    .bin/test_virtual_precision float + 0.1 0.01 >>.results/vp.float.txt
+    .bin/test_virtual_precision double + 0.1 0.01 >>.results/vp.double.txt
+done
+.bin/test_virtual_precision float x 1000 1000 >.results/vp.overflow.txt
+
+python3 - <<'PY'
+import sys
+
+def check(filename, precision, reference):
+    values = [float.fromhex(l) for l in open(filename)]
+    if len(set(values)) == 1:
+        sys.exit(f"{filename}: no variability")
+    for v in values:
+        significand = v.hex().split("p")[0].split(".")[1]
+        bits = format(int(significand, 16), f"0{len(significand) * 4}b")
+        if "1" in bits[precision - 1 :]:
+            sys.exit(f"{filename}: {v.hex()} has more than {precision} bits")
+    mean = sum(values) / len(values)
+    if abs(mean - reference) > 2**-precision * 0.11 * 4:
+        sys.exit(f"{filename}: mean {mean} is far from {reference}")
+
+check(".results/vp.float.txt", 11, 0.11)
+check(".results/vp.double.txt", 12, 0.11)
+if float.fromhex(open(".results/vp.overflow.txt").read()) != float("inf"):
+    sys.exit("1e6 does not overflow with 5 bits of exponent")
+PY
@@ -0,0 +1,3 @@
+#!/bin/bash
+
+rm -f *.o *.log test-all test-skip .vfcwrapper* *~
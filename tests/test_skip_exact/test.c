@@ -0,0 +1,32 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Exact at any precision */
+__attribute__((noinline)) double zero(double x) {
+  double a = x - x;
+  return a * 0.0;
+}
+
+/* Exact in binary64 */
+__attribute__((noinline)) double scale(double x) { return x * 4.0; }
+
+/* Exact in binary64 for 16-bit integers */
+__attribute__((noinline)) double native(short i, short j) {
+  return (double)i * (double)j + (double)i;
+}
+
+/* Never exact */
+__attribute__((noinline)) double inexact(double x, double y) {
+  return x / y;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s x\n", argv[0]);
+    return 1;
+  }
+  double x = strtod(argv[1], NULL);
+  printf("%la %la %la %la\n", zero(x), scale(x), native(123 * argc, -456),
+         inexact(x, 3.0));
+  return 0;
+}
@@ -0,0 +1,51 @@
+#!/bin/bash
+
+set -e
+
+export VFC_BACKENDS_LOGGER_SILENT_LOAD=True
+
+count_skipped() {
+    verificarlo-c -O0 --verbose $1 -c test.c -o test.o 2>&1 |
+        grep -c "^Skipping exact" || true
+}
+
+none=$(count_skipped "")
+zero=$(count_skipped "--skip-exact-ops=zero")
+native=$(count_skipped "--skip-exact-ops=native")
+echo "skipped operations: none=$none zero=$zero native=$native"
+
+if [ "$none" -ne 0 ]; then
+    echo "exact operations skipped without --skip-exact-ops"
+    exit 1
+fi
+
+if [ "$zero" -eq 0 ] || [ "$native" -le "$zero" ]; then
+    echo "exact operations not skipped"
+    exit 1
+fi
+
+# Skipped operations must not change the results of the program
+verificarlo-c -O2 test.c -o test-all
+verificarlo-c -O2 --skip-exact-ops=native test.c -o test-skip
+VFC_BACKENDS="libinterflop_ieee.so" ./test-all 0.1 >all.log
+VFC_BACKENDS="libinterflop_ieee.so" ./test-skip 0.1 >skip.log
+if ! diff all.log skip.log; then
+    echo "results differ with --skip-exact-ops"
+    exit 1
+fi
+
+# The inexact division is still instrumented
+VFC_BACKENDS="libinterflop_mca.so --mode=rr" ./test-skip 0.1 >mca.log
+for i in $(seq 1 10); do
+    VFC_BACKENDS="libinterflop_mca.so --mode=rr" ./test-skip 0.1 >>mca.log
+done
+if [ "$(cut -d' ' -f4 mca.log | sort -u | wc -l)" -eq 1 ]; then
+    echo "inexact operation not instrumented"
+    exit 1
+fi
+if [ "$(cut -d' ' -f1-3 mca.log | sort -u | wc -l)" -ne 1 ]; then
+    echo "skipped exact operations are perturbed"
+    exit 1
+fi
+
+echo "Test successed"
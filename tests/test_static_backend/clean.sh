@@ -0,0 +1,3 @@
+#!/bin/bash
+
+rm -rf *.o *.log *.err test-dynamic test-static .vfcwrapper* .vfcprogram* *~
@@ -0,0 +1,12 @@
+#include <stdio.h>
+
+int main(void) {
+  double s = 0;
+  float f = 0;
+  for (int i = 1; i < 100; i++) {
+    s += 1.0 / i;
+    f += 1.0f / i;
+  }
+  printf("%.17g %.9g\n", s, f);
+  return 0;
+}
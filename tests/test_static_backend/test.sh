@@ -0,0 +1,50 @@
+#!/bin/bash
+
+set -e
+
+# --static-backend links one backend into the program, configured at compile
+# time: the program runs it without VFC_BACKENDS
+unset VFC_BACKENDS VFC_BACKENDS_FROM_FILE
+
+verificarlo-c -O2 test.c -o test-dynamic
+VFC_BACKENDS="libinterflop_ieee.so" ./test-dynamic >ieee.log
+
+for backend in "libinterflop_vprec.so --precision-binary64=20 --precision-binary32=10" \
+    "libinterflop_mca.so --mode=rr --precision-binary64=30 --seed=42" \
+    "libinterflop_mca_int.so --mode=rr --precision-binary64=30 --seed=42" \
+    "libinterflop_bitmask.so --operator=rand --precision-binary64=30 --seed=42"; do
+    echo "Running $backend"
+    verificarlo-c -O2 --static-backend "$backend" test.c -o test-static
+    ./test-static >static.log 2>static.err
+
+    if ! grep -q "loaded static backend" static.err; then
+        echo "static backend not loaded for $backend"
+        exit 1
+    fi
+
+    # the backend perturbs the operations ...
+    if diff -q ieee.log static.log >/dev/null; then
+        echo "operations are not perturbed by the static $backend"
+        exit 1
+    fi
+
+    # ... as the same backend loaded at run time
+    VFC_BACKENDS="$backend" ./test-dynamic >dynamic.log
+    if ! diff dynamic.log static.log; then
+        echo "results differ between the static and dynamic $backend"
+        exit 1
+    fi
+
+    # VFC_BACKENDS is ignored
+    VFC_BACKENDS="libinterflop_ieee.so" ./test-static >ignored.log 2>ignored.err
+    if ! diff static.log ignored.log; then
+        echo "VFC_BACKENDS is not ignored with the static $backend"
+        exit 1
+    fi
+    if ! grep -q "VFC_BACKENDS and VFC_BACKENDS_FROM_FILE are ignored" ignored.err; then
+        echo "no warning about the ignored VFC_BACKENDS for $backend"
+        exit 1
+    fi
+done
+
+echo "Test successed"
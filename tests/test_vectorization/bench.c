@@ -0,0 +1,88 @@
+/* Throughput of instrumented vector kernels, see bench.sh */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "type.h"
+
+#define N 4096
+
+float2 mul_2x_float(float2 a, float x);
+double2 mul_2x_double(double2 a, double x);
+#if defined(__x86_64__)
+float8 mul_8x_float(float8 a, float x);
+double8 mul_8x_double(double8 a, double x);
+#endif
+
+static double now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void report(const char *kernel, double start, long ops) {
+  printf("%-16s %8.2f ns/op\n", kernel, (now() - start) * 1e9 / ops);
+}
+
+/* Loops vectorized by the compiler */
+#define define_loop_kernel(type, operation, operator)                          \
+  __attribute__((noinline)) void loop_##operation##_##type(                    \
+      const type *restrict a, const type *restrict b, type *restrict c) {      \
+    for (int i = 0; i < N; i++) {                                              \
+      c[i] = a[i] operator b[i];                                               \
+    }                                                                          \
+  }
+
+define_loop_kernel(float, add, +);
+define_loop_kernel(float, mul, *);
+define_loop_kernel(float, div, /);
+define_loop_kernel(double, add, +);
+define_loop_kernel(double, mul, *);
+define_loop_kernel(double, div, /);
+
+#define bench_loop_kernel(type, operation)                                     \
+  {                                                                            \
+    static type a[N], b[N], c[N];                                              \
+    for (int i = 0; i < N; i++) {                                              \
+      a[i] = 1 + i;                                                            \
+      b[i] = 1.0 / (i + 1);                                                    \
+    }                                                                          \
+    double start = now();                                                      \
+    for (long r = 0; r < repeat; r++) {                                        \
+      loop_##operation##_##type(a, b, c);                                      \
+    }                                                                          \
+    report("loop_" #operation "_" #type, start, repeat * N);                   \
+  }
+
+/* Vector kernels of operation.c */
+#define bench_vector_kernel(type, operation, size)                             \
+  {                                                                            \
+    type##size x;                                                              \
+    for (int i = 0; i < size; i++) {                                           \
+      x[i] = 1 + i;                                                            \
+    }                                                                          \
+    double start = now();                                                      \
+    for (long r = 0; r < repeat * N / size; r++) {                             \
+      x = operation##_##size##x##_##type(x, (type)1.0);                        \
+    }                                                                          \
+    report(#operation "_" #size "x_" #type, start, repeat * N);                \
+  }
+
+int main(int argc, char *argv[]) {
+  long repeat = (argc > 1) ? atol(argv[1]) : 100;
+
+  bench_loop_kernel(float, add);
+  bench_loop_kernel(float, mul);
+  bench_loop_kernel(float, div);
+  bench_loop_kernel(double, add);
+  bench_loop_kernel(double, mul);
+  bench_loop_kernel(double, div);
+
+  bench_vector_kernel(float, mul, 2);
+  bench_vector_kernel(double, mul, 2);
+#if defined(__x86_64__)
+  bench_vector_kernel(float, mul, 8);
+  bench_vector_kernel(double, mul, 8);
+#endif
+  return 0;
+}
@@ -0,0 +1,32 @@
+#!/bin/bash
+# Compare the throughput of the kernels instrumented at each extension point
+# of the clang optimization pipeline (verificarlo --extension-point).
+#
+# usage: ./bench.sh [repeat] [backend]
+
+source ../paths.sh
+
+repeat=${1:-100}
+export VFC_BACKENDS=${2:-"libinterflop_ieee.so"}
+export VFC_BACKENDS_SILENT_LOAD="True"
+export VFC_BACKENDS_LOGGER="False"
+
+cflags="-O3 ${MARCH_FLAG} -I."
+
+set -e
+
+${LLVM_BINDIR}/clang ${cflags} bench.c operation.c -o bench-native
+for ep in pipeline-start optimizer-early optimizer-last; do
+    verificarlo-c ${cflags} --extension-point=${ep} bench.c operation.c -o bench-${ep}
+done
+
+for bench in native pipeline-start optimizer-early optimizer-last; do
+    ./bench-${bench} ${repeat} >bench-${bench}.log
+done
+
+echo "VFC_BACKENDS=${VFC_BACKENDS}"
+printf "%-16s %14s %16s %16s %16s\n" kernel native pipeline-start \
+    optimizer-early optimizer-last
+paste bench-native.log bench-pipeline-start.log bench-optimizer-early.log \
+    bench-optimizer-last.log |
+    awk '{printf "%-16s %8s ns/op %10s ns/op %10s ns/op %10s ns/op\n", $1, $2, $5, $8, $11}'
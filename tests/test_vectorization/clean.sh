@@ -1,3 +1,3 @@
 #!/bin/bash
 
-rm -f *.o *.ll* *.log test-* diff .vfcwrapper* *~ test.log
+rm -f *.o *.ll* *.log test-* bench-* diff .vfcwrapper* *~ test.log
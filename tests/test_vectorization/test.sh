@@ -27,6 +27,33 @@ export VFC_BACKENDS="libinterflop_ieee.so"
 ./test-2 2>clang.log
 ./test-3 2>mca.log
 
+# The bitmask backend instruments vector operations with its vector entry
+# points. With a deterministic operator, vectorized code must give the same
+# results as the scalar code compiled without optimizations.
+verificarlo-c -Wall -Wextra -O0 -I. -g print.c operation.c test.c -o test-scalar
+if [[ $? != 0 ]]; then
+    echo "Test failed"
+    exit 1
+fi
+
+VFC_BACKENDS="libinterflop_bitmask.so --operator=one --mode=full --precision-binary32=10 --precision-binary64=20" ./test-3 2>bitmask-vector.log
+VFC_BACKENDS="libinterflop_bitmask.so --operator=one --mode=full --precision-binary32=10 --precision-binary64=20" ./test-scalar 2>bitmask-scalar.log
+
+if ! diff bitmask-vector.log bitmask-scalar.log; then
+    echo "Test failed: bitmask vector and scalar results differ"
+    exit 1
+fi
+
+# Instrumenting before the vectorizers gives the same results
+for ep in pipeline-start optimizer-early; do
+    verificarlo-c ${cflags} --extension-point=${ep} print.c operation.c test.c -o test-${ep}
+    ./test-${ep} 2>${ep}.log
+    if ! diff gcc.log ${ep}.log; then
+        echo "Test failed: results differ with --extension-point=${ep}"
+        exit 1
+    fi
+done
+
 diff3 gcc.log clang.log mca.log >diff
 if [[ -z $diff ]]; then
     echo "Test successed"
@@ -0,0 +1,18 @@
+#include <stdio.h>
+
+/* the sum loses bits at reduced precision, the product by two is exact */
+__attribute__((noinline)) double sum(int n) {
+  double s = 0;
+  for (int i = 1; i <= n; i++) {
+    s += 1.0 / i;
+  }
+  return s;
+}
+
+__attribute__((noinline)) double twice(double x) { return x * 2; }
+
+int main(void) {
+  double s = sum(100);
+  printf("%.17g %.17g\n", s, twice(0.75));
+  return 0;
+}
@@ -0,0 +1,42 @@
+#!/bin/bash
+set -e
+
+export VFC_BACKENDS_LOGGER="False"
+
+verificarlo-c -O0 -g test.c -o test
+
+VFC_BACKENDS="libinterflop_vprec.so --precision-binary64=10 --shadow=binary128 --shadow-output-file=shadow.txt" ./test
+cat shadow.txt
+
+# one call site per operation: add and div in sum, mul in twice
+if [[ $(grep -v "^#" shadow.txt | wc -l) != 3 ]]; then
+    echo "expected 3 call sites in the shadow report"
+    exit 1
+fi
+
+# the exact product must be ranked last with no deviation
+if ! tail -n 1 shadow.txt | awk -F'\t' '$6 != "mul" || $8 != 0 { exit 1 }'; then
+    echo "the exact product should be ranked last with no deviation"
+    exit 1
+fi
+
+# the first call site must show a deviation
+if ! grep -v "^#" shadow.txt | head -n 1 | awk -F'\t' '$8 <= 0 { exit 1 }'; then
+    echo "the first call site should show a deviation"
+    exit 1
+fi
+
+# the object and offset of a call site are symbolized by addr2line
+SITE=$(grep -v "^#" shadow.txt | head -n 1 | cut -f 3,4 | tr '\t' ' ')
+if ! addr2line -e $SITE | grep -q "test.c:"; then
+    echo "the call site is not symbolized by addr2line"
+    exit 1
+fi
+
+# without shadow mode no report is written
+rm -f shadow.txt
+VFC_BACKENDS="libinterflop_vprec.so --precision-binary64=10 --shadow-output-file=shadow.txt" ./test
+if [[ -f shadow.txt ]]; then
+    echo "shadow report written while shadow mode is disabled"
+    exit 1
+fi